@@ -1,2 +1,2 @@
 
-python3 ./scripts/execute.py --timeout 150 --testcase-dir '/home/user/final_performance' --opt-level 1 --no-compile --no-flatten --native --performance --csv-file '/home/share/result.csv'
\ No newline at end of file
+python3 ./scripts/execute.py --timeout 150 --testcase-dir '/home/user/final_performance' --opt-level 3 --no-compile --no-flatten --native --performance --csv-file '/home/share/result.csv'
\ No newline at end of file
@@ -0,0 +1,220 @@
+#!/usr/bin/env python3
+"""Measure the compile time and the peak memory of syc on generated programs.
+
+Every shape of `gen_sysy.py` is generated at each scale and compiled to
+assembly with `-stats-json`. The wall time and the peak RSS of the compiler
+are measured from outside, and the per-pass times from the statistics are
+added up into the frontend, IR and assembly phases. One CSV row is written for
+each shape and scale.
+
+Between consecutive scales of a shape the growth exponent of the wall time
+against the size of the program is computed, i.e. `log(t2 / t1) / log(n2 /
+n1)` where the size is the IR instruction count right after IR generation. An
+exponent above `--superlinear-threshold` points to a scaling cliff and is
+reported.
+"""
+
+import argparse
+import csv
+import json
+import math
+import os
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+
+from gen_sysy import BASE_SIZES, SHAPES, generate  # noqa: E402
+
+PHASES = ['frontend', 'ir', 'asm']
+
+
+def run_compiler(command: list, timeout: int):
+    """Run the compiler, return the exit code, the wall time in seconds, the
+    peak RSS in KiB and the standard error."""
+    with tempfile.TemporaryFile() as stderr_file:
+        start = time.perf_counter()
+        process = subprocess.Popen(command,
+                                   stdout=subprocess.DEVNULL,
+                                   stderr=stderr_file)
+        timer = threading.Timer(timeout, process.kill)
+        timer.start()
+        # reap the child here to get its own resource usage
+        _, status, usage = os.wait4(process.pid, 0)
+        wall = time.perf_counter() - start
+        timer.cancel()
+        process.returncode = os.waitstatus_to_exitcode(status)
+
+        stderr_file.seek(0)
+        stderr = stderr_file.read().decode(errors='replace')
+
+    if wall >= timeout:
+        return None, wall, 0, 'timeout'
+    # `ru_maxrss` is in KiB on Linux
+    return process.returncode, wall, usage.ru_maxrss, stderr
+
+
+def summarize_stats(stats_path: str) -> dict:
+    with open(stats_path) as f:
+        stats = json.load(f)
+
+    summary = {f'{phase}_seconds': 0.0 for phase in PHASES}
+    ir_list = []
+    asm_list = []
+    slowest = None
+    for item in stats['passes']:
+        phase = item['name'].split('.')[0]
+        if phase in PHASES:
+            summary[f'{phase}_seconds'] += item['seconds']
+        if phase == 'ir':
+            ir_list.append(item)
+        elif phase == 'asm':
+            asm_list.append(item)
+        if slowest is None or item['seconds'] > slowest['seconds']:
+            slowest = item
+
+    # the first IR pass is the generation, count right after it
+    summary['ir_instructions'] = (ir_list[0]['instructions_after']
+                                  if ir_list else 0)
+    summary['ir_instructions_final'] = (ir_list[-1]['instructions_after']
+                                        if ir_list else 0)
+    summary['asm_instructions'] = (asm_list[-1]['instructions_after']
+                                   if asm_list else 0)
+    summary['slowest_pass'] = slowest['name'] if slowest else ''
+    summary['slowest_pass_seconds'] = slowest['seconds'] if slowest else 0.0
+    return summary
+
+
+def bench(args):
+    os.makedirs(args.output_dir, exist_ok=True)
+
+    shape_list = args.shapes.split(',') if args.shapes else SHAPES
+    scale_list = [int(scale) for scale in args.scales.split(',')]
+
+    row_list = []
+    cliff_list = []
+
+    for shape in shape_list:
+        prev = None
+        for scale in scale_list:
+            size = BASE_SIZES[shape] * scale
+            basename = f'{shape}_{size}'
+            sy_path = os.path.join(args.output_dir, f'{basename}.sy')
+            asm_path = os.path.join(args.output_dir, f'{basename}.s')
+            stats_path = os.path.join(args.output_dir, f'{basename}.json')
+
+            with open(sy_path, 'w') as f:
+                f.write(generate(shape, size, args.seed))
+
+            command = [
+                args.executable_path, sy_path, '-S', '-o', asm_path,
+                f'-O{args.opt_level}', '-stats-json', stats_path
+            ]
+
+            # keep the fastest run, the others are slowed down by noise
+            best = None
+            for _ in range(args.repeat):
+                code, wall, peak_rss, stderr = run_compiler(
+                    command, args.timeout)
+                if code != 0:
+                    best = None
+                    break
+                if best is None or wall < best[0]:
+                    best = (wall, peak_rss)
+
+            row = {
+                'shape': shape,
+                'scale': scale,
+                'size': size,
+                'opt_level': args.opt_level,
+                'source_bytes': os.path.getsize(sy_path),
+                'status': 'ok' if best is not None else 'error',
+            }
+
+            if best is None:
+                print(f'{basename}: failed ({stderr.strip()[-200:]})')
+                row_list.append(row)
+                prev = None
+                continue
+
+            row['wall_seconds'] = round(best[0], 6)
+            row['peak_rss_kib'] = best[1]
+            row.update(summarize_stats(stats_path))
+            for phase in PHASES:
+                row[f'{phase}_seconds'] = round(row[f'{phase}_seconds'], 6)
+
+            growth = ''
+            if prev is not None and prev['ir_instructions'] > 0 and row[
+                    'ir_instructions'] > prev['ir_instructions']:
+                growth = math.log(
+                    max(row['wall_seconds'], 1e-6) /
+                    max(prev['wall_seconds'], 1e-6)) / math.log(
+                        row['ir_instructions'] / prev['ir_instructions'])
+                growth = round(growth, 3)
+                # tiny programs are dominated by the startup time
+                if (growth > args.superlinear_threshold
+                        and row['wall_seconds'] >= args.min_seconds):
+                    cliff_list.append((shape, prev['size'], size, growth,
+                                       row['slowest_pass']))
+            row['growth_exponent'] = growth
+
+            print(f'{basename}: {row["wall_seconds"]:.3f}s '
+                  f'{row["peak_rss_kib"]} KiB '
+                  f'(frontend {row["frontend_seconds"]:.3f}s, '
+                  f'ir {row["ir_seconds"]:.3f}s, '
+                  f'asm {row["asm_seconds"]:.3f}s) '
+                  f'growth {growth}')
+
+            row_list.append(row)
+            prev = row
+
+    fieldnames = [
+        'shape', 'scale', 'size', 'opt_level', 'status', 'source_bytes',
+        'ir_instructions', 'ir_instructions_final', 'asm_instructions',
+        'wall_seconds', 'frontend_seconds', 'ir_seconds', 'asm_seconds',
+        'peak_rss_kib', 'slowest_pass', 'slowest_pass_seconds',
+        'growth_exponent'
+    ]
+    with open(args.csv_file, 'w', newline='') as f:
+        csv_writer = csv.DictWriter(f, fieldnames=fieldnames)
+        csv_writer.writeheader()
+        csv_writer.writerows(row_list)
+
+    for shape, prev_size, size, growth, slowest in cliff_list:
+        print(f'super-linear: {shape} {prev_size} -> {size}, '
+              f'exponent {growth}, slowest pass {slowest}')
+
+    failed = any(row['status'] != 'ok' for row in row_list)
+    return 1 if failed or (cliff_list and args.fail_on_superlinear) else 0
+
+
+def parse_args():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--executable-path', default='./syc')
+    parser.add_argument('--output-dir', default='./compile-bench')
+    parser.add_argument('--csv-file', default='./compile_bench.csv')
+    parser.add_argument('--opt-level', type=int, default=1)
+    parser.add_argument('--shapes', default=None)
+    parser.add_argument('--scales', default='1,2,4,8')
+    parser.add_argument('--seed', type=int, default=0)
+    parser.add_argument('--repeat', type=int, default=3)
+    parser.add_argument('--timeout', type=int, default=600)
+
+    parser.add_argument('--superlinear-threshold', type=float, default=1.5)
+    parser.add_argument('--min-seconds', type=float, default=0.1)
+    parser.add_argument('--fail-on-superlinear',
+                        action='store_true',
+                        default=False)
+
+    return parser.parse_args()
+
+
+def main():
+    sys.exit(bench(parse_args()))
+
+
+if __name__ == '__main__':
+    main()
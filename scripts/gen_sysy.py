@@ -0,0 +1,282 @@
+#!/usr/bin/env python3
+"""Generate synthetic SysY programs for measuring the compile time of syc.
+
+Each shape stresses one dimension of the compiler and grows with `size`:
+
+- many_functions: `size` small functions calling each other.
+- deep_loops: `size` nested while loops.
+- big_init: global and local arrays with about `size` initializers.
+- long_block: one basic block of about `size` arithmetic statements.
+- wide_phi: a loop with `size` exits joining in one block, and an if-else
+  chain of `size` arms, each assigning the same variables.
+
+The programs are deterministic for a given shape, size and seed, read nothing
+from the input and print a checksum, so they can also be run.
+"""
+
+import argparse
+import random
+
+SHAPES = [
+    'many_functions',
+    'deep_loops',
+    'big_init',
+    'long_block',
+    'wide_phi',
+]
+
+# Size of each shape at scale 1.
+BASE_SIZES = {
+    'many_functions': 64,
+    'deep_loops': 4,
+    'big_init': 2048,
+    'long_block': 512,
+    'wide_phi': 32,
+}
+
+MOD = 1000007
+
+
+def gen_many_functions(size: int, rng: random.Random) -> str:
+    lines = []
+    for i in range(size):
+        lines.append(f'int f{i}(int a, int b) {{')
+        lines.append(f'  int x = a * {rng.randint(2, 9)} + b;')
+        lines.append('  int i = 0;')
+        lines.append(f'  while (i < {rng.randint(2, 6)}) {{')
+        lines.append(f'    if (x % {rng.randint(2, 5)} == 0) {{')
+        lines.append(f'      x = x / 2 + {rng.randint(1, 100)};')
+        lines.append('    } else {')
+        lines.append(f'      x = x * 3 - {rng.randint(1, 100)};')
+        lines.append('    }')
+        lines.append(f'    x = x % {MOD};')
+        lines.append('    i = i + 1;')
+        lines.append('  }')
+        # short call chains keep the call depth bounded
+        if i % 4 != 0:
+            lines.append(f'  x = (x + f{i - 1}(b, x % 100)) % {MOD};')
+        lines.append('  return x;')
+        lines.append('}')
+        lines.append('')
+
+    lines.append('int main() {')
+    lines.append('  int sum = 0;')
+    for i in range(size):
+        lines.append(f'  sum = (sum + f{i}({i}, sum % 100)) % {MOD};')
+    lines.append('  putint(sum);')
+    lines.append('  putch(10);')
+    lines.append('  return 0;')
+    lines.append('}')
+    return '\n'.join(lines) + '\n'
+
+
+def gen_deep_loops(size: int, rng: random.Random) -> str:
+    lines = []
+    # the bound is a global variable so that the nest is not fully unrolled
+    lines.append('int bound = 2;')
+    lines.append(f'int a[{size}];')
+    lines.append('')
+    lines.append('int main() {')
+    lines.append('  int sum = 0;')
+    for d in range(size):
+        indent = '  ' * (d + 1)
+        lines.append(f'{indent}int i{d} = 0;')
+        lines.append(f'{indent}while (i{d} < bound) {{')
+        lines.append(f'{indent}  a[{d}] = a[{d}] + i{d};')
+        if d % 3 == 2:
+            lines.append(f'{indent}  if (a[{d}] % 7 == 3) {{')
+            lines.append(f'{indent}    i{d} = i{d} + 1;')
+            lines.append(f'{indent}    continue;')
+            lines.append(f'{indent}  }}')
+    inner = '  ' * (size + 1)
+    terms = ' + '.join(f'i{d} * {rng.randint(1, 9)}' for d in range(size))
+    lines.append(f'{inner}sum = (sum + {terms}) % {MOD};')
+    for d in reversed(range(size)):
+        indent = '  ' * (d + 1)
+        lines.append(f'{indent}  i{d} = i{d} + 1;')
+        lines.append(f'{indent}}}')
+    lines.append(f'  int k = 0;')
+    lines.append(f'  while (k < {size}) {{')
+    lines.append(f'    sum = (sum + a[k]) % {MOD};')
+    lines.append('    k = k + 1;')
+    lines.append('  }')
+    lines.append('  putint(sum);')
+    lines.append('  putch(10);')
+    lines.append('  return 0;')
+    lines.append('}')
+    return '\n'.join(lines) + '\n'
+
+
+def gen_big_init(size: int, rng: random.Random) -> str:
+    cols = 16
+    rows = max(1, size // cols)
+    local_size = max(1, size // 8)
+
+    def values(count):
+        return ', '.join(str(rng.randint(-1000, 1000)) for _ in range(count))
+
+    lines = []
+    lines.append(f'const int table[{size}] = {{{values(size)}}};')
+    grid_rows = []
+    for _ in range(rows):
+        # leave some rows partial to exercise the zero filling
+        grid_rows.append('{' + values(rng.randint(1, cols)) + '}')
+    lines.append(f'int grid[{rows}][{cols}] = {{{", ".join(grid_rows)}}};')
+    lines.append(
+        f'float weight[{local_size}] = {{'
+        + ', '.join(f'{rng.uniform(-1, 1):.4f}' for _ in range(local_size))
+        + '};'
+    )
+    lines.append('')
+    lines.append('int main() {')
+    lines.append(f'  int local[{local_size}] = {{{values(local_size)}}};')
+    lines.append('  int sum = 0;')
+    lines.append('  int i = 0;')
+    lines.append(f'  while (i < {size}) {{')
+    lines.append(f'    sum = (sum + table[i]) % {MOD};')
+    lines.append('    i = i + 1;')
+    lines.append('  }')
+    lines.append('  i = 0;')
+    lines.append(f'  while (i < {rows}) {{')
+    lines.append('    int j = 0;')
+    lines.append(f'    while (j < {cols}) {{')
+    lines.append(f'      sum = (sum + grid[i][j]) % {MOD};')
+    lines.append('      j = j + 1;')
+    lines.append('    }')
+    lines.append('    i = i + 1;')
+    lines.append('  }')
+    lines.append('  float w = 0.0;')
+    lines.append('  i = 0;')
+    lines.append(f'  while (i < {local_size}) {{')
+    lines.append(f'    sum = (sum + local[i]) % {MOD};')
+    lines.append('    w = w + weight[i];')
+    lines.append('    i = i + 1;')
+    lines.append('  }')
+    lines.append('  putint(sum);')
+    lines.append('  putch(10);')
+    lines.append('  putfloat(w);')
+    lines.append('  putch(10);')
+    lines.append('  return 0;')
+    lines.append('}')
+    return '\n'.join(lines) + '\n'
+
+
+def gen_long_block(size: int, rng: random.Random) -> str:
+    lines = []
+    # the recursion hides the seed from constant folding
+    lines.append('int opaque(int n) {')
+    lines.append('  if (n <= 0) {')
+    lines.append('    return 7;')
+    lines.append('  }')
+    lines.append('  return opaque(n - 1) * 3 + 1;')
+    lines.append('}')
+    lines.append('')
+    lines.append('int block(int seed) {')
+    lines.append('  int v0 = seed;')
+    lines.append('  int v1 = seed * 3 + 1;')
+    ops = ['+', '-', '*']
+    for i in range(2, size):
+        # operands at various distances keep many values live at once
+        lhs = rng.randint(max(0, i - 64), i - 1)
+        rhs = rng.randint(0, i - 1)
+        op = rng.choice(ops)
+        if op == '*':
+            lines.append(f'  int v{i} = (v{lhs} * v{rhs}) % {MOD};')
+        else:
+            lines.append(
+                f'  int v{i} = v{lhs} {op} v{rhs} + {rng.randint(0, 9)};')
+    count = min(size, 32)
+    terms = ' + '.join(f'v{size - 1 - k} % 1000' for k in range(count))
+    lines.append(f'  return {terms};')
+    lines.append('}')
+    lines.append('')
+    lines.append('int main() {')
+    lines.append('  int sum = 0;')
+    lines.append('  int i = 0;')
+    lines.append('  while (i < 3) {')
+    lines.append(f'    sum = (sum + block(opaque(i))) % {MOD};')
+    lines.append('    i = i + 1;')
+    lines.append('  }')
+    lines.append('  putint(sum);')
+    lines.append('  putch(10);')
+    lines.append('  return 0;')
+    lines.append('}')
+    return '\n'.join(lines) + '\n'
+
+
+def gen_wide_phi(size: int, rng: random.Random) -> str:
+    var_count = 8
+    lines = []
+    lines.append('int seed = 3;')
+    lines.append('')
+    lines.append('int main() {')
+    for v in range(var_count):
+        lines.append(f'  int x{v} = {v};')
+    lines.append('  int k = seed;')
+    # every break jumps to the loop exit, which joins `size` paths
+    lines.append('  while (1) {')
+    for arm in range(size):
+        lines.append(f'    if (k % {size + 1} == {arm}) {{')
+        for v in range(var_count):
+            lines.append(f'      x{v} = x{v} + {rng.randint(1, 100)};')
+        lines.append('      break;')
+        lines.append('    }')
+    lines.append('    k = k + 1;')
+    lines.append('  }')
+    # an if-else chain joining `size` arms
+    lines.append('  int y = 0;')
+    for arm in range(size):
+        keyword = 'if' if arm == 0 else '} else if'
+        lines.append(f'  {keyword} (x{arm % var_count} % {size} == {arm}) {{')
+        lines.append(f'    y = {rng.randint(1, 1000)};')
+    lines.append('  } else {')
+    lines.append('    y = -1;')
+    lines.append('  }')
+    terms = ' + '.join(f'x{v}' for v in range(var_count))
+    lines.append(f'  putint({terms} + y);')
+    lines.append('  putch(10);')
+    lines.append('  return 0;')
+    lines.append('}')
+    return '\n'.join(lines) + '\n'
+
+
+GENERATORS = {
+    'many_functions': gen_many_functions,
+    'deep_loops': gen_deep_loops,
+    'big_init': gen_big_init,
+    'long_block': gen_long_block,
+    'wide_phi': gen_wide_phi,
+}
+
+
+def generate(shape: str, size: int, seed: int = 0) -> str:
+    """Generate the program of a shape and size."""
+    rng = random.Random(f'{shape}-{size}-{seed}')
+    return GENERATORS[shape](size, rng)
+
+
+def parse_args():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--shape', choices=SHAPES, required=True)
+    parser.add_argument('--size', type=int, default=None)
+    parser.add_argument('--seed', type=int, default=0)
+    parser.add_argument('--output', default=None)
+
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+
+    size = args.size if args.size is not None else BASE_SIZES[args.shape]
+    program = generate(args.shape, size, args.seed)
+
+    if args.output is None:
+        print(program, end='')
+    else:
+        with open(args.output, 'w') as f:
+            f.write(program)
+
+
+if __name__ == '__main__':
+    main()
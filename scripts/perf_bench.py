@@ -0,0 +1,258 @@
+#!/usr/bin/env python3
+"""Run the performance corpus and compare two builds of syc.
+
+Each testcase of the corpus is compiled with syc, linked against the SysY
+runtime and run under `qemu-riscv64` in user mode. For every testcase the
+wall time, the total of the `starttime`/`stoptime` timers printed by the
+runtime and, with `--insn-plugin` pointing to the `libinsn.so` plugin of QEMU,
+the number of retired instructions are recorded. The fastest of `--repeat`
+runs is kept.
+
+With `--baseline-path` the same is done for a second build, and each testcase
+is compared on the retired instructions if they are counted, or on the timers
+otherwise. A ratio above `1 + --threshold` is reported as a slowdown.
+"""
+
+import argparse
+import csv
+import math
+import os
+import re
+import shutil
+import subprocess
+import sys
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+
+from execute import check_file  # noqa: E402
+
+
+def find_testcases(testcase_dir: str) -> list:
+    testcase_list = []
+    for file in sorted(os.listdir(testcase_dir)):
+        if file.endswith('.sy'):
+            testcase_list.append(
+                os.path.join(testcase_dir,
+                             file.rsplit('.', 1)[0]))
+    return testcase_list
+
+
+def parse_timer(stderr: str) -> int:
+    """Total of the runtime timers in microseconds, -1 if not printed."""
+    # Format: TOTAL: xH-xM-xS-xus
+    total = re.search(r'TOTAL: (\d+)H-(\d+)M-(\d+)S-(\d+)us', stderr)
+    if not total:
+        return -1
+    return (int(total.group(1)) * 3600 * 1000000 +
+            int(total.group(2)) * 60 * 1000000 +
+            int(total.group(3)) * 1000000 + int(total.group(4)))
+
+
+def parse_instructions(stderr: str) -> int:
+    """Retired instructions printed by the insn plugin, -1 if not printed."""
+    insns = re.search(r'insns: (\d+)', stderr)
+    return int(insns.group(1)) if insns else -1
+
+
+def run_testcase(args, testcase: str, exec_path: str, out_path: str) -> dict:
+    in_path = f'{testcase}.in'
+    std_out_path = f'{testcase}.out'
+
+    command = [args.qemu, '-L', args.sysroot]
+    if args.insn_plugin:
+        command += ['-plugin', args.insn_plugin, '-d', 'plugin']
+    command.append(exec_path)
+
+    best = None
+    for _ in range(args.repeat):
+        stdin = open(in_path, 'rb') if os.path.isfile(in_path) else None
+        start = time.perf_counter()
+        try:
+            result = subprocess.run(command,
+                                    stdin=stdin,
+                                    stdout=subprocess.PIPE,
+                                    stderr=subprocess.PIPE,
+                                    timeout=args.timeout)
+        except subprocess.TimeoutExpired:
+            return {'status': 'TLE'}
+        finally:
+            if stdin is not None:
+                stdin.close()
+        wall = time.perf_counter() - start
+
+        # add return code to the last line of out file
+        content = result.stdout.decode(errors='replace')
+        if len(content) > 0 and not content.endswith('\n'):
+            content += '\n'
+        content += f'{result.returncode}\n'
+        with open(out_path, 'w') as f:
+            f.write(content)
+
+        if not check_file(out_path, std_out_path, None):
+            return {'status': 'WA'}
+
+        stderr = result.stderr.decode(errors='replace')
+        run = {
+            'status': 'AC',
+            'wall_seconds': round(wall, 6),
+            'timer_us': parse_timer(stderr),
+            'instructions': parse_instructions(stderr),
+        }
+        if best is None or run['wall_seconds'] < best['wall_seconds']:
+            best = run
+
+    return best
+
+
+def bench_build(args, executable_path: str, label: str) -> dict:
+    """Compile, link and run every testcase with one build of syc."""
+    output_dir = os.path.join(args.output_dir, label)
+    if os.path.exists(output_dir):
+        shutil.rmtree(output_dir)
+    os.makedirs(output_dir)
+
+    result = {}
+    for testcase in find_testcases(args.testcase_dir):
+        basename = os.path.basename(testcase)
+        asm_path = os.path.join(output_dir, f'{basename}.s')
+        exec_path = os.path.join(output_dir, basename)
+        out_path = os.path.join(output_dir, f'{basename}.out')
+
+        command = [
+            executable_path, f'{testcase}.sy', '-S', '-o', asm_path,
+            f'-O{args.opt_level}'
+        ]
+        try:
+            compiled = subprocess.run(command,
+                                      stdout=subprocess.DEVNULL,
+                                      stderr=subprocess.DEVNULL,
+                                      timeout=args.timeout).returncode == 0
+        except subprocess.TimeoutExpired:
+            compiled = False
+
+        if compiled:
+            command = [
+                args.cc, '-march=rv64gc', asm_path,
+                f'-L{args.runtime_lib_dir}', '-lsylib', '-o', exec_path
+            ]
+            compiled = subprocess.run(command,
+                                      stdout=subprocess.DEVNULL,
+                                      stderr=subprocess.DEVNULL).returncode == 0
+
+        if not compiled:
+            run = {'status': 'CE'}
+        else:
+            run = run_testcase(args, testcase, exec_path, out_path)
+
+        print(f'[{label}] {basename}: {run["status"]} '
+              f'{run.get("wall_seconds", "-")}s '
+              f'timer {run.get("timer_us", "-")}us '
+              f'insns {run.get("instructions", "-")}')
+        result[basename] = run
+
+    return result
+
+
+def compare_metric(run: dict, baseline_run: dict) -> tuple:
+    """The metric both runs are compared on and its ratio, or None."""
+    for metric in ['instructions', 'timer_us', 'wall_seconds']:
+        value = run.get(metric, -1)
+        baseline_value = baseline_run.get(metric, -1)
+        if value > 0 and baseline_value > 0:
+            return metric, value / baseline_value
+    return None, None
+
+
+def main():
+    args = parse_args()
+
+    result = bench_build(args, args.executable_path, 'new')
+    baseline = (bench_build(args, args.baseline_path, 'baseline')
+                if args.baseline_path else None)
+
+    fields = ['status', 'wall_seconds', 'timer_us', 'instructions']
+    fieldnames = ['testcase'] + fields
+    if baseline is not None:
+        fieldnames += [f'baseline_{field}' for field in fields]
+        fieldnames += ['metric', 'ratio', 'verdict']
+
+    row_list = []
+    ratio_list = []
+    slowdown_list = []
+    failed = False
+
+    for basename, run in result.items():
+        row = {'testcase': basename}
+        row.update({field: run.get(field, '') for field in fields})
+        failed = failed or run['status'] != 'AC'
+
+        if baseline is not None:
+            baseline_run = baseline[basename]
+            row.update({
+                f'baseline_{field}': baseline_run.get(field, '')
+                for field in fields
+            })
+            metric, ratio = (None, None)
+            if run['status'] == 'AC' and baseline_run['status'] == 'AC':
+                metric, ratio = compare_metric(run, baseline_run)
+            if ratio is None:
+                verdict = 'n/a'
+            elif ratio > 1 + args.threshold:
+                verdict = 'slower'
+                slowdown_list.append((basename, metric, ratio))
+            elif ratio < 1 - args.threshold:
+                verdict = 'faster'
+            else:
+                verdict = 'same'
+            if ratio is not None:
+                ratio_list.append(ratio)
+            row['metric'] = metric or ''
+            row['ratio'] = round(ratio, 4) if ratio is not None else ''
+            row['verdict'] = verdict
+
+        row_list.append(row)
+
+    with open(args.csv_file, 'w', newline='') as f:
+        csv_writer = csv.DictWriter(f, fieldnames=fieldnames)
+        csv_writer.writeheader()
+        csv_writer.writerows(row_list)
+
+    if ratio_list:
+        geomean = math.exp(
+            sum(math.log(ratio) for ratio in ratio_list) / len(ratio_list))
+        print(f'geomean ratio against the baseline: {geomean:.4f}')
+    for basename, metric, ratio in slowdown_list:
+        print(f'slowdown: {basename} {metric} x{ratio:.4f}')
+
+    if failed or (slowdown_list and args.fail_on_slowdown):
+        sys.exit(1)
+
+
+def parse_args():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--executable-path', default='./syc')
+    parser.add_argument('--baseline-path', default=None)
+    parser.add_argument('--testcase-dir', default='./perf-tests')
+    parser.add_argument('--runtime-lib-dir', default='./sysy-runtime-lib')
+    parser.add_argument('--output-dir', default='./perf-output')
+    parser.add_argument('--csv-file', default='./perf_result.csv')
+    parser.add_argument('--opt-level', type=int, default=3)
+    parser.add_argument('--repeat', type=int, default=3)
+    parser.add_argument('--timeout', type=int, default=600)
+
+    parser.add_argument('--cc', default='riscv64-linux-gnu-gcc')
+    parser.add_argument('--qemu', default='qemu-riscv64')
+    parser.add_argument('--sysroot', default='/usr/riscv64-linux-gnu')
+    parser.add_argument('--insn-plugin', default=None)
+
+    parser.add_argument('--threshold', type=float, default=0.02)
+    parser.add_argument('--fail-on-slowdown',
+                        action='store_true',
+                        default=False)
+
+    return parser.parse_args()
+
+
+if __name__ == '__main__':
+    main()
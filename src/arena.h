@@ -0,0 +1,103 @@
+#ifndef SYC_ARENA_H_
+#define SYC_ARENA_H_
+
+#include "common.h"
+
+namespace syc {
+
+/// Typed bump allocator with stable addresses.
+///
+/// Objects are constructed into chunks and are only destroyed together with
+/// the arena, so the raw pointers handed out by `create` stay valid for the
+/// whole lifetime of the owner. This replaces one heap allocation and one
+/// reference-counted control block per node.
+///
+/// Chunks start small and double up to `MaxChunkSize` objects, so an arena
+/// that only ever holds a few objects (e.g. the one of a small function) does
+/// not reserve a full chunk.
+template <typename T, size_t MaxChunkSize = 512, size_t MinChunkSize = 8>
+struct Arena {
+  /// Raw storage of a chunk.
+  /// Only sized in the member functions, so an arena can be declared while `T`
+  /// is incomplete.
+  struct Chunk {
+    std::unique_ptr<unsigned char[]> storage;
+    size_t capacity;
+
+    Chunk(size_t capacity)
+      : storage(new unsigned char[sizeof(T) * capacity]), capacity(capacity) {
+      static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+    }
+
+    T* at(size_t index) { return reinterpret_cast<T*>(storage.get()) + index; }
+  };
+
+  /// Allocated chunks.
+  std::vector<Chunk> chunk_list;
+  /// Number of constructed objects in the last chunk.
+  size_t last_chunk_size = 0;
+  /// Number of constructed objects in total.
+  size_t object_count = 0;
+
+  Arena() = default;
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  Arena(Arena&& other) noexcept
+    : chunk_list(std::move(other.chunk_list)),
+      last_chunk_size(other.last_chunk_size),
+      object_count(other.object_count) {
+    other.chunk_list.clear();
+    other.last_chunk_size = 0;
+    other.object_count = 0;
+  }
+
+  ~Arena() { clear(); }
+
+  /// Construct a new object in the arena.
+  template <typename... Args>
+  T* create(Args&&... args) {
+    if (chunk_list.empty() || last_chunk_size == chunk_list.back().capacity) {
+      auto capacity = chunk_list.empty()
+                      ? MinChunkSize
+                      : std::min(chunk_list.back().capacity * 2, MaxChunkSize);
+      chunk_list.emplace_back(capacity);
+      last_chunk_size = 0;
+    }
+    T* object = new (chunk_list.back().at(last_chunk_size))
+      T(std::forward<Args>(args)...);
+    last_chunk_size++;
+    object_count++;
+    return object;
+  }
+
+  /// Destroy all the objects in reverse order of construction.
+  void clear() {
+    while (!chunk_list.empty()) {
+      auto& chunk = chunk_list.back();
+      for (size_t i = last_chunk_size; i > 0; i--) {
+        chunk.at(i - 1)->~T();
+      }
+      chunk_list.pop_back();
+      last_chunk_size = chunk_list.empty() ? 0 : chunk_list.back().capacity;
+    }
+    object_count = 0;
+  }
+
+  /// Number of objects constructed in the arena.
+  size_t size() const { return object_count; }
+
+  /// Bytes reserved by the arena.
+  size_t reserved_bytes() const {
+    size_t capacity = 0;
+    for (const auto& chunk : chunk_list) {
+      capacity += chunk.capacity;
+    }
+    return capacity * sizeof(T);
+  }
+};
+
+}  // namespace syc
+
+#endif
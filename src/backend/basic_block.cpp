@@ -70,27 +70,33 @@ void BasicBlock::insert_prev(BasicBlockPtr basic_block) {
   this->prev = basic_block;
 }
 
-std::string BasicBlock::to_string(Context& context) {
-  std::string result = this->get_label() + ":\n";
+void BasicBlock::emit(Emitter& out, Context& context) {
+  out << this->get_label() << ":\n";
 
-  result += "\t# preds = ";
+  out << "\t# preds = ";
   for (auto pred_id : this->pred_list) {
-    result += std::to_string(pred_id) + ", ";
+    out.id(pred_id) << ", ";
   }
-  result += "; succs = ";
+  out << "; succs = ";
   for (auto succ_id : this->succ_list) {
-    result += std::to_string(succ_id) + ", ";
+    out.id(succ_id) << ", ";
   }
-  result += "\n";
+  out << "\n";
 
   auto curr_instruction = this->head_instruction->next;
 
   while (curr_instruction != this->tail_instruction) {
-    result += "\t" + curr_instruction->to_string(context) + "\n";
+    out << "\t";
+    curr_instruction->emit(out, context);
+    out << "\n";
     curr_instruction = curr_instruction->next;
   }
+}
 
-  return result;
+std::string BasicBlock::to_string(Context& context) {
+  Emitter out;
+  emit(out, context);
+  return out.str();
 }
 
 BasicBlockPtr
@@ -2,6 +2,8 @@
 #define SYC_BACKEND_BASIC_BLOCK_H_
 
 #include "common.h"
+#include "dense_table.h"
+#include "emitter.h"
 
 namespace syc {
 namespace backend {
@@ -29,7 +31,7 @@ struct BasicBlock : std::enable_shared_from_this<BasicBlock> {
   void remove_pred(BasicBlockID pred_id);
   void remove_succ(BasicBlockID succ_id);
 
-  std::string get_label() const { return ".bb_" + std::to_string(id); }
+  std::string get_label() const { return ".bb_" + id_to_string(id); }
 
   void prepend_instruction(InstructionPtr instruction);
   void append_instruction(InstructionPtr instruction);
@@ -37,6 +39,10 @@ struct BasicBlock : std::enable_shared_from_this<BasicBlock> {
   void insert_next(BasicBlockPtr basic_block);
   void insert_prev(BasicBlockPtr basic_block);
 
+  /// Emit the label, a comment of the predecessors and successors, and the
+  /// instructions.
+  void emit(Emitter& out, Context& context);
+
   std::string to_string(Context& context);
 };
 
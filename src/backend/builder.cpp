@@ -3,8 +3,17 @@
 namespace syc {
 namespace backend {
 
+Builder::Builder()
+  : owned_context(std::make_unique<Context>()), context(*owned_context) {}
+
+Builder::Builder(Context& context) : context(context) {}
+
+size_t Builder::get_curr_id_space() const {
+  return curr_function ? curr_function->id_space : 0;
+}
+
 OperandID Builder::fetch_operand(OperandKind kind, Modifier modifier) {
-  auto id = context.get_next_operand_id();
+  auto id = context.get_next_operand_id(get_curr_id_space());
   auto operand = std::make_shared<Operand>(id, kind, modifier);
   context.register_operand(operand);
   return id;
@@ -13,8 +22,15 @@ OperandID Builder::fetch_operand(OperandKind kind, Modifier modifier) {
 OperandID Builder::fetch_immediate(
   std::variant<int32_t, int64_t, uint32_t, uint64_t> value
 ) {
-  auto kind = Immediate{value};
-  return fetch_operand(kind, Modifier::None);
+  auto& immediate_operand_cache =
+    context.get_id_space(get_curr_id_space()).immediate_operand_cache;
+  if (immediate_operand_cache.count(value)) {
+    return immediate_operand_cache[value];
+  } else {
+    auto operand_id = fetch_operand(Immediate{value}, Modifier::None);
+    immediate_operand_cache[value] = operand_id;
+    return operand_id;
+  }
 }
 
 OperandID Builder::fetch_global(
@@ -26,12 +42,14 @@ OperandID Builder::fetch_global(
 }
 
 OperandID Builder::fetch_virtual_register(VirtualRegisterKind kind) {
-  auto vreg_id = context.get_next_virtual_register_id();
+  auto vreg_id = context.get_next_virtual_register_id(get_curr_id_space());
   auto vreg = VirtualRegister{vreg_id, kind};
   return fetch_operand(vreg, Modifier::None);
 }
 
 OperandID Builder::fetch_register(Register reg) {
+  auto& reg_operand_cache =
+    context.get_id_space(get_curr_id_space()).reg_operand_cache;
   if (reg_operand_cache.count(reg)) {
     return reg_operand_cache[reg];
   } else {
@@ -47,7 +65,7 @@ OperandID Builder::fetch_local_memory(int offset, Register reg) {
 }
 
 BasicBlockPtr Builder::fetch_basic_block() {
-  auto id = context.get_next_basic_block_id();
+  auto id = context.get_next_basic_block_id(get_curr_id_space());
   auto basic_block = create_basic_block(id, curr_function->name);
 
   context.register_basic_block(basic_block);
@@ -60,7 +78,7 @@ InstructionPtr Builder::fetch_load_instruction(
   OperandID rs_id,
   OperandID imm_id
 ) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
   auto kind = InstructionKind(instruction::Load{op, rd_id, rs_id, imm_id});
   auto instruction = create_instruction(id, kind, curr_basic_block->id);
 
@@ -81,7 +99,7 @@ InstructionPtr Builder::fetch_float_load_instruction(
   OperandID rs_id,
   OperandID imm_id
 ) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
   auto kind = InstructionKind(instruction::FloatLoad{op, rd_id, rs_id, imm_id});
   auto instruction = create_instruction(id, kind, curr_basic_block->id);
 
@@ -102,7 +120,7 @@ InstructionPtr Builder::fetch_store_instruction(
   OperandID rs2_id,
   OperandID imm_id
 ) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
   auto kind = InstructionKind(instruction::Store{op, rs1_id, rs2_id, imm_id});
   auto instruction = create_instruction(id, kind, curr_basic_block->id);
 
@@ -123,7 +141,7 @@ InstructionPtr Builder::fetch_float_store_instruction(
   OperandID rs2_id,
   OperandID imm_id
 ) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
   auto kind =
     InstructionKind(instruction::FloatStore{op, rs1_id, rs2_id, imm_id});
   auto instruction = create_instruction(id, kind, curr_basic_block->id);
@@ -144,7 +162,7 @@ InstructionPtr Builder::fetch_pseudo_load_instruction(
   OperandID rd_id,
   OperandID symbol_id
 ) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
   auto kind = InstructionKind(instruction::PseudoLoad{op, rd_id, symbol_id});
   auto instruction = create_instruction(id, kind, curr_basic_block->id);
 
@@ -163,7 +181,7 @@ InstructionPtr Builder::fetch_pseudo_store_instruction(
   OperandID symbol_id,
   OperandID rt_id
 ) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
   auto kind =
     InstructionKind(instruction::PseudoStore{op, rd_id, symbol_id, rt_id});
   auto instruction = create_instruction(id, kind, curr_basic_block->id);
@@ -188,7 +206,7 @@ InstructionPtr Builder::fetch_float_pseudo_load_instruction(
   OperandID symbol_id,
   OperandID rt_id
 ) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
   auto kind =
     InstructionKind(instruction::FloatPseudoLoad{op, rd_id, symbol_id, rt_id});
   auto instruction = create_instruction(id, kind, curr_basic_block->id);
@@ -213,7 +231,7 @@ InstructionPtr Builder::fetch_float_pseudo_store_instruction(
   OperandID symbol_id,
   OperandID rt_id
 ) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
   auto kind =
     InstructionKind(instruction::FloatPseudoStore{op, rd_id, symbol_id, rt_id});
   auto instruction = create_instruction(id, kind, curr_basic_block->id);
@@ -238,7 +256,7 @@ InstructionPtr Builder::fetch_float_move_instruction(
   OperandID rd_id,
   OperandID rs_id
 ) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
   auto kind =
     InstructionKind(instruction::FloatMove{dst_fmt, src_fmt, rd_id, rs_id});
   auto instruction = create_instruction(id, kind, curr_basic_block->id);
@@ -260,7 +278,7 @@ InstructionPtr Builder::fetch_float_convert_instruction(
   OperandID rd_id,
   OperandID rs_id
 ) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
   auto kind =
     InstructionKind(instruction::FloatConvert{dst_fmt, src_fmt, rd_id, rs_id});
   auto instruction = create_instruction(id, kind, curr_basic_block->id);
@@ -282,7 +300,7 @@ InstructionPtr Builder::fetch_binary_instruction(
   OperandID rs1_id,
   OperandID rs2_id
 ) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
   auto kind = InstructionKind(instruction::Binary{op, rd_id, rs1_id, rs2_id});
   auto instruction = create_instruction(id, kind, curr_basic_block->id);
 
@@ -305,7 +323,7 @@ InstructionPtr Builder::fetch_binary_imm_instruction(
   OperandID rs_id,
   OperandID imm_id
 ) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
   auto kind = InstructionKind(instruction::BinaryImm{op, rd_id, rs_id, imm_id});
   auto instruction = create_instruction(id, kind, curr_basic_block->id);
 
@@ -327,7 +345,7 @@ InstructionPtr Builder::fetch_float_binary_instruction(
   OperandID rs1_id,
   OperandID rs2_id
 ) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
   auto kind =
     InstructionKind(instruction::FloatBinary{op, fmt, rd_id, rs1_id, rs2_id});
   auto instruction = create_instruction(id, kind, curr_basic_block->id);
@@ -353,7 +371,7 @@ InstructionPtr Builder::fetch_float_mul_add_instruction(
   OperandID rs2_id,
   OperandID rs3_id
 ) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
   auto kind = InstructionKind(instruction::FloatMulAdd{
     op, fmt, rd_id, rs1_id, rs2_id, rs3_id});
   auto instruction = create_instruction(id, kind, curr_basic_block->id);
@@ -379,7 +397,7 @@ InstructionPtr Builder::fetch_float_unary_instruction(
   OperandID rd_id,
   OperandID rs_id
 ) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
   auto kind = InstructionKind(instruction::FloatUnary{op, fmt, rd_id, rs_id});
   auto instruction = create_instruction(id, kind, curr_basic_block->id);
 
@@ -396,7 +414,7 @@ InstructionPtr Builder::fetch_float_unary_instruction(
 
 InstructionPtr
 Builder::fetch_lui_instruction(OperandID rd_id, OperandID imm_id) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
   auto kind = InstructionKind(instruction::Lui{rd_id, imm_id});
   auto instruction = create_instruction(id, kind, curr_basic_block->id);
 
@@ -411,7 +429,7 @@ Builder::fetch_lui_instruction(OperandID rd_id, OperandID imm_id) {
 
 InstructionPtr
 Builder::fetch_li_instruction(OperandID rd_id, OperandID imm_id) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
   auto kind = InstructionKind(instruction::Li{rd_id, imm_id});
   auto instruction = create_instruction(id, kind, curr_basic_block->id);
 
@@ -428,7 +446,7 @@ InstructionPtr Builder::fetch_call_instruction(
   std::string function_name,
   std::set<Register> used_arg_reg_set
 ) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
   auto kind = InstructionKind(instruction::Call{function_name});
   auto instruction = create_instruction(id, kind, curr_basic_block->id);
 
@@ -462,7 +480,7 @@ InstructionPtr Builder::fetch_branch_instruction(
   OperandID rs2_id,
   BasicBlockID block_id
 ) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
   auto kind =
     InstructionKind(instruction::Branch{op, rs1_id, rs2_id, block_id});
   auto instruction = create_instruction(id, kind, curr_basic_block->id);
@@ -479,7 +497,7 @@ InstructionPtr Builder::fetch_branch_instruction(
 }
 
 InstructionPtr Builder::fetch_j_instruction(BasicBlockID block_id) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
   auto kind = InstructionKind(instruction::J{block_id});
   auto instruction = create_instruction(id, kind, curr_basic_block->id);
 
@@ -489,7 +507,7 @@ InstructionPtr Builder::fetch_j_instruction(BasicBlockID block_id) {
 }
 
 InstructionPtr Builder::fetch_ret_instruction() {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
   auto kind = InstructionKind(instruction::Ret{});
   auto instruction = create_instruction(id, kind, curr_basic_block->id);
 
@@ -502,7 +520,7 @@ InstructionPtr Builder::fetch_phi_instruction(
   OperandID rd_id,
   std::vector<std::tuple<OperandID, BasicBlockID>> incoming_list
 ) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
   auto kind = InstructionKind(instruction::Phi{rd_id, incoming_list});
   auto instruction = create_instruction(id, kind, curr_basic_block->id);
 
@@ -546,6 +564,7 @@ void Builder::switch_function(std::string function_name) {
 
 void Builder::add_function(std::string name) {
   auto function = std::make_shared<Function>(name);
+  function->id_space = context.create_id_space();
   context.register_function(function);
 }
 
@@ -15,15 +15,28 @@ namespace syc {
 namespace backend {
 
 struct Builder {
+  /// Context owned by this builder, null if the context is shared.
+  std::unique_ptr<Context> owned_context;
   /// Context of the assembly
-  Context context;
+  Context& context;
   /// Current function
   FunctionPtr curr_function;
   /// Current basic block
   BasicBlockPtr curr_basic_block;
 
-  /// Make sure that same physical registers have the save operand_id
-  std::unordered_map<Register, OperandID, RegisterHash> reg_operand_cache;
+  /// Create a builder with a new context.
+  Builder();
+
+  /// Create a builder on an existing context, e.g. for a worker thread that
+  /// lowers one function at a time.
+  explicit Builder(Context& context);
+
+  Builder(const Builder&) = delete;
+  Builder& operator=(const Builder&) = delete;
+
+  /// Get the ID space to allocate new nodes in, the space of the current
+  /// function or the space of the globals if there is no current function.
+  size_t get_curr_id_space() const;
 
   OperandID fetch_operand(OperandKind kind, Modifier modifier);
 
@@ -187,8 +200,6 @@ struct Builder {
   void switch_function(std::string function_name);
 
   void add_function(std::string name);
-
-  Builder() = default;
 };
 
 }  // namespace backend
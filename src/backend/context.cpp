@@ -10,11 +10,24 @@
 namespace syc {
 namespace backend {
 
+Context::Context() {
+  create_id_space();
+}
+
+size_t Context::create_id_space() {
+  auto space = id_space_list.size();
+  id_space_list.push_back(std::make_unique<IdSpace>());
+  operand_table.reserve_space(space);
+  instruction_table.reserve_space(space);
+  basic_block_table.reserve_space(space);
+  return space;
+}
+
 void Context::register_operand(OperandPtr operand) {
-  if (operand_table.find(operand->id) != operand_table.end()) {
+  if (operand_table.contains(operand->id)) {
     throw std::runtime_error("Operand ID already exists.");
   }
-  operand_table[operand->id] = operand;
+  operand_table.insert(operand->id, operand);
 
   // If the operand is global, add it to the global list.
   if (std::holds_alternative<Global>(operand->kind) && operand->modifier == Modifier::None) {
@@ -23,17 +36,17 @@ void Context::register_operand(OperandPtr operand) {
 }
 
 void Context::register_instruction(InstructionPtr instruction) {
-  if (instruction_table.find(instruction->id) != instruction_table.end()) {
+  if (instruction_table.contains(instruction->id)) {
     throw std::runtime_error("Instruction ID already exists.");
   }
-  instruction_table[instruction->id] = instruction;
+  instruction_table.insert(instruction->id, instruction);
 }
 
 void Context::register_basic_block(BasicBlockPtr basic_block) {
-  if (basic_block_table.find(basic_block->id) != basic_block_table.end()) {
+  if (basic_block_table.contains(basic_block->id)) {
     throw std::runtime_error("BasicBlock ID already exists.");
   }
-  basic_block_table[basic_block->id] = basic_block;
+  basic_block_table.insert(basic_block->id, basic_block);
 }
 
 void Context::register_function(FunctionPtr function) {
@@ -64,11 +77,11 @@ FunctionPtr Context::get_function(std::string name) {
   return function_table.at(name);
 }
 
-std::string Context::to_string() {
+void Context::emit(Emitter& out) {
   // generate asm code
-  std::string result = "\t.option pic\n";
-  result += "\t.text\n";
-  result += 
+  out << "\t.option pic\n";
+  out << "\t.text\n";
+  out <<
   "\t.globl  __builtin_fill_zero\n"
   "\t.align  1\n"
   "\t.type   __builtin_fill_zero, @function\n"
@@ -84,16 +97,103 @@ std::string Context::to_string() {
   "\tbne     a0,a5,.__builtin_label_0\n"
   "\tret\n";
 
+  auto cached_it = this->cached_function_table.begin();
   for (auto& func : this->function_table) {
-    result += func.second->to_string(*this);
+    while (cached_it != this->cached_function_table.end() &&
+           cached_it->first < func.first) {
+      out << cached_it->second;
+      cached_it++;
+    }
+    func.second->emit(out, *this);
+  }
+  for (; cached_it != this->cached_function_table.end(); cached_it++) {
+    out << cached_it->second;
   }
 
   for (auto& operand_id : this->global_list) {
     auto& global = std::get<Global>(this->operand_table.at(operand_id)->kind);
-    result += global.to_string() + "\n";
+    global.emit(out);
+    out << "\n";
+  }
+}
+
+void Context::count_nodes(CountList& count_list) {
+  static const char* instruction_kind_names[] = {
+    "load",          "float_load",         "pseudo_load",
+    "pseudo_store",  "float_pseudo_load",  "float_pseudo_store",
+    "store",         "float_store",        "float_move",
+    "float_convert", "binary",             "binary_imm",
+    "float_binary",  "float_mul_add",      "float_unary",
+    "lui",           "li",                 "call",
+    "branch",        "ret",                "j",
+    "dummy",         "phi"};
+  static const char* operand_kind_names[] = {
+    "immediate", "virtual_register", "register", "global", "local_memory"};
+  static_assert(
+    std::size(instruction_kind_names) ==
+      std::variant_size_v<InstructionKind> &&
+    std::size(operand_kind_names) == std::variant_size_v<OperandKind>
+  );
+
+  // Nodes reachable from the functions, the tables also hold removed ones.
+  size_t basic_block_count = 0;
+  std::vector<size_t> instruction_count_list(
+    std::variant_size_v<InstructionKind>, 0
+  );
+  for (auto& [function_name, function] : function_table) {
+    auto curr_bb = function->head_basic_block->next;
+    while (curr_bb != function->tail_basic_block) {
+      basic_block_count++;
+      auto curr_instruction = curr_bb->head_instruction->next;
+      while (curr_instruction != curr_bb->tail_instruction) {
+        instruction_count_list[curr_instruction->kind.index()]++;
+        curr_instruction = curr_instruction->next;
+      }
+      curr_bb = curr_bb->next;
+    }
   }
 
-  return result;
+  std::vector<size_t> operand_count_list(std::variant_size_v<OperandKind>, 0);
+  for (auto [operand_id, operand] : operand_table) {
+    operand_count_list[operand->kind.index()]++;
+  }
+
+  size_t virtual_register_count = 0;
+  size_t reg_cache_count = 0;
+  size_t immediate_cache_count = 0;
+  for (const auto& id_space : id_space_list) {
+    virtual_register_count += id_space->next_virtual_register_local;
+    reg_cache_count += id_space->reg_operand_cache.size();
+    immediate_cache_count += id_space->immediate_operand_cache.size();
+  }
+
+  count_list.push_back({"asm.functions", function_table.size()});
+  count_list.push_back({"asm.globals", global_list.size()});
+  count_list.push_back({"asm.live_basic_blocks", basic_block_count});
+  for (size_t i = 0; i < instruction_count_list.size(); i++) {
+    count_list.push_back(
+      {std::string("asm.live_instructions.") + instruction_kind_names[i],
+       instruction_count_list[i]}
+    );
+  }
+  for (size_t i = 0; i < operand_count_list.size(); i++) {
+    count_list.push_back(
+      {std::string("asm.table.operands.") + operand_kind_names[i],
+       operand_count_list[i]}
+    );
+  }
+  count_list.push_back({"asm.table.instructions", instruction_table.size()});
+  count_list.push_back({"asm.table.basic_blocks", basic_block_table.size()});
+  count_list.push_back({"asm.id_spaces", id_space_list.size()});
+  count_list.push_back({"asm.virtual_registers", virtual_register_count});
+  count_list.push_back({"asm.interned_registers", reg_cache_count});
+  count_list.push_back({"asm.interned_immediates", immediate_cache_count});
+}
+
+std::string Context::to_string() {
+  Emitter out;
+  emit(out);
+  return out.str();
 }
 
 }  // namespace backend
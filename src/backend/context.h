@@ -2,33 +2,74 @@
 #define SYC_BACKEND_CONTEXT_H_
 
 #include "backend/global.h"
+#include "backend/register.h"
 #include "common.h"
+#include "dense_table.h"
+#include "emitter.h"
 
 namespace syc {
 namespace backend {
 
+/// Counters and interned operands of an ID space.
+///
+/// Space 0 holds the globals and every function has its own space, the same
+/// as in the IR, so the functions can be lowered and allocated on different
+/// threads with the same IDs as on one thread.
+struct IdSpace {
+  size_t next_operand_local = 0;
+  size_t next_instruction_local = 0;
+  size_t next_basic_block_local = 0;
+  size_t next_virtual_register_local = 0;
+
+  /// Make sure that same physical registers have the save operand_id
+  std::unordered_map<Register, OperandID, RegisterHash> reg_operand_cache;
+
+  /// Make sure that same immediates have the same operand_id
+  std::map<std::variant<int32_t, int64_t, uint32_t, uint64_t>, OperandID>
+    immediate_operand_cache;
+};
+
 struct Context {
-  std::map<OperandID, OperandPtr> operand_table;
-  std::map<InstructionID, InstructionPtr> instruction_table;
-  std::map<BasicBlockID, BasicBlockPtr> basic_block_table;
+  /// ID spaces, indexed by the space of the IDs.
+  std::vector<std::unique_ptr<IdSpace>> id_space_list;
+
+  /// Tables from the dense IDs to the nodes.
+  /// Virtual registers are operands, so they are indexed by operand ID.
+  DenseTable<OperandID, OperandPtr> operand_table;
+  DenseTable<InstructionID, InstructionPtr> instruction_table;
+  DenseTable<BasicBlockID, BasicBlockPtr> basic_block_table;
 
   std::vector<OperandID> global_list;
   std::map<std::string, FunctionPtr> function_table;
+  /// Assembly of the functions taken from the compile cache, emitted in name
+  /// order together with the functions in `function_table`.
+  std::map<std::string, std::string> cached_function_table;
+
+  /// Create the context with the space of the globals.
+  Context();
+
+  Context(const Context&) = delete;
+  Context& operator=(const Context&) = delete;
 
-  OperandID next_operand_id = 0;
-  InstructionID next_instruction_id = 0;
-  BasicBlockID next_basic_block_id = 0;
+  /// Add a new ID space, must not run concurrently with other users.
+  size_t create_id_space();
 
-  VirtualRegisterID next_virtual_register_id = 0;
+  IdSpace& get_id_space(size_t space) { return *id_space_list[space]; }
 
-  OperandID get_next_operand_id() { return next_operand_id++; }
+  OperandID get_next_operand_id(size_t space) {
+    return make_id(space, get_id_space(space).next_operand_local++);
+  }
 
-  InstructionID get_next_instruction_id() { return next_instruction_id++; }
+  InstructionID get_next_instruction_id(size_t space) {
+    return make_id(space, get_id_space(space).next_instruction_local++);
+  }
 
-  BasicBlockID get_next_basic_block_id() { return next_basic_block_id++; }
+  BasicBlockID get_next_basic_block_id(size_t space) {
+    return make_id(space, get_id_space(space).next_basic_block_local++);
+  }
 
-  VirtualRegisterID get_next_virtual_register_id() {
-    return next_virtual_register_id++;
+  VirtualRegisterID get_next_virtual_register_id(size_t space) {
+    return make_id(space, get_id_space(space).next_virtual_register_local++);
   }
 
   void register_operand(OperandPtr operand);
@@ -47,7 +88,13 @@ struct Context {
 
   FunctionPtr get_function(std::string name);
 
+  /// Emit the whole assembly file.
+  void emit(Emitter& out);
+
   std::string to_string();
+
+  /// Count the live nodes by kind and the sizes of the tables.
+  void count_nodes(CountList& count_list);
 };
 
 }  // namespace backend
@@ -16,20 +16,24 @@ void Function::append_basic_block(BasicBlockPtr basic_block) {
   this->tail_basic_block->insert_prev(basic_block);
 }
 
-std::string Function::to_string(Context& context) {
-  std::string result = "\t.globl " + this->name + "\n";
-  result += "\t.align 1\n";
-  result += "\t.type " + this->name + ", @function\n";
-  result += this->name + ":\n";
+void Function::emit(Emitter& out, Context& context) {
+  out << "\t.globl " << this->name << "\n";
+  out << "\t.align 1\n";
+  out << "\t.type " << this->name << ", @function\n";
+  out << this->name << ":\n";
 
   auto curr_basic_block = this->head_basic_block->next;
 
   while (curr_basic_block != this->tail_basic_block) {
-    result += curr_basic_block->to_string(context);
+    curr_basic_block->emit(out, context);
     curr_basic_block = curr_basic_block->next;
   }
+}
 
-  return result;
+std::string Function::to_string(Context& context) {
+  Emitter out;
+  emit(out, context);
+  return out.str();
 }
 
 void Function::add_saved_register(Register reg) {
@@ -3,6 +3,7 @@
 
 #include "backend/register.h"
 #include "common.h"
+#include "emitter.h"
 
 namespace syc {
 namespace backend {
@@ -16,6 +17,9 @@ struct Function {
   /// Saved registers used in the function
   std::set<Register> saved_register_set;
 
+  /// ID space of the nodes of this function.
+  size_t id_space = 0;
+
   BasicBlockPtr head_basic_block;
   BasicBlockPtr tail_basic_block;
 
@@ -23,6 +27,9 @@ struct Function {
 
   void append_basic_block(BasicBlockPtr basic_block);
 
+  /// Emit the symbol directives, the label and the blocks.
+  void emit(Emitter& out, Context& context);
+
   std::string to_string(Context& context);
 
   void add_saved_register(Register reg);
@@ -13,33 +13,37 @@ size_t Global::get_size() const {
   );
 }
 
-std::string Global::to_string() const {
-  std::string result = "\t.type " + name + ", @object\n";
+void Global::emit(Emitter& out) const {
+  out << "\t.type " << name << ", @object\n";
 
   std::visit(
     overloaded{
-      [&result, this](const std::vector<uint32_t>& v) {
-        result += "\t.data\n";
-        result += "\t.globl " + name + "\n";
-        result += "\t.align 2\n";
-        result += name + ":\n";
+      [&out, this](const std::vector<uint32_t>& v) {
+        out << "\t.data\n";
+        out << "\t.globl " << name << "\n";
+        out << "\t.align 2\n";
+        out << name << ":\n";
         for (auto& i : v) {
-          result += "\t.word " + std::to_string(i) + "\n";
+          out << "\t.word " << i << "\n";
         }
       },
-      [&result, this](uint64_t v) {
-        result += "\t.bss\n";
-        result += "\t.globl " + name + "\n";
-        result += "\t.align 2\n";
-        result += name + ":\n";
-        result += "\t.zero " + std::to_string(v) + "\n";
+      [&out, this](uint64_t v) {
+        out << "\t.bss\n";
+        out << "\t.globl " << name << "\n";
+        out << "\t.align 2\n";
+        out << name << ":\n";
+        out << "\t.zero " << v << "\n";
       },
     },
     value
   );
-  result += "\t.size " + name + ", " + std::to_string(get_size()) + "\n";
+  out << "\t.size " << name << ", " << get_size() << "\n";
+}
 
-  return result;
+std::string Global::to_string() const {
+  Emitter out;
+  emit(out);
+  return out.str();
 }
 
 }  // namespace backend
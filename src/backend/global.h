@@ -2,6 +2,7 @@
 #define SYC_BACKEND_GLOBAL_H_
 
 #include "common.h"
+#include "emitter.h"
 
 namespace syc {
 namespace backend {
@@ -17,6 +18,9 @@ struct Global {
   /// The size of the global variable.
   size_t get_size() const;
 
+  /// Emit the declaration in the assembly code.
+  void emit(Emitter& out) const;
+
   /// Convert to declaration in the assembly code.
   std::string to_string() const;
 };
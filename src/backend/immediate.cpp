@@ -3,28 +3,24 @@
 namespace syc {
 namespace backend {
 
-std::string Immediate::to_string(int width) const {
-  return std::visit(
+void Immediate::emit(Emitter& out, int width) const {
+  std::visit(
     overloaded{
-      [](int32_t v) { return std::to_string(v); },
-      [](int64_t v) { return std::to_string(v); },
-      [=](uint32_t v) {
-        std::stringstream ss;
-        int w = (width == 0) ? 8 : width;
-        ss << "0x" << std::setfill('0') << std::setw(w) << std::hex << v;
-        return ss.str();
-      },
-      [=](uint64_t v) {
-        std::stringstream ss;
-        int w = (width == 0) ? 16 : width;
-        ss << "0x" << std::setfill('0') << std::setw(w) << std::hex << v;
-        return ss.str();
-      },
+      [&](int32_t v) { out << v; },
+      [&](int64_t v) { out << v; },
+      [&](uint32_t v) { out.hex(v, (width == 0) ? 8 : width); },
+      [&](uint64_t v) { out.hex(v, (width == 0) ? 16 : width); },
     },
     value
   );
 }
 
+std::string Immediate::to_string(int width) const {
+  Emitter out;
+  emit(out, width);
+  return out.str();
+}
+
 bool Immediate::is_zero() const {
   return std::visit(
     overloaded{
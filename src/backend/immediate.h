@@ -2,6 +2,7 @@
 #define SYC_BACKEND_IMMEDIATE_H_
 
 #include "common.h"
+#include "emitter.h"
 
 namespace syc {
 namespace backend {
@@ -12,6 +13,9 @@ namespace backend {
 struct Immediate {
   std::variant<int32_t, int64_t, uint32_t, uint64_t> value;
 
+  /// Emit the value, unsigned values in hex padded to `width` digits.
+  void emit(Emitter& out, int width = 0) const;
+
   std::string to_string(int width = 0) const;
 
   bool is_zero() const;
@@ -634,554 +634,485 @@ void Instruction::raw_remove() {
   }
 }
 
-std::string Instruction::to_string(Context& context) {
+void Instruction::emit(Emitter& out, Context& context) {
   using namespace instruction;
 
-  return std::visit(
+  std::visit(
     overloaded{
-      [&context](const Load& instruction) {
-        std::stringstream ss;
-
+      [&](const Load& instruction) {
         auto rd = context.get_operand(instruction.rd_id);
         auto rs = context.get_operand(instruction.rs_id);
         auto imm = context.get_operand(instruction.imm_id);
 
         switch (instruction.op) {
           case Load::LB:
-            ss << "lb";
+            out << "lb";
             break;
           case Load::LH:
-            ss << "lh";
+            out << "lh";
             break;
           case Load::LW:
-            ss << "lw";
+            out << "lw";
             break;
           case Load::LBU:
-            ss << "lbu";
+            out << "lbu";
             break;
           case Load::LHU:
-            ss << "lhu";
+            out << "lhu";
             break;
           case Load::LD:
-            ss << "ld";
+            out << "ld";
             break;
           case Load::LWU:
-            ss << "lwu";
+            out << "lwu";
             break;
         }
 
-        ss << " " << rd->to_string() << ", " << imm->to_string() << "("
-           << rs->to_string() << ")";
-
-        return ss.str();
+        out << " " << *rd << ", " << *imm << "(" << *rs << ")";
       },
 
-      [&context](const Store& instruction) {
-        std::stringstream ss;
-
+      [&](const Store& instruction) {
         auto rs1 = context.get_operand(instruction.rs1_id);
         auto rs2 = context.get_operand(instruction.rs2_id);
         auto imm = context.get_operand(instruction.imm_id);
 
         switch (instruction.op) {
           case Store::SB:
-            ss << "sb";
+            out << "sb";
             break;
           case Store::SH:
-            ss << "sh";
+            out << "sh";
             break;
           case Store::SW:
-            ss << "sw";
+            out << "sw";
             break;
           case Store::SD:
-            ss << "sd";
+            out << "sd";
             break;
         }
 
-        ss << " " << rs2->to_string() << ", " << imm->to_string() << "("
-           << rs1->to_string() << ")";
-
-        return ss.str();
+        out << " " << *rs2 << ", " << *imm << "(" << *rs1 << ")";
       },
-      [&context](const PseudoLoad& instruction) {
-        std::stringstream ss;
-
+      [&](const PseudoLoad& instruction) {
         auto rd = context.get_operand(instruction.rd_id);
         auto symbol = context.get_operand(instruction.symbol_id);
 
         switch (instruction.op) {
           case PseudoLoad::LA:
-            ss << "la";
+            out << "la";
             break;
           case PseudoLoad::LW:
-            ss << "lw";
+            out << "lw";
             break;
         }
 
-        ss << " " << rd->to_string() << ", " << symbol->to_string();
-
-        return ss.str();
+        out << " " << *rd << ", " << *symbol;
       },
-      [&context](const PseudoStore& instruction) {
-        std::stringstream ss;
-
+      [&](const PseudoStore& instruction) {
         auto rd = context.get_operand(instruction.rd_id);
         auto symbol = context.get_operand(instruction.symbol_id);
         auto rt = context.get_operand(instruction.rt_id);
 
         switch (instruction.op) {
           case PseudoStore::SW:
-            ss << "sw";
+            out << "sw";
             break;
         }
 
-        ss << " " << rd->to_string() << ", " << symbol->to_string() << ", "
-           << rt->to_string();
-
-        return ss.str();
+        out << " " << *rd << ", " << *symbol << ", " << *rt;
       },
-      [&context](const FloatPseudoLoad& instruction) {
-        std::stringstream ss;
-
+      [&](const FloatPseudoLoad& instruction) {
         auto rd = context.get_operand(instruction.rd_id);
         auto symbol = context.get_operand(instruction.symbol_id);
         auto rt = context.get_operand(instruction.rt_id);
 
         switch (instruction.op) {
           case FloatPseudoLoad::FLW:
-            ss << "flw";
+            out << "flw";
             break;
         }
 
-        ss << " " << rd->to_string() << ", " << symbol->to_string() << ", "
-           << rt->to_string();
-
-        return ss.str();
+        out << " " << *rd << ", " << *symbol << ", " << *rt;
       },
-      [&context](const FloatPseudoStore& instruction) {
-        std::stringstream ss;
-
+      [&](const FloatPseudoStore& instruction) {
         auto rd = context.get_operand(instruction.rd_id);
         auto symbol = context.get_operand(instruction.symbol_id);
         auto rt = context.get_operand(instruction.rt_id);
 
         switch (instruction.op) {
           case FloatPseudoStore::FSW:
-            ss << "fsw";
+            out << "fsw";
             break;
         }
 
-        ss << " " << rd->to_string() << ", " << symbol->to_string() << ", "
-           << rt->to_string();
-
-        return ss.str();
+        out << " " << *rd << ", " << *symbol << ", " << *rt;
       },
-      [&context](const Binary& instruction) {
-        std::stringstream ss;
-
+      [&](const Binary& instruction) {
         auto rd = context.get_operand(instruction.rd_id);
         auto rs1 = context.get_operand(instruction.rs1_id);
         auto rs2 = context.get_operand(instruction.rs2_id);
 
         switch (instruction.op) {
           case Binary::ADD:
-            ss << "add";
+            out << "add";
             break;
           case Binary::ADDW:
-            ss << "addw";
+            out << "addw";
             break;
           case Binary::SUB:
-            ss << "sub";
+            out << "sub";
             break;
           case Binary::SUBW:
-            ss << "subw";
+            out << "subw";
             break;
           case Binary::SLL:
-            ss << "sll";
+            out << "sll";
             break;
           case Binary::SLLW:
-            ss << "sllw";
+            out << "sllw";
             break;
           case Binary::SRL:
-            ss << "srl";
+            out << "srl";
             break;
           case Binary::SRLW:
-            ss << "srlw";
+            out << "srlw";
             break;
           case Binary::SRA:
-            ss << "sra";
+            out << "sra";
             break;
           case Binary::SRAW:
-            ss << "sraw";
+            out << "sraw";
             break;
           case Binary::XOR:
-            ss << "xor";
+            out << "xor";
             break;
           case Binary::OR:
-            ss << "or";
+            out << "or";
             break;
           case Binary::AND:
-            ss << "and";
+            out << "and";
             break;
           case Binary::SLT:
-            ss << "slt";
+            out << "slt";
             break;
           case Binary::SLTU:
-            ss << "sltu";
+            out << "sltu";
             break;
           case Binary::MUL:
-            ss << "mul";
+            out << "mul";
             break;
           case Binary::MULW:
-            ss << "mulw";
+            out << "mulw";
             break;
           case Binary::MULH:
-            ss << "mulh";
+            out << "mulh";
             break;
           case Binary::MULHSU:
-            ss << "mulhsu";
+            out << "mulhsu";
             break;
           case Binary::MULHU:
-            ss << "mulhu";
+            out << "mulhu";
             break;
           case Binary::DIV:
-            ss << "div";
+            out << "div";
             break;
           case Binary::DIVW:
-            ss << "divw";
+            out << "divw";
             break;
           case Binary::DIVU:
-            ss << "divu";
+            out << "divu";
             break;
           case Binary::REM:
-            ss << "rem";
+            out << "rem";
             break;
           case Binary::REMW:
-            ss << "remw";
+            out << "remw";
             break;
           case Binary::REMU:
-            ss << "remu";
+            out << "remu";
             break;
           case Binary::REMUW:
-            ss << "remuw";
+            out << "remuw";
             break;
         }
 
-        ss << " " << rd->to_string() << ", " << rs1->to_string() << ", "
-           << rs2->to_string();
-
-        return ss.str();
+        out << " " << *rd << ", " << *rs1 << ", " << *rs2;
       },
-      [&context](const BinaryImm& instruction) {
-        std::stringstream ss;
-
+      [&](const BinaryImm& instruction) {
         auto rd = context.get_operand(instruction.rd_id);
         auto rs = context.get_operand(instruction.rs_id);
         auto imm = context.get_operand(instruction.imm_id);
 
         switch (instruction.op) {
           case BinaryImm::ADDI:
-            ss << "addi";
+            out << "addi";
             break;
           case BinaryImm::ADDIW:
-            ss << "addiw";
+            out << "addiw";
             break;
           case BinaryImm::SLLI:
-            ss << "slli";
+            out << "slli";
             break;
           case BinaryImm::SLLIW:
-            ss << "slliw";
+            out << "slliw";
             break;
           case BinaryImm::SRLI:
-            ss << "srli";
+            out << "srli";
             break;
           case BinaryImm::SRLIW:
-            ss << "srliw";
+            out << "srliw";
             break;
           case BinaryImm::SRAI:
-            ss << "srai";
+            out << "srai";
             break;
           case BinaryImm::SRAIW:
-            ss << "sraiw";
+            out << "sraiw";
             break;
           case BinaryImm::XORI:
-            ss << "xori";
+            out << "xori";
             break;
           case BinaryImm::ORI:
-            ss << "ori";
+            out << "ori";
             break;
           case BinaryImm::ANDI:
-            ss << "andi";
+            out << "andi";
             break;
           case BinaryImm::SLTI:
-            ss << "slti";
+            out << "slti";
             break;
           case BinaryImm::SLTIU:
-            ss << "sltiu";
+            out << "sltiu";
             break;
         }
 
-        ss << " " << rd->to_string() << ", " << rs->to_string() << ", "
-           << imm->to_string(3);
-
-        return ss.str();
+        out << " " << *rd << ", " << *rs << ", ";
+        imm->emit(out, 3);
       },
-      [&context](const Lui& instruction) {
-        std::stringstream ss;
-
+      [&](const Lui& instruction) {
         auto rd = context.get_operand(instruction.rd_id);
         auto imm = context.get_operand(instruction.imm_id);
 
-        ss << "lui " << rd->to_string() << ", " << imm->to_string(5);
-
-        return ss.str();
+        out << "lui " << *rd << ", ";
+        imm->emit(out, 5);
       },
-      [&context](const Li& instruction) {
-        std::stringstream ss;
-
+      [&](const Li& instruction) {
         auto rd = context.get_operand(instruction.rd_id);
         auto imm = context.get_operand(instruction.imm_id);
 
-        ss << "li " << rd->to_string() << ", " << imm->to_string();
-
-        return ss.str();
+        out << "li " << *rd << ", " << *imm;
       },
-      [&context](const Call& instruction) {
-        return "call " + instruction.function_name;
+      [&](const Call& instruction) {
+        out << "call " << instruction.function_name;
       },
-      [&context](const Branch& instruction) {
-        std::stringstream ss;
-
+      [&](const Branch& instruction) {
         auto rs1 = context.get_operand(instruction.rs1_id);
         auto rs2 = context.get_operand(instruction.rs2_id);
 
         switch (instruction.op) {
           case Branch::BEQ:
-            ss << "beq";
+            out << "beq";
             break;
           case Branch::BNE:
-            ss << "bne";
+            out << "bne";
             break;
           case Branch::BLT:
-            ss << "blt";
+            out << "blt";
             break;
           case Branch::BGE:
-            ss << "bge";
+            out << "bge";
             break;
           case Branch::BLTU:
-            ss << "bltu";
+            out << "bltu";
             break;
           case Branch::BGEU:
-            ss << "bgeu";
+            out << "bgeu";
             break;
         }
 
-        ss << " " << rs1->to_string() << ", " << rs2->to_string() << ", "
-           << context.get_basic_block(instruction.block_id)->get_label();
-
-        return ss.str();
+        out << " " << *rs1 << ", " << *rs2 << ", "
+            << context.get_basic_block(instruction.block_id)->get_label();
       },
-      [&context](const FloatLoad& instruction) {
-        std::stringstream ss;
-
+      [&](const FloatLoad& instruction) {
         auto rd = context.get_operand(instruction.rd_id);
         auto rs = context.get_operand(instruction.rs_id);
         auto imm = context.get_operand(instruction.imm_id);
 
         switch (instruction.op) {
           case FloatLoad::FLW:
-            ss << "flw";
+            out << "flw";
             break;
           case FloatLoad::FLD:
-            ss << "fld";
+            out << "fld";
             break;
         }
 
-        ss << " " << rd->to_string() << ", " << imm->to_string() << "("
-           << rs->to_string() << ")";
-
-        return ss.str();
+        out << " " << *rd << ", " << *imm << "(" << *rs << ")";
       },
-      [&context](const FloatStore& instruction) {
-        std::stringstream ss;
-
+      [&](const FloatStore& instruction) {
         auto rs1 = context.get_operand(instruction.rs1_id);
         auto rs2 = context.get_operand(instruction.rs2_id);
         auto imm = context.get_operand(instruction.imm_id);
 
         switch (instruction.op) {
           case FloatStore::FSW:
-            ss << "fsw";
+            out << "fsw";
             break;
           case FloatStore::FSD:
-            ss << "fsd";
+            out << "fsd";
             break;
         }
 
-        ss << " " << rs2->to_string() << ", " << imm->to_string() << "("
-           << rs1->to_string() << ")";
-
-        return ss.str();
+        out << " " << *rs2 << ", " << *imm << "(" << *rs1 << ")";
       },
-      [&context](const FloatMove& instruction) {
-        std::stringstream ss;
-
-        ss << "fmv";
+      [&](const FloatMove& instruction) {
+        out << "fmv";
 
         switch (instruction.dst_fmt) {
           case FloatMove::H:
-            ss << ".h";
+            out << ".h";
             break;
           case FloatMove::S:
-            ss << ".w";
+            out << ".w";
             break;
           case FloatMove::D:
-            ss << ".d";
+            out << ".d";
             break;
           case FloatMove::X:
-            ss << ".x";
+            out << ".x";
             break;
         }
 
         switch (instruction.src_fmt) {
           case FloatMove::H:
-            ss << ".h";
+            out << ".h";
             break;
           case FloatMove::S:
-            ss << ".w";
+            out << ".w";
             break;
           case FloatMove::D:
-            ss << ".d";
+            out << ".d";
             break;
           case FloatMove::X:
-            ss << ".x";
+            out << ".x";
             break;
         }
 
         auto rd = context.get_operand(instruction.rd_id);
         auto rs = context.get_operand(instruction.rs_id);
 
-        ss << " " << rd->to_string() << ", " << rs->to_string();
-
-        return ss.str();
+        out << " " << *rd << ", " << *rs;
       },
-      [&context](const FloatConvert& instruction) {
-        std::stringstream ss;
-
-        ss << "fcvt";
+      [&](const FloatConvert& instruction) {
+        out << "fcvt";
 
         switch (instruction.dst_fmt) {
           case FloatConvert::H:
-            ss << ".h";
+            out << ".h";
             break;
           case FloatConvert::S:
-            ss << ".s";
+            out << ".s";
             break;
           case FloatConvert::D:
-            ss << ".d";
+            out << ".d";
             break;
           case FloatConvert::W:
-            ss << ".w";
+            out << ".w";
             break;
           case FloatConvert::WU:
-            ss << ".wu";
+            out << ".wu";
             break;
           case FloatConvert::L:
-            ss << ".l";
+            out << ".l";
             break;
           case FloatConvert::LU:
-            ss << ".lu";
+            out << ".lu";
             break;
         }
 
         switch (instruction.src_fmt) {
           case FloatConvert::H:
-            ss << ".h";
+            out << ".h";
             break;
           case FloatConvert::S:
-            ss << ".s";
+            out << ".s";
             break;
           case FloatConvert::D:
-            ss << ".d";
+            out << ".d";
             break;
           case FloatConvert::W:
-            ss << ".w";
+            out << ".w";
             break;
           case FloatConvert::WU:
-            ss << ".wu";
+            out << ".wu";
             break;
           case FloatConvert::L:
-            ss << ".l";
+            out << ".l";
             break;
           case FloatConvert::LU:
-            ss << ".lu";
+            out << ".lu";
             break;
         }
 
         auto rd = context.get_operand(instruction.rd_id);
         auto rs = context.get_operand(instruction.rs_id);
 
-        ss << " " << rd->to_string() << ", " << rs->to_string();
+        out << " " << *rd << ", " << *rs;
 
         if (instruction.dst_fmt == FloatConvert::W || 
             instruction.dst_fmt == FloatConvert::WU ||
             instruction.dst_fmt == FloatConvert::L ||
             instruction.dst_fmt == FloatConvert::LU) {
-          ss << ", rtz";
+          out << ", rtz";
         } else {
           // Rounding mode is not added if convert from int to float.
         }
-
-        return ss.str();
       },
-      [&context](const FloatBinary& instruction) {
-        std::stringstream ss;
-
+      [&](const FloatBinary& instruction) {
         switch (instruction.op) {
           case FloatBinary::FADD:
-            ss << "fadd";
+            out << "fadd";
             break;
           case FloatBinary::FSUB:
-            ss << "fsub";
+            out << "fsub";
             break;
           case FloatBinary::FMUL:
-            ss << "fmul";
+            out << "fmul";
             break;
           case FloatBinary::FDIV:
-            ss << "fdiv";
+            out << "fdiv";
             break;
           case FloatBinary::FSGNJ:
-            ss << "fsgnj";
+            out << "fsgnj";
             break;
           case FloatBinary::FSGNJN:
-            ss << "fsgnjn";
+            out << "fsgnjn";
             break;
           case FloatBinary::FSGNJX:
-            ss << "fsgnjx";
+            out << "fsgnjx";
             break;
           case FloatBinary::FMIN:
-            ss << "fmin";
+            out << "fmin";
             break;
           case FloatBinary::FMAX:
-            ss << "fmax";
+            out << "fmax";
             break;
           case FloatBinary::FEQ:
-            ss << "feq";
+            out << "feq";
             break;
           case FloatBinary::FLT:
-            ss << "flt";
+            out << "flt";
             break;
           case FloatBinary::FLE:
-            ss << "fle";
+            out << "fle";
             break;
         }
 
         switch (instruction.fmt) {
           case FloatBinary::S:
-            ss << ".s";
+            out << ".s";
             break;
           case FloatBinary::D:
-            ss << ".d";
+            out << ".d";
             break;
         }
 
@@ -1189,35 +1120,30 @@ std::string Instruction::to_string(Context& context) {
         auto rs1 = context.get_operand(instruction.rs1_id);
         auto rs2 = context.get_operand(instruction.rs2_id);
 
-        ss << " " << rd->to_string() << ", " << rs1->to_string() << ", "
-           << rs2->to_string();
-
-        return ss.str();
+        out << " " << *rd << ", " << *rs1 << ", " << *rs2;
       },
-      [&context](const FloatMulAdd& instruction) {
-        std::stringstream ss;
-
+      [&](const FloatMulAdd& instruction) {
         switch (instruction.op) {
           case FloatMulAdd::FMADD:
-            ss << "fmadd";
+            out << "fmadd";
             break;
           case FloatMulAdd::FMSUB:
-            ss << "fmsub";
+            out << "fmsub";
             break;
           case FloatMulAdd::FNMSUB:
-            ss << "fnmsub";
+            out << "fnmsub";
             break;
           case FloatMulAdd::FNMADD:
-            ss << "fnmadd";
+            out << "fnmadd";
             break;
         }
 
         switch (instruction.fmt) {
           case FloatMulAdd::S:
-            ss << ".s";
+            out << ".s";
             break;
           case FloatMulAdd::D:
-            ss << ".d";
+            out << ".d";
             break;
         }
 
@@ -1226,64 +1152,58 @@ std::string Instruction::to_string(Context& context) {
         auto rs2 = context.get_operand(instruction.rs2_id);
         auto rs3 = context.get_operand(instruction.rs3_id);
 
-        ss << " " << rd->to_string() << ", " << rs1->to_string() << ", "
-           << rs2->to_string() << ", " << rs3->to_string();
-
-        return ss.str();
+        out << " " << *rd << ", " << *rs1 << ", " << *rs2 << ", " << *rs3;
       },
-      [&context](const FloatUnary& instruction) {
-        std::stringstream ss;
-
+      [&](const FloatUnary& instruction) {
         switch (instruction.op) {
           case FloatUnary::FSQRT:
-            ss << "fsqrt";
+            out << "fsqrt";
             break;
           case FloatUnary::FCLASS:
-            ss << "fclass";
+            out << "fclass";
             break;
         }
 
         switch (instruction.fmt) {
           case FloatUnary::S:
-            ss << ".s";
+            out << ".s";
             break;
           case FloatUnary::D:
-            ss << ".d";
+            out << ".d";
             break;
         }
 
         auto rd = context.get_operand(instruction.rd_id);
         auto rs = context.get_operand(instruction.rs_id);
 
-        ss << " " << rd->to_string() << ", " << rs->to_string();
-
-        return ss.str();
+        out << " " << *rd << ", " << *rs;
       },
-      [&context](const J& instruction) -> std::string {
-        return "j " +
-               context.get_basic_block(instruction.block_id)->get_label();
+      [&](const J& instruction) {
+        out << "j "
+            << context.get_basic_block(instruction.block_id)->get_label();
       },
-      [&context](const Ret& instruction) -> std::string { return "ret"; },
-      [&context](const Phi& instruction) {
-        std::stringstream ss;
-
+      [&](const Ret& instruction) { out << "ret"; },
+      [&](const Phi& instruction) {
         // make as comment
-        ss << "# phi " << context.get_operand(instruction.rd_id)->to_string()
-           << " = ";
+        out << "# phi " << *context.get_operand(instruction.rd_id) << " = ";
 
         for (auto& [operand_id, block_id] : instruction.incoming_list) {
-          ss << "[" << context.get_operand(operand_id)->to_string() << ", "
-             << context.get_basic_block(block_id)->get_label() << "], ";
+          out << "[" << *context.get_operand(operand_id) << ", "
+              << context.get_basic_block(block_id)->get_label() << "], ";
         }
-
-        return ss.str();
       },
-      [&context](const auto& instruction) -> std::string { return ""; },
+      [&](const auto& instruction) {},
     },
     kind
   );
 }
 
+std::string Instruction::to_string(Context& context) {
+  Emitter out;
+  emit(out, context);
+  return out.str();
+}
+
 bool Instruction::is_phi() const {
   return std::holds_alternative<instruction::Phi>(this->kind);
 }
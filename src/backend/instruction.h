@@ -3,6 +3,7 @@
 
 #include "backend/context.h"
 #include "common.h"
+#include "emitter.h"
 
 namespace syc {
 namespace backend {
@@ -394,6 +395,10 @@ struct Instruction : std::enable_shared_from_this<Instruction> {
 
   void raw_remove();
 
+  /// Emit the instruction as a line of assembly code, without the indent and
+  /// the newline.
+  void emit(Emitter& out, Context& context);
+
   /// Convert the instruction to a string of assembly code.
   std::string to_string(Context& context);
 
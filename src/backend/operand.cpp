@@ -3,61 +3,76 @@
 namespace syc {
 namespace backend {
 
+std::mutex Operand::shared_use_mutex;
+
 Operand::Operand(OperandID id, OperandKind kind, Modifier modifier)
   : id(id), kind(kind), modifier(modifier) {}
 
 void Operand::add_def(InstructionID def_id) {
+  if (is_global()) {
+    std::lock_guard<std::mutex> lock(shared_use_mutex);
+    def_id_list.push_back(def_id);
+    return;
+  }
   def_id_list.push_back(def_id);
 }
 
 void Operand::add_use(InstructionID use_id) {
+  if (is_global()) {
+    std::lock_guard<std::mutex> lock(shared_use_mutex);
+    use_id_list.push_back(use_id);
+    return;
+  }
   use_id_list.push_back(use_id);
 }
 
 void Operand::remove_def(InstructionID def_id) {
-  this->def_id_list.erase(
-    std::remove(this->def_id_list.begin(), this->def_id_list.end(), def_id),
-    this->def_id_list.end()
-  );
+  if (is_global()) {
+    std::lock_guard<std::mutex> lock(shared_use_mutex);
+    this->def_id_list.remove(def_id);
+    return;
+  }
+  this->def_id_list.remove(def_id);
 }
 
 void Operand::remove_use(InstructionID use_id) {
-  this->use_id_list.erase(
-    std::remove(this->use_id_list.begin(), this->use_id_list.end(), use_id),
-    this->use_id_list.end()
-  );
+  if (is_global()) {
+    std::lock_guard<std::mutex> lock(shared_use_mutex);
+    this->use_id_list.remove(use_id);
+    return;
+  }
+  this->use_id_list.remove(use_id);
 }
 
-std::string Operand::to_string(int width) const {
-  std::string result = "";
-
+void Operand::emit(Emitter& out, int width) const {
   if (modifier == Modifier::Lo) {
-    result += "\%lo(";
+    out << "\%lo(";
   } else if (modifier == Modifier::Hi) {
-    result += "\%hi(";
+    out << "\%hi(";
   }
 
   std::visit(
     overloaded{
-      [&result, width](const Immediate& immediate) {
-        result += immediate.to_string(width);
-      },
-      [&result](const Register& reg) { result += reg.to_string(); },
-      [&result](const VirtualRegister& vreg) { result += vreg.to_string(); },
-      [&result](const Global& global) { result += global.name; },
-      [&result](const LocalMemory& local) {
-        result += "offset " + std::to_string(local.offset) + " from " +
-                  local.reg.to_string();
+      [&out, width](const Immediate& immediate) { immediate.emit(out, width); },
+      [&out](const Register& reg) { out << reg.to_string(); },
+      [&out](const VirtualRegister& vreg) { out << vreg.to_string(); },
+      [&out](const Global& global) { out << global.name; },
+      [&out](const LocalMemory& local) {
+        out << "offset " << local.offset << " from " << local.reg.to_string();
       },
     },
     kind
   );
 
   if (modifier != Modifier::None) {
-    result += ")";
+    out << ")";
   }
+}
 
-  return result;
+std::string Operand::to_string(int width) const {
+  Emitter out;
+  emit(out, width);
+  return out.str();
 }
 
 bool Operand::is_local_memory() const {
@@ -1,10 +1,14 @@
 #ifndef SYC_BACKEND_OPERAND_H_
 #define SYC_BACKEND_OPERAND_H_
 
+#include <mutex>
+
 #include "backend/global.h"
 #include "backend/immediate.h"
 #include "backend/register.h"
 #include "common.h"
+#include "emitter.h"
+#include "id_list.h"
 
 namespace syc {
 namespace backend {
@@ -36,8 +40,15 @@ struct Operand {
 
   Operand(OperandID id, OperandKind kind, Modifier modifier);
 
-  std::vector<InstructionID> def_id_list;
-  std::vector<InstructionID> use_id_list;
+  /// Instructions that define/use this operand.
+  /// Removal is constant time, see `IdList`.
+  IdList<InstructionID> def_id_list;
+  IdList<InstructionID> use_id_list;
+
+  /// Globals are used by all the functions, which may be lowered on
+  /// different threads, so their lists are only updated under this lock.
+  /// Registers and immediates are interned per function and need no lock.
+  static std::mutex shared_use_mutex;
 
   void add_def(InstructionID def_id);
 
@@ -47,6 +58,9 @@ struct Operand {
 
   void remove_use(InstructionID use_id);
 
+  /// Emit the operand, see `Immediate::emit` for the width.
+  void emit(Emitter& out, int width = 0) const;
+
   std::string to_string(int width = 0) const;
 
   bool is_local_memory() const;
@@ -68,6 +82,11 @@ struct Operand {
   bool operator==(const Operand& rhs) const;
 };
 
+inline Emitter& operator<<(Emitter& out, const Operand& operand) {
+  operand.emit(out);
+  return out;
+}
+
 }  // namespace backend
 }  // namespace syc
 
@@ -1,4 +1,5 @@
 #include "backend/register.h"
+#include "dense_table.h"
 
 namespace syc {
 namespace backend {
@@ -219,9 +220,9 @@ std::string Register::to_string() const {
 std::string VirtualRegister::to_string() const {
   std::string result = "";
   if (is_general()) {
-    result = "v" + std::to_string(id);
+    result = "v" + id_to_string(id);
   } else if (is_float()) {
-    result = "fv" + std::to_string(id);
+    result = "fv" + id_to_string(id);
   }
   return result;
 }
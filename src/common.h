@@ -2,6 +2,7 @@
 #define SYC_COMMON_H_
 
 #include <algorithm>
+#include <cassert>
 #include <bitset>
 #include <cmath>
 #include <functional>
@@ -31,6 +32,9 @@ overloaded(Ts...) -> overloaded<Ts...>;
 
 namespace syc {
 
+/// Named counts, e.g. of nodes or table entries.
+using CountList = std::vector<std::pair<std::string, size_t>>;
+
 namespace frontend {
 
 namespace type {
@@ -66,6 +70,9 @@ using ComptimeValueKind = std::
 
 enum class Scope;
 
+/// Interned identifier.
+using SymbolID = size_t;
+
 struct SymbolEntry;
 struct SymbolTable;
 
@@ -130,8 +137,9 @@ struct Stmt;
 
 struct Compunit;
 
-using ExprPtr = std::shared_ptr<Expr>;
-using StmtPtr = std::shared_ptr<Stmt>;
+/// Nodes are owned by the arenas of the compile unit.
+using ExprPtr = Expr*;
+using StmtPtr = Stmt*;
 
 }  // namespace ast
 
@@ -149,8 +157,10 @@ struct Context;
 struct BasicBlock;
 struct Function;
 
-using BasicBlockPtr = std::shared_ptr<BasicBlock>;
-using BasicBlockPrevPtr = std::weak_ptr<BasicBlock>;
+/// Basic blocks, instructions and operands are owned by the arenas in the
+/// context, so plain pointers are used to reference them.
+using BasicBlockPtr = BasicBlock*;
+using BasicBlockPrevPtr = BasicBlock*;
 
 using FunctionPtr = std::shared_ptr<Function>;
 
@@ -213,8 +223,10 @@ using InstructionKind = std::variant<
 
 struct Instruction;
 
-using InstructionPtr = std::shared_ptr<Instruction>;
-using InstructionPrevPtr = std::weak_ptr<Instruction>;
+using InstructionPtr = Instruction*;
+using InstructionPrevPtr = Instruction*;
+
+struct Use;
 
 namespace operand {
 
@@ -239,7 +251,7 @@ using OperandKind = std::variant<
 
 struct Operand;
 
-using OperandPtr = std::shared_ptr<Operand>;
+using OperandPtr = Operand*;
 
 }  // namespace ir
 
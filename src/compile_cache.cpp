@@ -0,0 +1,257 @@
+#include "compile_cache.h"
+
+#include <unistd.h>
+
+#include <fstream>
+#include <thread>
+
+#include "backend/context.h"
+#include "backend/function.h"
+#include "ir/context.h"
+#include "ir/function.h"
+#include "ir/operand.h"
+#include "ir/type.h"
+#include "statistics.h"
+
+namespace syc {
+
+CompileCache::CompileCache(std::filesystem::path directory, std::string config)
+  : directory(std::move(directory)), config(std::move(config)) {
+  std::error_code error;
+  std::filesystem::create_directories(this->directory, error);
+}
+
+void CompileCache::fetch_cached_functions(
+  ir::Context& ir_context,
+  backend::Context& asm_context
+) {
+  auto start = std::chrono::steady_clock::now();
+
+  // Codegen only takes the names and types of the globals, not the values.
+  std::string global_text;
+  for (auto operand_id : ir_context.global_list) {
+    auto operand = ir_context.get_operand(operand_id);
+    const auto& global = std::get<ir::operand::Global>(operand->kind);
+    global_text += "@" + global.name + " " + operand->type->to_string() + "\n";
+  }
+
+  auto function_table_copy = asm_context.function_table;
+  for (const auto& [function_name, asm_function] : function_table_copy) {
+    auto ir_function = ir_context.get_function(function_name);
+    auto key = this->config + "\n" + global_text + "\n" +
+               relocate_id_space(
+                 ir_function->to_string(ir_context),
+                 std::to_string(ir_function->id_space), "$"
+               );
+
+    auto maybe_entry = this->lookup(key);
+    if (!maybe_entry.has_value()) {
+      this->counts.miss_count++;
+      this->missed_key_map[function_name] = std::move(key);
+      continue;
+    }
+
+    this->counts.hit_count++;
+    this->counts.saved_seconds += maybe_entry->seconds;
+    asm_context.cached_function_table[function_name] = relocate_id_space(
+      maybe_entry->text, "$", std::to_string(asm_function->id_space)
+    );
+    asm_context.function_table.erase(function_name);
+  }
+
+  auto end = std::chrono::steady_clock::now();
+  this->counts.cache_seconds +=
+    std::chrono::duration<double>(end - start).count();
+
+  bump_counter("asm.cache", "hits", this->counts.hit_count);
+  bump_counter("asm.cache", "misses", this->counts.miss_count);
+  bump_counter(
+    "asm.cache", "saved microseconds",
+    size_t(this->counts.saved_seconds * 1e6)
+  );
+}
+
+void CompileCache::store_missed_functions(
+  backend::Context& asm_context,
+  const std::map<std::string, double>& seconds_map
+) {
+  auto start = std::chrono::steady_clock::now();
+
+  for (const auto& [function_name, key] : this->missed_key_map) {
+    auto asm_function = asm_context.get_function(function_name);
+    auto text = relocate_id_space(
+      asm_function->to_string(asm_context),
+      std::to_string(asm_function->id_space), "$"
+    );
+    auto seconds_it = seconds_map.find(function_name);
+    auto seconds = seconds_it != seconds_map.end() ? seconds_it->second : 0;
+    this->store(key, CacheEntry{std::move(text), seconds});
+  }
+  this->missed_key_map.clear();
+
+  auto end = std::chrono::steady_clock::now();
+  this->counts.cache_seconds +=
+    std::chrono::duration<double>(end - start).count();
+
+  bump_counter("asm.cache", "stores", this->counts.store_count);
+}
+
+std::optional<CacheEntry> CompileCache::lookup(const std::string& key) {
+  std::ifstream file(this->entry_path(key), std::ios::binary);
+  if (!file) {
+    return std::nullopt;
+  }
+
+  std::string magic;
+  std::string field;
+  double seconds = 0;
+  size_t key_size = 0;
+  size_t text_size = 0;
+  std::getline(file, magic);
+  if (magic != ENTRY_MAGIC) {
+    return std::nullopt;
+  }
+  if (!(file >> field >> seconds) || field != "seconds") {
+    return std::nullopt;
+  }
+  if (!(file >> field >> key_size) || field != "key" ||
+      key_size != key.size()) {
+    return std::nullopt;
+  }
+  file.get();
+
+  std::string entry_key(key_size, '\0');
+  if (!file.read(entry_key.data(), key_size) || entry_key != key) {
+    return std::nullopt;
+  }
+  if (!(file >> field >> text_size) || field != "text") {
+    return std::nullopt;
+  }
+  file.get();
+
+  std::string text(text_size, '\0');
+  if (!file.read(text.data(), text_size)) {
+    return std::nullopt;
+  }
+  return CacheEntry{std::move(text), seconds};
+}
+
+std::filesystem::path CompileCache::entry_path(const std::string& key) const {
+  std::ostringstream name;
+  name << std::hex << std::setw(16) << std::setfill('0') << fnv1a_hash(key);
+  return this->directory / name.str();
+}
+
+void CompileCache::store(const std::string& key, const CacheEntry& entry) {
+  auto path = this->entry_path(key);
+  auto temp_path = path;
+  temp_path += ".tmp" + std::to_string(getpid()) + "." +
+               std::to_string(
+                 std::hash<std::thread::id>()(std::this_thread::get_id())
+               );
+
+  {
+    std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+      return;
+    }
+    file << ENTRY_MAGIC << "\n";
+    file << "seconds " << entry.seconds << "\n";
+    file << "key " << key.size() << "\n" << key;
+    file << "text " << entry.text.size() << "\n" << entry.text;
+    if (!file) {
+      return;
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temp_path, path, error);
+  if (error) {
+    std::filesystem::remove(temp_path, error);
+    return;
+  }
+  this->counts.store_count++;
+}
+
+void CacheCounts::add(const CacheCounts& other) {
+  this->hit_count += other.hit_count;
+  this->miss_count += other.miss_count;
+  this->store_count += other.store_count;
+  this->saved_seconds += other.saved_seconds;
+  this->cache_seconds += other.cache_seconds;
+}
+
+std::string CacheCounts::report() const {
+  auto lookup_count = this->hit_count + this->miss_count;
+  auto hit_rate =
+    lookup_count > 0 ? 100.0 * this->hit_count / lookup_count : 0.0;
+
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(1);
+  out << "compile cache: " << this->hit_count << " hits, " << this->miss_count
+      << " misses (" << hit_rate << "% hit rate), " << this->store_count
+      << " stored\n";
+  out << std::setprecision(4);
+  out << "compile cache: " << this->saved_seconds
+      << " s of backend time saved, " << this->cache_seconds
+      << " s spent in the cache\n";
+  return out.str();
+}
+
+std::optional<std::string> build_fingerprint() {
+  std::error_code error;
+  auto path = std::filesystem::read_symlink("/proc/self/exe", error);
+  if (error) {
+    return std::nullopt;
+  }
+  auto size = std::filesystem::file_size(path, error);
+  if (error) {
+    return std::nullopt;
+  }
+  auto time = std::filesystem::last_write_time(path, error);
+  if (error) {
+    return std::nullopt;
+  }
+  return std::to_string(size) + " " +
+         std::to_string(time.time_since_epoch().count());
+}
+
+std::string relocate_id_space(
+  const std::string& text,
+  const std::string& from,
+  const std::string& to
+) {
+  auto is_digit = [](char c) { return c >= '0' && c <= '9'; };
+
+  std::string result;
+  result.reserve(text.size());
+
+  size_t i = 0;
+  while (i < text.size()) {
+    // The space of an ID is a whole run of digits followed by a dot and the
+    // local index, so e.g. `13.2` and the local index of `3.1` are left
+    // alone for the space `1`.
+    if (text.compare(i, from.size(), from) == 0 &&
+        (i == 0 || (!is_digit(text[i - 1]) && text[i - 1] != '.')) &&
+        i + from.size() + 1 < text.size() && text[i + from.size()] == '.' &&
+        is_digit(text[i + from.size() + 1])) {
+      result += to;
+      i += from.size();
+      continue;
+    }
+    result.push_back(text[i]);
+    i++;
+  }
+  return result;
+}
+
+uint64_t fnv1a_hash(std::string_view text) {
+  uint64_t hash = 0xcbf29ce484222325;
+  for (unsigned char c : text) {
+    hash ^= c;
+    hash *= 0x100000001b3;
+  }
+  return hash;
+}
+
+}  // namespace syc
@@ -0,0 +1,115 @@
+#ifndef SYC_COMPILE_CACHE_H_
+#define SYC_COMPILE_CACHE_H_
+
+#include <filesystem>
+
+#include "common.h"
+
+namespace syc {
+
+/// Assembly of a function in the cache.
+struct CacheEntry {
+  /// Assembly of the function, with its own ID space written as `$`.
+  std::string text;
+  /// Seconds the backend spent on the function when it was compiled.
+  double seconds;
+};
+
+/// Hits, misses and time saved by the compile cache, added up over the
+/// compilations of a batch.
+struct CacheCounts {
+  size_t hit_count = 0;
+  size_t miss_count = 0;
+  size_t store_count = 0;
+  /// Backend seconds recorded in the entries of the hits.
+  double saved_seconds = 0;
+  /// Seconds spent reading and writing the entries.
+  double cache_seconds = 0;
+
+  /// Add the counts of another compilation.
+  void add(const CacheCounts& other);
+
+  /// Format the hits, the misses and the time saved.
+  std::string report() const;
+};
+
+/// On-disk cache of the assembly of each function.
+///
+/// The backend lowers, optimizes and allocates every function on its own, so
+/// the assembly of a function only depends on its optimized IR, the globals it
+/// may refer to, the options and the build of syc. These make up the key of the
+/// function, and each entry is a file in the cache directory named by the hash
+/// of the key. The entry holds the whole key, which is compared on a hit, so a
+/// hash collision is only a miss.
+///
+/// The key is taken after the IR passes and not right after irgen: inlining,
+/// the purity and return value optimizations, global2local and store_elim all
+/// look at other functions, so the same irgen output of a function can be
+/// optimized differently in another module. The IR passes always run, and a
+/// hit skips the backend of the function.
+///
+/// IDs are printed with the ID space of their function, which depends on the
+/// position of the function in the module, so the space of the function is
+/// written as `$` in the key and in the entry and put back on a hit.
+struct CompileCache {
+  /// First line of an entry, bumped when the format of the entries changes.
+  static constexpr const char* ENTRY_MAGIC = "syc-compile-cache 1";
+
+  /// Directory of the entries.
+  std::filesystem::path directory;
+  /// Build of syc and the options, the first line of every key.
+  std::string config;
+
+  /// Keys of the functions missed by `fetch_cached_functions`.
+  std::map<std::string, std::string> missed_key_map;
+
+  CacheCounts counts;
+
+  CompileCache(std::filesystem::path directory, std::string config);
+
+  /// Look up every function of the backend. The assembly of the hits is put
+  /// into the cached function table of the backend and the functions are
+  /// removed from the function table, so no backend pass sees them.
+  void fetch_cached_functions(
+    ir::Context& ir_context,
+    backend::Context& asm_context
+  );
+
+  /// Store the assembly of the missed functions with the seconds the backend
+  /// spent on each of them.
+  void store_missed_functions(
+    backend::Context& asm_context,
+    const std::map<std::string, double>& seconds_map
+  );
+
+  /// Path of the entry of a key.
+  std::filesystem::path entry_path(const std::string& key) const;
+
+  /// Read the entry of a key, none if there is no entry for the exact key.
+  std::optional<CacheEntry> lookup(const std::string& key);
+
+  /// Write the entry of a key. Entries are written to a temporary file named
+  /// after the process and the thread and renamed, so concurrent compilations
+  /// never see a partial entry. Failures are ignored, the cache is only an
+  /// optimization.
+  void store(const std::string& key, const CacheEntry& entry);
+};
+
+/// Identify the running build of syc by the size and the modification time of
+/// the executable, none if the executable cannot be found.
+std::optional<std::string> build_fingerprint();
+
+/// Replace the ID space `from` in the IDs of a text by `to`. An ID is written
+/// as the space, a dot and the local index, e.g. `3.14`.
+std::string relocate_id_space(
+  const std::string& text,
+  const std::string& from,
+  const std::string& to
+);
+
+/// 64-bit FNV-1a hash, stable across builds and platforms.
+uint64_t fnv1a_hash(std::string_view text);
+
+}  // namespace syc
+
+#endif
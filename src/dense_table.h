@@ -0,0 +1,229 @@
+#ifndef SYC_DENSE_TABLE_H_
+#define SYC_DENSE_TABLE_H_
+
+#include <array>
+
+#include "common.h"
+
+namespace syc {
+
+/// IDs are split into an ID space and a local index within the space.
+///
+/// Each space has its own counters, e.g. every IR function has one, so the IDs
+/// of a function only depend on the function itself and not on the order the
+/// functions are built in. Space 0 holds everything that is not allocated for
+/// a particular space.
+constexpr size_t ID_SPACE_SHIFT = 32;
+constexpr size_t ID_LOCAL_MASK = (size_t(1) << ID_SPACE_SHIFT) - 1;
+
+/// Pack a space and a local index into an ID.
+inline size_t make_id(size_t space, size_t local) {
+  return (space << ID_SPACE_SHIFT) | local;
+}
+
+/// Get the space of an ID.
+inline size_t id_space_of(size_t id) {
+  return id >> ID_SPACE_SHIFT;
+}
+
+/// Get the local index of an ID.
+inline size_t id_local_of(size_t id) {
+  return id & ID_LOCAL_MASK;
+}
+
+/// Format an ID as `local` in space 0, or `space.local` otherwise.
+inline std::string id_to_string(size_t id) {
+  if (id_space_of(id) == 0) {
+    return std::to_string(id_local_of(id));
+  }
+  return std::to_string(id_space_of(id)) + "." +
+         std::to_string(id_local_of(id));
+}
+
+/// Table indexed by dense IDs.
+///
+/// IDs are handed out by monotonically increasing counters per space, so the
+/// entries of a space are stored in slots indexed by the local index. A slot
+/// holding a null pointer is either not registered yet or erased (a
+/// tombstone), so lookups are a few bounds checks and indexes. Iteration
+/// skips empty slots and visits the entries in increasing ID order, the same
+/// order as the `std::map` this replaces.
+///
+/// The slots of a space live in chunks of doubling sizes that are never moved
+/// once allocated. Looking up an existing entry is thus safe while another
+/// thread inserts into the same or another space, as long as spaces are only
+/// added with `reserve_space` while no other thread uses the table, and each
+/// space is only inserted into by one thread at a time.
+template <typename ID, typename Ptr>
+struct DenseTable {
+  /// Number of slots in the first chunk of a space, as a power of two.
+  static constexpr size_t FIRST_CHUNK_BITS = 6;
+  /// Number of chunks needed to cover all the local indices.
+  static constexpr size_t CHUNK_COUNT = ID_SPACE_SHIFT - FIRST_CHUNK_BITS + 1;
+
+  /// Slots of an ID space.
+  struct Space {
+    /// Chunk `k` holds `2^(FIRST_CHUNK_BITS + k)` slots.
+    std::array<std::unique_ptr<Ptr[]>, CHUNK_COUNT> chunk_list;
+    /// One past the largest local index inserted.
+    size_t slot_count = 0;
+    /// Number of non-empty slots.
+    size_t live_count = 0;
+  };
+
+  /// Spaces indexed by the space of the ID.
+  std::vector<Space> space_list;
+
+  /// Locate the chunk and the index in the chunk of a local index.
+  static std::pair<size_t, size_t> locate(size_t local) {
+    size_t biased = (local >> FIRST_CHUNK_BITS) + 1;
+    size_t chunk_index = 63 - __builtin_clzll(biased);
+    size_t chunk_begin = ((size_t(1) << chunk_index) - 1) << FIRST_CHUNK_BITS;
+    return {chunk_index, local - chunk_begin};
+  }
+
+  /// Get the slot of an ID, or null if the chunk is not allocated.
+  const Ptr* find_slot(ID id) const {
+    auto space = id_space_of(id);
+    if (space >= space_list.size()) {
+      return nullptr;
+    }
+    auto [chunk_index, index] = locate(id_local_of(id));
+    const auto& chunk = space_list[space].chunk_list[chunk_index];
+    return chunk ? &chunk[index] : nullptr;
+  }
+
+  /// Iterator over the non-empty slots before `limit`.
+  struct Iterator {
+    const DenseTable* table;
+    ID id;
+    ID limit;
+
+    Iterator(const DenseTable* table, ID id, ID limit)
+      : table(table), id(id), limit(limit) {
+      skip_empty();
+    }
+
+    /// Move to the next live entry, or to `limit` if there is none.
+    void skip_empty() {
+      while (id < limit && id_space_of(id) < table->space_list.size()) {
+        auto space = id_space_of(id);
+        if (id_local_of(id) >= table->space_list[space].slot_count) {
+          id = make_id(space + 1, 0);
+          continue;
+        }
+        if (table->contains(id)) {
+          return;
+        }
+        id++;
+      }
+      id = std::min(id, limit);
+    }
+
+    std::pair<ID, Ptr> operator*() const { return {id, (*table)[id]}; }
+
+    Iterator& operator++() {
+      id++;
+      skip_empty();
+      return *this;
+    }
+
+    bool operator==(const Iterator& other) const { return id == other.id; }
+    bool operator!=(const Iterator& other) const { return id != other.id; }
+  };
+
+  Iterator begin() const { return Iterator(this, 0, end_id()); }
+  Iterator end() const { return Iterator(this, end_id(), end_id()); }
+
+  /// One past the largest ID the table may hold.
+  ID end_id() const { return make_id(space_list.size(), 0); }
+
+  /// Entries of one ID space, in increasing ID order.
+  struct SpaceRange {
+    Iterator first;
+    Iterator last;
+
+    Iterator begin() const { return first; }
+    Iterator end() const { return last; }
+  };
+
+  /// Iterate over the entries of one ID space.
+  SpaceRange space_entries(size_t space) const {
+    auto limit = std::min(make_id(space + 1, 0), end_id());
+    auto first = std::min(make_id(space, 0), limit);
+    return {Iterator(this, first, limit), Iterator(this, limit, limit)};
+  }
+
+  /// Make sure the space exists, must not run concurrently with other users.
+  void reserve_space(size_t space) {
+    if (space >= space_list.size()) {
+      space_list.resize(space + 1);
+    }
+  }
+
+  /// If there is a live entry for the ID.
+  bool contains(ID id) const {
+    auto slot = find_slot(id);
+    return slot != nullptr && *slot != nullptr;
+  }
+
+  /// Insert or overwrite the entry of the ID.
+  void insert(ID id, Ptr ptr) {
+    auto space_index = id_space_of(id);
+    reserve_space(space_index);
+    auto& space = space_list[space_index];
+
+    auto local = id_local_of(id);
+    auto [chunk_index, index] = locate(local);
+    auto& chunk = space.chunk_list[chunk_index];
+    if (!chunk) {
+      chunk = std::make_unique<Ptr[]>(size_t(1)
+                                       << (FIRST_CHUNK_BITS + chunk_index));
+    }
+    space.slot_count = std::max(space.slot_count, local + 1);
+
+    auto& slot = chunk[index];
+    if (slot == nullptr && ptr != nullptr) {
+      space.live_count++;
+    } else if (slot != nullptr && ptr == nullptr) {
+      space.live_count--;
+    }
+    slot = std::move(ptr);
+  }
+
+  /// Leave a tombstone in the slot of the ID.
+  void erase(ID id) {
+    if (contains(id)) {
+      insert(id, nullptr);
+    }
+  }
+
+  /// Get the entry of the ID, or null if there is no such entry.
+  const Ptr& operator[](ID id) const {
+    static const Ptr null_ptr = nullptr;
+    auto slot = find_slot(id);
+    return slot != nullptr ? *slot : null_ptr;
+  }
+
+  /// Get the entry of the ID, throw if there is no such entry.
+  const Ptr& at(ID id) const {
+    auto slot = find_slot(id);
+    if (slot == nullptr || *slot == nullptr) {
+      throw std::out_of_range("ID not found in the table.");
+    }
+    return *slot;
+  }
+
+  /// Number of live entries.
+  size_t size() const {
+    size_t count = 0;
+    for (const auto& space : space_list) {
+      count += space.live_count;
+    }
+    return count;
+  }
+};
+
+}  // namespace syc
+
+#endif
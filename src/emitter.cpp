@@ -0,0 +1,46 @@
+#include "emitter.h"
+#include "dense_table.h"
+
+namespace syc {
+
+Emitter::Emitter() : sink(nullptr), capacity(0) {}
+
+Emitter::Emitter(std::ostream& sink, size_t capacity)
+  : sink(&sink), capacity(capacity) {
+  // A little more than the capacity, so the last piece does not grow it.
+  buffer.reserve(capacity + 256);
+}
+
+Emitter::~Emitter() {
+  flush();
+}
+
+Emitter& Emitter::hex(uint64_t value, int width, bool uppercase) {
+  auto [end, _] =
+    std::to_chars(scratch.data(), scratch.data() + scratch.size(), value, 16);
+  if (uppercase) {
+    std::transform(scratch.data(), end, scratch.data(), ::toupper);
+  }
+  *this << "0x";
+  for (auto i = end - scratch.data(); i < width; i++) {
+    *this << '0';
+  }
+  return *this << std::string_view(scratch.data(), end - scratch.data());
+}
+
+Emitter& Emitter::id(size_t id) {
+  if (id_space_of(id) != 0) {
+    *this << id_space_of(id) << '.';
+  }
+  return *this << id_local_of(id);
+}
+
+void Emitter::flush() {
+  if (sink == nullptr || buffer.empty()) {
+    return;
+  }
+  sink->write(buffer.data(), buffer.size());
+  buffer.clear();
+}
+
+}  // namespace syc
@@ -0,0 +1,100 @@
+#ifndef SYC_EMITTER_H_
+#define SYC_EMITTER_H_
+
+#include <array>
+#include <charconv>
+#include <string_view>
+
+#include "common.h"
+
+namespace syc {
+
+/// Buffered text output.
+///
+/// The assembly and the IR are written piece by piece into a buffer of fixed
+/// capacity, which is handed to the sink every time it fills up, so the output
+/// is never held in memory as a whole. Without a sink the buffer just grows,
+/// and `str` gives the text, which is how the `to_string` functions are
+/// implemented on top of the emitters.
+///
+/// Numbers are formatted into a small scratch buffer instead of temporary
+/// strings.
+struct Emitter {
+  /// Default capacity of the buffer before it is handed to the sink.
+  static constexpr size_t DEFAULT_CAPACITY = 1 << 16;
+
+  /// Where the text goes, or null to keep the text in the buffer.
+  std::ostream* sink;
+  /// Text not yet written to the sink.
+  std::string buffer;
+  /// Size at which the buffer is written to the sink.
+  size_t capacity;
+  /// Scratch space for formatting numbers.
+  std::array<char, 32> scratch;
+
+  /// Emit into memory.
+  Emitter();
+
+  /// Emit into a stream.
+  explicit Emitter(std::ostream& sink, size_t capacity = DEFAULT_CAPACITY);
+
+  Emitter(const Emitter&) = delete;
+  Emitter& operator=(const Emitter&) = delete;
+
+  ~Emitter();
+
+  Emitter& operator<<(std::string_view str) {
+    buffer.append(str);
+    maybe_flush();
+    return *this;
+  }
+
+  Emitter& operator<<(const char* str) {
+    return *this << std::string_view(str);
+  }
+
+  Emitter& operator<<(const std::string& str) {
+    return *this << std::string_view(str);
+  }
+
+  Emitter& operator<<(char c) {
+    buffer.push_back(c);
+    maybe_flush();
+    return *this;
+  }
+
+  /// Integers other than characters, formatted in the scratch buffer.
+  template <
+    typename T,
+    typename = std::enable_if_t<
+      std::is_integral_v<T> && !std::is_same_v<T, char> &&
+      !std::is_same_v<T, bool>>>
+  Emitter& operator<<(T value) {
+    auto [end, _] =
+      std::to_chars(scratch.data(), scratch.data() + scratch.size(), value);
+    return *this << std::string_view(scratch.data(), end - scratch.data());
+  }
+
+  /// Emit `0x` and the value in hex, zero-padded to `width` digits.
+  Emitter& hex(uint64_t value, int width = 0, bool uppercase = false);
+
+  /// Emit an ID as `id_to_string` does.
+  Emitter& id(size_t id);
+
+  /// Write the buffer to the sink.
+  void flush();
+
+  /// Text emitted so far, only for emitters without a sink.
+  std::string str() const { return buffer; }
+
+  /// Write the buffer to the sink if it is full.
+  void maybe_flush() {
+    if (sink != nullptr && buffer.size() >= capacity) {
+      flush();
+    }
+  }
+};
+
+}  // namespace syc
+
+#endif
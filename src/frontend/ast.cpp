@@ -84,7 +84,10 @@ void expr::InitializerList::set_type(TypePtr type, Driver& driver) {
       if (this->init_list.size() < length) {
         for (size_t i = this->init_list.size(); i < length; i++) {
           this->init_list.push_back(
-            create_constant_expr(create_zero_comptime_value(element_type))
+            create_constant_expr(
+              create_zero_comptime_value(element_type),
+              driver.compunit.expr_arena
+            )
           );
         }
       }
@@ -119,7 +122,9 @@ void expr::InitializerList::set_type(TypePtr type, Driver& driver) {
           // If the sub-array initializer list is full, create a element
           // initializer list expression from it.
           if (element_init_list.size() == element_total_length) {
-            auto init_expr = create_initializer_list_expr(element_init_list);
+            auto init_expr = create_initializer_list_expr(
+              element_init_list, driver.compunit.expr_arena
+            );
             std::get<expr::InitializerList>(init_expr->kind)
               .set_type(element_type, driver);
             new_init_list.push_back(init_expr);
@@ -130,7 +135,9 @@ void expr::InitializerList::set_type(TypePtr type, Driver& driver) {
       }
       // the element_init_list is not full.
       if (element_init_list.size() > 0) {
-        auto init_expr = create_initializer_list_expr(element_init_list);
+        auto init_expr = create_initializer_list_expr(
+          element_init_list, driver.compunit.expr_arena
+        );
         std::get<expr::InitializerList>(init_expr->kind)
           .set_type(element_type, driver);
         new_init_list.push_back(init_expr);
@@ -138,7 +145,8 @@ void expr::InitializerList::set_type(TypePtr type, Driver& driver) {
       }
       if (new_init_list.size() < length) {
         for (size_t i = new_init_list.size(); i < length; i++) {
-          auto init_expr = create_initializer_list_expr({});
+          auto init_expr =
+            create_initializer_list_expr({}, driver.compunit.expr_arena);
           std::get<expr::InitializerList>(init_expr->kind)
             .set_type(element_type, driver);
           new_init_list.push_back(init_expr);
@@ -270,20 +278,22 @@ std::optional<stmt::Block> Stmt::as_block() const {
   return std::get<stmt::Block>(this->kind);
 }
 
-Compunit::Compunit() : symtable(create_symbol_table(std::nullopt)), stmts({}) {}
+Compunit::Compunit() : symtable(create_symbol_table()), stmts({}) {}
 
-ExprPtr create_initializer_list_expr(std::vector<ExprPtr> init_list) {
-  return std::make_shared<Expr>(ExprKind(expr::InitializerList{
-    init_list, nullptr}));
+ExprPtr create_initializer_list_expr(
+  std::vector<ExprPtr> init_list,
+  ExprArena& arena
+) {
+  return arena.create(ExprKind(expr::InitializerList{init_list, nullptr}));
 }
 
-ExprPtr create_identifier_expr(SymbolEntryPtr symbol_entry) {
-  return std::make_shared<Expr>(ExprKind(expr::Identifier{
+ExprPtr create_identifier_expr(SymbolEntryPtr symbol_entry, ExprArena& arena) {
+  return arena.create(ExprKind(expr::Identifier{
     symbol_entry->name, symbol_entry}));
 }
 
-ExprPtr create_constant_expr(ComptimeValuePtr value) {
-  return std::make_shared<Expr>(ExprKind(expr::Constant{value}));
+ExprPtr create_constant_expr(ComptimeValuePtr value, ExprArena& arena) {
+  return arena.create(ExprKind(expr::Constant{value}));
 }
 
 ExprPtr
@@ -427,7 +437,10 @@ create_binary_expr(BinaryOp op, ExprPtr lhs, ExprPtr rhs, Driver& driver) {
     if (*lhs_expr == *rhs_expr) {
       auto new_int = create_comptime_value(lhs_int + rhs_int, type.value());
       return create_binary_expr(
-        BinaryOp::Mul, create_constant_expr(new_int), lhs_expr, driver
+        BinaryOp::Mul,
+        create_constant_expr(new_int, driver.compunit.expr_arena),
+        lhs_expr,
+        driver
       );
     }
   }
@@ -438,7 +451,7 @@ create_binary_expr(BinaryOp op, ExprPtr lhs, ExprPtr rhs, Driver& driver) {
 
   symtable->add_symbol_entry(symbol_entry);
 
-  return std::make_shared<Expr>(ExprKind(expr::Binary{
+  return driver.compunit.expr_arena.create(ExprKind(expr::Binary{
     op, lhs, rhs, symbol_entry}));
 }
 
@@ -456,20 +469,24 @@ ExprPtr create_unary_expr(UnaryOp op, ExprPtr expr, Driver& driver) {
       Scope::Temp, symbol_name, create_int_type(), false, std::nullopt
     );
     symtable->add_symbol_entry(symbol_entry);
-    return std::make_shared<Expr>(ExprKind(expr::Unary{op, expr, symbol_entry})
+    return driver.compunit.expr_arena.create(
+      ExprKind(expr::Unary{op, expr, symbol_entry})
     );
   } else if (type->is_int() || type->is_float()) {
     if (op == UnaryOp::LogicalNot) {
       // expr is int/float: !expr -> expr == 0
-      auto zero = create_constant_expr(create_zero_comptime_value(type));
+      auto zero = create_constant_expr(
+        create_zero_comptime_value(type), driver.compunit.expr_arena
+      );
       return create_binary_expr(BinaryOp::Eq, expr, zero, driver);
     } else {
       auto symbol_entry = create_symbol_entry(
         Scope::Temp, symbol_name, type, false, std::nullopt
       );
       symtable->add_symbol_entry(symbol_entry);
-      return std::make_shared<Expr>(ExprKind(expr::Unary{op, expr, symbol_entry}
-      ));
+      return driver.compunit.expr_arena.create(
+        ExprKind(expr::Unary{op, expr, symbol_entry})
+      );
     }
   } else {
     throw std::runtime_error(
@@ -514,7 +531,7 @@ ExprPtr create_call_expr(
 
   symtable->add_symbol_entry(symbol_entry);
 
-  return std::make_shared<Expr>(ExprKind(expr::Call{
+  return driver.compunit.expr_arena.create(ExprKind(expr::Call{
     func_symbol, args, symbol_entry}));
 }
 
@@ -526,8 +543,10 @@ ExprPtr create_cast_expr(ExprPtr expr, TypePtr type, Driver& driver) {
   // int/float -> bool cast
   if (type->is_bool()) {
     if (expr->get_type()->is_float() || expr->get_type()->is_int()) {
-      auto zero =
-        create_constant_expr(create_zero_comptime_value(expr->get_type()));
+      auto zero = create_constant_expr(
+        create_zero_comptime_value(expr->get_type()),
+        driver.compunit.expr_arena
+      );
       return create_binary_expr(BinaryOp::Ne, expr, zero, driver);
     } else {
       throw std::runtime_error("Error: cannot cast non-numeric type to bool.");
@@ -543,11 +562,13 @@ ExprPtr create_cast_expr(ExprPtr expr, TypePtr type, Driver& driver) {
 
   symtable->add_symbol_entry(symbol_entry);
 
-  return std::make_shared<Expr>(ExprKind(expr::Cast{expr, type, symbol_entry}));
+  return driver.compunit.expr_arena.create(
+    ExprKind(expr::Cast{expr, type, symbol_entry})
+  );
 }
 
-StmtPtr create_blank_stmt() {
-  return std::make_shared<Stmt>(StmtKind(stmt::Blank{}));
+StmtPtr create_blank_stmt(StmtArena& arena) {
+  return arena.create(StmtKind(stmt::Blank{}));
 }
 
 StmtPtr create_return_stmt(std::optional<ExprPtr> maybe_expr, Driver& driver) {
@@ -561,15 +582,15 @@ StmtPtr create_return_stmt(std::optional<ExprPtr> maybe_expr, Driver& driver) {
     }
     maybe_expr = std::make_optional(expr);
   }
-  return std::make_shared<Stmt>(StmtKind(stmt::Return{maybe_expr}));
+  return driver.compunit.stmt_arena.create(StmtKind(stmt::Return{maybe_expr}));
 }
 
-StmtPtr create_break_stmt() {
-  return std::make_shared<Stmt>(StmtKind(stmt::Break{}));
+StmtPtr create_break_stmt(StmtArena& arena) {
+  return arena.create(StmtKind(stmt::Break{}));
 }
 
-StmtPtr create_continue_stmt() {
-  return std::make_shared<Stmt>(StmtKind(stmt::Continue{}));
+StmtPtr create_continue_stmt(StmtArena& arena) {
+  return arena.create(StmtKind(stmt::Continue{}));
 }
 
 StmtPtr create_if_stmt(
@@ -582,7 +603,7 @@ StmtPtr create_if_stmt(
   if (!cond->get_type()->is_bool()) {
     cond = create_cast_expr(cond, create_bool_type(), driver);
   }
-  return std::make_shared<Stmt>(StmtKind(stmt::If{
+  return driver.compunit.stmt_arena.create(StmtKind(stmt::If{
     cond, then_stmt, maybe_else_stmt}));
 }
 
@@ -591,19 +612,20 @@ StmtPtr create_while_stmt(ExprPtr cond, StmtPtr body, Driver& driver) {
   if (!cond->get_type()->is_bool()) {
     cond = create_cast_expr(cond, create_bool_type(), driver);
   }
-  return std::make_shared<Stmt>(StmtKind(stmt::While{cond, body}));
+  return driver.compunit.stmt_arena.create(StmtKind(stmt::While{cond, body}));
 }
 
-StmtPtr create_block_stmt(SymbolTablePtr parent_symtable) {
-  auto symtable = create_symbol_table(parent_symtable);
-  return std::make_shared<Stmt>(StmtKind(stmt::Block{symtable, {}}));
+StmtPtr create_block_stmt(StmtArena& arena) {
+  auto symtable = create_symbol_table();
+  return arena.create(StmtKind(stmt::Block{symtable, {}}));
 }
 
 StmtPtr create_func_def_stmt(
   SymbolTablePtr parent_symtable,
   TypePtr ret_type,
   std::string name,
-  std::vector<std::tuple<TypePtr, std::string>> params
+  std::vector<std::tuple<TypePtr, std::string>> params,
+  StmtArena& arena
 ) {
   std::vector<TypePtr> param_types;
   std::vector<std::string> param_names;
@@ -620,28 +642,27 @@ StmtPtr create_func_def_stmt(
 
   auto func_type = create_function_type(ret_type, param_types);
 
-  auto symtable = create_symbol_table(parent_symtable);
+  auto symtable = create_symbol_table();
 
   auto symbol_entry =
     create_symbol_entry(Scope::Global, name, func_type, false, std::nullopt);
 
   parent_symtable->add_symbol_entry(symbol_entry);
 
-  for (auto [type, name] : params) {
-    if (type->is_array()) {
-      // pass array as pointer
-      auto element_type = type->get_element_type().value();
-      type = create_pointer_type(element_type);
-    }
-    auto symbol_entry =
-      create_symbol_entry(Scope::Param, name, type, false, std::nullopt);
+  std::vector<SymbolEntryPtr> param_entries;
+  for (size_t i = 0; i < param_names.size(); i++) {
+    auto symbol_entry = create_symbol_entry(
+      Scope::Param, param_names[i], param_types[i], false, std::nullopt
+    );
     symtable->add_symbol_entry(symbol_entry);
+    param_entries.push_back(symbol_entry);
   }
 
-  return std::make_shared<Stmt>(StmtKind(stmt::FuncDef{
+  return arena.create(StmtKind(stmt::FuncDef{
     symtable,
     symbol_entry,
     param_names,
+    param_entries,
     std::nullopt,
   }));
 }
@@ -649,20 +670,24 @@ StmtPtr create_func_def_stmt(
 StmtPtr create_decl_stmt(
   Scope scope,
   bool is_const,
-  std::vector<std::tuple<TypePtr, std::string, std::optional<ExprPtr>>> defs
+  std::vector<std::tuple<TypePtr, std::string, std::optional<ExprPtr>>> defs,
+  std::vector<SymbolEntryPtr> symbol_entries,
+  StmtArena& arena
 ) {
-  return std::make_shared<Stmt>(StmtKind(stmt::Decl{scope, is_const, defs}));
+  return arena.create(
+    StmtKind(stmt::Decl{scope, is_const, defs, symbol_entries})
+  );
 }
 
-StmtPtr create_expr_stmt(ExprPtr expr) {
-  return std::make_shared<Stmt>(StmtKind(stmt::Expr{expr}));
+StmtPtr create_expr_stmt(ExprPtr expr, StmtArena& arena) {
+  return arena.create(StmtKind(stmt::Expr{expr}));
 }
 
 StmtPtr create_assign_stmt(ExprPtr lhs, ExprPtr rhs, Driver& driver) {
   if (rhs->get_type() != lhs->get_type()) {
     rhs = create_cast_expr(rhs, lhs->get_type(), driver);
   }
-  return std::make_shared<Stmt>(StmtKind(stmt::Assign{lhs, rhs}));
+  return driver.compunit.stmt_arena.create(StmtKind(stmt::Assign{lhs, rhs}));
 }
 
 SymbolEntryPtr create_symbol_entry_from_decl_def(
@@ -701,6 +726,135 @@ void Compunit::add_stmt(StmtPtr stmt) {
   this->stmts.push_back(stmt);
 }
 
+void Compunit::count_nodes(CountList& count_list) const {
+  static const char* expr_kind_names[] = {
+    "identifier", "binary", "unary",           "call",
+    "constant",   "cast",   "initializer_list"};
+  static const char* stmt_kind_names[] = {
+    "blank",  "if",    "while", "break", "continue", "return",
+    "assign", "block", "expr",  "decl",  "func_def"};
+  static_assert(
+    std::size(expr_kind_names) == std::variant_size_v<ExprKind> &&
+    std::size(stmt_kind_names) == std::variant_size_v<StmtKind>
+  );
+
+  std::vector<size_t> expr_count_list(std::variant_size_v<ExprKind>, 0);
+  std::vector<size_t> stmt_count_list(std::variant_size_v<StmtKind>, 0);
+  size_t symtable_count = 0;
+  size_t symbol_entry_count = 0;
+
+  // Expressions may be shared, e.g. by the folded initializer lists.
+  std::unordered_set<const Expr*> visited_expr_set;
+
+  std::function<void(ExprPtr)> count_expr = [&](ExprPtr expr) {
+    if (!visited_expr_set.insert(expr).second) {
+      return;
+    }
+    expr_count_list[expr->kind.index()]++;
+    std::visit(
+      overloaded{
+        [&](const expr::Binary& kind) {
+          count_expr(kind.lhs);
+          count_expr(kind.rhs);
+        },
+        [&](const expr::Unary& kind) { count_expr(kind.expr); },
+        [&](const expr::Call& kind) {
+          for (auto arg : kind.args) {
+            count_expr(arg);
+          }
+        },
+        [&](const expr::Cast& kind) { count_expr(kind.expr); },
+        [&](const expr::InitializerList& kind) {
+          for (auto init : kind.init_list) {
+            count_expr(init);
+          }
+        },
+        [&](const auto& kind) {},
+      },
+      expr->kind
+    );
+  };
+
+  auto count_symtable = [&](SymbolTablePtr symtable) {
+    symtable_count++;
+    symbol_entry_count += symtable->entry_list.size();
+  };
+
+  std::function<void(StmtPtr)> count_stmt = [&](StmtPtr stmt) {
+    stmt_count_list[stmt->kind.index()]++;
+    std::visit(
+      overloaded{
+        [&](const stmt::If& kind) {
+          count_expr(kind.cond);
+          count_stmt(kind.then_stmt);
+          if (kind.maybe_else_stmt.has_value()) {
+            count_stmt(kind.maybe_else_stmt.value());
+          }
+        },
+        [&](const stmt::While& kind) {
+          count_expr(kind.cond);
+          count_stmt(kind.body);
+        },
+        [&](const stmt::Return& kind) {
+          if (kind.maybe_expr.has_value()) {
+            count_expr(kind.maybe_expr.value());
+          }
+        },
+        [&](const stmt::Assign& kind) {
+          count_expr(kind.lhs);
+          count_expr(kind.rhs);
+        },
+        [&](const stmt::Block& kind) {
+          count_symtable(kind.symtable);
+          for (auto stmt : kind.stmts) {
+            count_stmt(stmt);
+          }
+        },
+        [&](const stmt::Expr& kind) { count_expr(kind.expr); },
+        [&](const stmt::Decl& kind) {
+          for (const auto& [type, name, maybe_init] : kind.defs) {
+            if (maybe_init.has_value()) {
+              count_expr(maybe_init.value());
+            }
+          }
+        },
+        [&](const stmt::FuncDef& kind) {
+          count_symtable(kind.symtable);
+          if (kind.maybe_body.has_value()) {
+            count_stmt(kind.maybe_body.value());
+          }
+        },
+        [&](const auto& kind) {},
+      },
+      stmt->kind
+    );
+  };
+
+  count_symtable(this->symtable);
+  for (auto stmt : this->stmts) {
+    count_stmt(stmt);
+  }
+
+  for (size_t i = 0; i < expr_count_list.size(); i++) {
+    count_list.push_back(
+      {std::string("ast.expr.") + expr_kind_names[i], expr_count_list[i]}
+    );
+  }
+  for (size_t i = 0; i < stmt_count_list.size(); i++) {
+    count_list.push_back(
+      {std::string("ast.stmt.") + stmt_kind_names[i], stmt_count_list[i]}
+    );
+  }
+  count_list.push_back({"ast.symbol_tables", symtable_count});
+  count_list.push_back({"ast.symbol_entries", symbol_entry_count});
+  count_list.push_back({"ast.arena.exprs", this->expr_arena.size()});
+  count_list.push_back({"ast.arena.stmts", this->stmt_arena.size()});
+  count_list.push_back(
+    {"ast.arena_bytes",
+     this->expr_arena.reserved_bytes() + this->stmt_arena.reserved_bytes()}
+  );
+}
+
 Expr::Expr(ExprKind kind) {
   this->kind = kind;
   if (is_comptime() && 
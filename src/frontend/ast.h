@@ -1,6 +1,7 @@
 #ifndef SYC_FRONTEND_AST_H_
 #define SYC_FRONTEND_AST_H_
 
+#include "arena.h"
 #include "common.h"
 #include "frontend/comptime.h"
 
@@ -225,6 +226,8 @@ struct Decl {
   bool is_const;
   /// A declaration may contain multiple definitions.
   std::vector<std::tuple<TypePtr, std::string, std::optional<ExprPtr>>> defs;
+  /// Symbol entries of the definitions, in the same order.
+  std::vector<SymbolEntryPtr> symbol_entries;
 };
 
 /// Function definition.
@@ -237,6 +240,8 @@ struct FuncDef {
   SymbolEntryPtr symbol_entry;
   /// Parameter names.
   std::vector<std::string> param_names;
+  /// Symbol entries of the parameters, in the same order.
+  std::vector<SymbolEntryPtr> param_entries;
   /// A block statement.
   /// If the body is nullopt, the function is a declaration.
   /// e.g. functions in the runtime library.
@@ -259,12 +264,26 @@ struct Stmt {
   std::optional<stmt::Block> as_block() const;
 };
 
+/// Arena of the expressions of an AST.
+using ExprArena = Arena<Expr, 4096>;
+/// Arena of the statements of an AST.
+using StmtArena = Arena<Stmt, 4096>;
+
 /// Compile unit.
+///
+/// All the nodes of the AST are owned by the arenas of the compile unit and
+/// freed together with it, so nodes are referenced by plain pointers and may
+/// be shared between expressions. The `create_*` functions taking a driver
+/// allocate from the compile unit of the driver, the others take the arena.
 struct Compunit {
   /// Global symbols.
   SymbolTablePtr symtable;
   /// Items.
   std::vector<StmtPtr> stmts;
+  /// Expressions of the AST.
+  ExprArena expr_arena;
+  /// Statements of the AST.
+  StmtArena stmt_arena;
   /// Constructor.
   Compunit();
 
@@ -273,15 +292,18 @@ struct Compunit {
   void add_stmt(StmtPtr stmt);
 
   std::string to_string() const;
+
+  /// Count the live nodes by kind and the entries of the symbol tables.
+  void count_nodes(CountList& count_list) const;
 };
 
 /// Create an identifier expression from the corresponding symbol entry.
 /// When building the AST, symbol_entry can be looked up in the `curr_symtable`
 /// by driver using its name.
-ExprPtr create_identifier_expr(SymbolEntryPtr symbol_entry);
+ExprPtr create_identifier_expr(SymbolEntryPtr symbol_entry, ExprArena& arena);
 
 /// Create a constant expression.
-ExprPtr create_constant_expr(ComptimeValuePtr value);
+ExprPtr create_constant_expr(ComptimeValuePtr value, ExprArena& arena);
 
 /// Create a binary expression.
 /// `symbol_name` is the temporary name fetched from the driver.
@@ -306,18 +328,21 @@ ExprPtr create_call_expr(
 
 ExprPtr create_cast_expr(ExprPtr expr, TypePtr type, Driver& driver);
 
-ExprPtr create_initializer_list_expr(std::vector<ExprPtr> init_list);
+ExprPtr create_initializer_list_expr(
+  std::vector<ExprPtr> init_list,
+  ExprArena& arena
+);
 
-StmtPtr create_blank_stmt();
+StmtPtr create_blank_stmt(StmtArena& arena);
 
 /// Create a return statement.
 StmtPtr create_return_stmt(std::optional<ExprPtr> maybe_expr, Driver& driver);
 
 /// Create a break statement.
-StmtPtr create_break_stmt();
+StmtPtr create_break_stmt(StmtArena& arena);
 
 /// Create a continue statement.
-StmtPtr create_continue_stmt();
+StmtPtr create_continue_stmt(StmtArena& arena);
 
 /// Create an if statement.
 StmtPtr create_if_stmt(
@@ -331,7 +356,7 @@ StmtPtr create_if_stmt(
 StmtPtr create_while_stmt(ExprPtr cond, StmtPtr body, Driver& driver);
 
 /// Create a new block with no statements.
-StmtPtr create_block_stmt(SymbolTablePtr parent_symtable);
+StmtPtr create_block_stmt(StmtArena& arena);
 
 /// Create a new function definition with no statements.
 /// This will not create a new block. The body is handled by the driver.
@@ -339,17 +364,20 @@ StmtPtr create_func_def_stmt(
   SymbolTablePtr parent_symtable,
   TypePtr ret_type,
   std::string name,
-  std::vector<std::tuple<TypePtr, std::string>> params
+  std::vector<std::tuple<TypePtr, std::string>> params,
+  StmtArena& arena
 );
 
 /// Create a declaration statement.
 StmtPtr create_decl_stmt(
   Scope scope,
   bool is_const,
-  std::vector<std::tuple<TypePtr, std::string, std::optional<ExprPtr>>> defs
+  std::vector<std::tuple<TypePtr, std::string, std::optional<ExprPtr>>> defs,
+  std::vector<SymbolEntryPtr> symbol_entries,
+  StmtArena& arena
 );
 
-StmtPtr create_expr_stmt(ExprPtr expr);
+StmtPtr create_expr_stmt(ExprPtr expr, StmtArena& arena);
 
 StmtPtr create_assign_stmt(ExprPtr lhs, ExprPtr rhs, Driver& driver);
 
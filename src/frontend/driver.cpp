@@ -1,23 +1,32 @@
 #include "frontend/driver.h"
 
+#include <charconv>
+
 #include "frontend/generated/lexer.h"
 #include "frontend/generated/parser.h"
 
 namespace syc {
 namespace frontend {
 
-Driver::Driver(std::string filename) {
-  compunit = ast::Compunit();
+Driver::Driver(std::string filename, bool record_tokens)
+  : source_buffer(filename) {
   curr_block = nullptr;
   curr_function = nullptr;
   curr_symtable = compunit.symtable;
   next_temp_id = 0;
   tokens = "";
+  this->record_tokens = record_tokens;
   curr_decl_type = nullptr;
   is_curr_decl_const = false;
 
   yylex_init(&lexer);
-  yyset_in(fopen(filename.c_str(), "r"), lexer);
+  // The buffer is deleted by `yylex_destroy`, but the text is not ours to
+  // free.
+  if (yy_scan_buffer(
+        source_buffer.data, source_buffer.scan_size(), lexer
+      ) == nullptr) {
+    throw std::runtime_error("Error: cannot scan " + filename + ".");
+  }
   loc = new location();
   parser = new Parser(lexer, *loc, *this);
 
@@ -93,7 +102,7 @@ void Driver::add_block() {
     throw std::runtime_error("Cannot add a block in global scope.");
   }
 
-  ast::StmtPtr new_block = ast::create_block_stmt(this->curr_symtable);
+  ast::StmtPtr new_block = ast::create_block_stmt(this->compunit.stmt_arena);
 
   if (this->curr_block == nullptr) {
     // Set the block as the function's body.
@@ -105,6 +114,7 @@ void Driver::add_block() {
     std::get<ast::stmt::Block>(this->curr_block->kind).symtable;
 
   this->block_stack.push(this->curr_block);
+  this->scoped_symtable.push_scope();
 }
 
 void Driver::quit_block() {
@@ -116,6 +126,7 @@ void Driver::quit_block() {
   // std::cout << this->curr_symtable->to_string() << std::endl;
 
   this->block_stack.pop();
+  this->scoped_symtable.pop_scope();
 
   if (this->block_stack.empty()) {
     this->curr_block = nullptr;
@@ -137,13 +148,27 @@ void Driver::add_function(
     throw std::runtime_error("Cannot add a function in a local context.");
   }
 
-  auto new_function =
-    ast::create_func_def_stmt(this->curr_symtable, ret_type, name, params);
+  auto new_function = ast::create_func_def_stmt(
+    this->curr_symtable, ret_type, name, params, this->compunit.stmt_arena
+  );
 
   this->add_stmt(new_function);
   this->curr_function = new_function;
-  this->curr_symtable =
-    std::get<ast::stmt::FuncDef>(this->curr_function->kind).symtable;
+
+  const auto& func_def = std::get<ast::stmt::FuncDef>(new_function->kind);
+  this->curr_symtable = func_def.symtable;
+
+  // The function is visible in its own body, the parameters in a scope
+  // enclosing the body.
+  this->scoped_symtable.bind(
+    this->interner.intern(func_def.symbol_entry->name), func_def.symbol_entry
+  );
+  this->scoped_symtable.push_scope();
+  for (const auto& param_entry : func_def.param_entries) {
+    this->scoped_symtable.bind(
+      this->interner.intern(param_entry->name), param_entry
+    );
+  }
 }
 
 void Driver::quit_function() {
@@ -154,6 +179,10 @@ void Driver::quit_function() {
   while (!this->block_stack.empty()) {
     this->block_stack.pop();
   }
+  // Close the scope of the parameters and any block left open.
+  while (this->scoped_symtable.depth() > 0) {
+    this->scoped_symtable.pop_scope();
+  }
   this->curr_function = nullptr;
   this->curr_symtable = this->compunit.symtable;
 }
@@ -167,15 +196,47 @@ void Driver::add_function_decl(
   this->quit_function();
 }
 
+void Driver::declare_symbol(SymbolEntryPtr symbol_entry) {
+  this->scoped_symtable.bind(
+    this->interner.intern(symbol_entry->name), symbol_entry
+  );
+  this->curr_symtable->add_symbol_entry(symbol_entry);
+  this->curr_decl_entries.push_back(symbol_entry);
+}
+
+std::vector<SymbolEntryPtr> Driver::take_decl_entries() {
+  return std::move(this->curr_decl_entries);
+}
+
 void Driver::add_token(const std::string& token) {
   this->tokens += token + "\n";
 }
 
 std::string Driver::get_next_temp_name() {
-  std::stringstream buf;
-  buf << "__SYC_TEMP_" << this->next_temp_id;
-  next_temp_id++;
-  return buf.str();
+  return "__SYC_TEMP_" + std::to_string(this->next_temp_id++);
+}
+
+int parse_integer_literal(std::string_view lexeme) {
+  int base = 10;
+  if (lexeme.size() > 2 && lexeme[0] == '0' &&
+      (lexeme[1] == 'x' || lexeme[1] == 'X')) {
+    base = 16;
+    lexeme.remove_prefix(2);
+  } else if (lexeme.size() > 1 && lexeme[0] == '0') {
+    base = 8;
+    lexeme.remove_prefix(1);
+  }
+
+  int value = 0;
+  auto [end, error] =
+    std::from_chars(lexeme.data(), lexeme.data() + lexeme.size(), value, base);
+  if (error == std::errc::result_out_of_range) {
+    throw std::out_of_range("Error: integer literal out of range.");
+  }
+  if (error != std::errc() || end != lexeme.data() + lexeme.size()) {
+    throw std::invalid_argument("Error: invalid integer literal.");
+  }
+  return value;
 }
 
 }  // namespace frontend
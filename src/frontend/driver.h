@@ -5,6 +5,8 @@
 #include "frontend/ast.h"
 #include "frontend/comptime.h"
 #include "frontend/generated/parser.h"
+#include "frontend/source_buffer.h"
+#include "frontend/symtable.h"
 
 namespace syc {
 
@@ -22,8 +24,12 @@ struct Driver {
   ast::StmtPtr curr_block;
   /// Current function.
   ast::StmtPtr curr_function;
-  /// Current symbol table.
+  /// Current symbol table, where the entries of the current scope are kept.
   SymbolTablePtr curr_symtable;
+  /// Identifiers interned by the lexer.
+  Interner interner;
+  /// Symbols visible at the current point of the parse.
+  ScopedSymbolTable scoped_symtable;
 
   /// Stack of blocks.
   std::stack<ast::StmtPtr> block_stack;
@@ -31,8 +37,10 @@ struct Driver {
   size_t next_temp_id;
 
   /// All tokens in formatted string.
-  /// This is used mainly for debug.
+  /// This is used mainly for debug, and only recorded if `record_tokens`.
   std::string tokens;
+  /// If the lexer records the tokens.
+  bool record_tokens;
   /// Current type in declaration.
   TypePtr curr_decl_type;
   /// Current scope of declaration.
@@ -40,7 +48,11 @@ struct Driver {
   /// If current decl is const.
   /// This is set by the lexer.
   bool is_curr_decl_const;
+  /// Symbol entries of the definitions in the current decl.
+  std::vector<SymbolEntryPtr> curr_decl_entries;
 
+  /// The source file, scanned in place by the lexer.
+  SourceBuffer source_buffer;
   /// Lexer generated by flex.
   yyscan_t lexer;
   /// Location for bison/flex
@@ -49,7 +61,7 @@ struct Driver {
   Parser* parser;
 
   /// Constructor.
-  Driver(std::string filename = "");
+  Driver(std::string filename, bool record_tokens = false);
   /// Destructor.
   ~Driver();
 
@@ -84,6 +96,22 @@ struct Driver {
     std::vector<std::tuple<TypePtr, std::string>> params
   );
 
+  /// Declare a symbol of the current decl in the current scope.
+  void declare_symbol(SymbolEntryPtr symbol_entry);
+
+  /// Take the symbol entries of the current decl.
+  std::vector<SymbolEntryPtr> take_decl_entries();
+
+  /// Look up the visible symbol of an identifier.
+  std::optional<SymbolEntryPtr> lookup_symbol(SymbolID id) const {
+    return scoped_symtable.lookup(id);
+  }
+
+  /// Look up the global symbol of an identifier, e.g. a function.
+  std::optional<SymbolEntryPtr> lookup_global_symbol(SymbolID id) const {
+    return scoped_symtable.lookup_global(id);
+  }
+
   /// Add the token to `tokens`
   void add_token(const std::string& token);
 
@@ -91,6 +119,11 @@ struct Driver {
   std::string get_next_temp_name();
 };
 
+/// Parse an integer literal, in octal with a leading `0` and in hexadecimal
+/// with a leading `0x`. Throw `std::out_of_range` if it does not fit in an
+/// `int`.
+int parse_integer_literal(std::string_view lexeme);
+
 }  // namespace frontend
 
 }  // namespace syc
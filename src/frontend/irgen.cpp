@@ -4,21 +4,18 @@ namespace syc {
 
 void irgen(const AstCompunit& compunit, IrBuilder& builder) {
   for (auto stmt : compunit.stmts) {
-    irgen_stmt(stmt, compunit.symtable, builder);
+    irgen_stmt(stmt, builder);
   }
 }
 
-void irgen_stmt(
-  AstStmtPtr stmt,
-  AstSymbolTablePtr symtable,
-  IrBuilder& builder
-) {
+void irgen_stmt(AstStmtPtr stmt, IrBuilder& builder) {
   std::visit(
     overloaded{
-      [symtable, &builder](const frontend::ast::stmt::Decl& kind) {
+      [&builder](const frontend::ast::stmt::Decl& kind) {
         switch (kind.scope) {
           case frontend::Scope::Global: {
-            for (auto [ast_type, name, maybe_ast_expr] : kind.defs) {
+            for (size_t i = 0; i < kind.defs.size(); i++) {
+              auto [ast_type, name, maybe_ast_expr] = kind.defs[i];
               auto ir_type = irgen_type(ast_type, builder).value();
               auto is_constant_value = kind.is_const;
               IrOperandID ir_operand_id = 0; 
@@ -26,11 +23,10 @@ void irgen_stmt(
               if (maybe_ast_expr.has_value()) {
                 auto ast_expr = maybe_ast_expr.value();
                 if (!ast_expr->is_comptime()) {
-                  std::cerr
-                    << "Error: initial value of global variable/constant must "
-                       "be a constant expression."
-                    << std::endl;
-                  abort();
+                  throw std::runtime_error(
+                    "Error: initial value of global variable/constant must "
+                    "be a constant expression."
+                  );
                 }
                 auto ir_constant = irgen_comptime_value(
                   ast_expr->get_comptime_value().value(), builder
@@ -50,22 +46,13 @@ void irgen_stmt(
                   ir_type, name, is_constant_value, ir_init_operand_id
                 );
               }
-              auto maybe_symbol = symtable->lookup(name);
-
-              if (maybe_symbol.has_value()) {
-                auto symbol = maybe_symbol.value();
-                symbol->set_ir_operand_id(ir_operand_id);
-              } else {
-                std::string error_message =
-                  "Error: global symbol `" + name +
-                  "` is not found when generating IR.";
-                throw std::runtime_error(error_message);
-              }
+              kind.symbol_entries[i]->set_ir_operand_id(ir_operand_id);
             }
             break;
           }
           case frontend::Scope::Local: {
-            for (auto [ast_type, name, maybe_ast_expr] : kind.defs) {
+            for (size_t i = 0; i < kind.defs.size(); i++) {
+              auto [ast_type, name, maybe_ast_expr] = kind.defs[i];
               auto ir_type = irgen_type(ast_type, builder).value();
 
               auto ir_dst_operand_id = builder.fetch_arbitrary_operand(
@@ -73,24 +60,13 @@ void irgen_stmt(
               );
 
               auto alloca_instruction = builder.fetch_alloca_instruction(
-                ir_dst_operand_id, ir_type, std::nullopt, std::nullopt,
-                std::nullopt
+                ir_dst_operand_id, ir_type, std::nullopt
               );
 
               // alloca instructions are prepended to the current function.
               builder.prepend_instruction_to_curr_function(alloca_instruction);
 
-              auto maybe_symbol = symtable->lookup(name);
-
-              if (maybe_symbol.has_value()) {
-                auto symbol = maybe_symbol.value();
-                symbol->set_ir_operand_id(ir_dst_operand_id);
-              } else {
-                std::string error_message =
-                  "Error: local symbol `" + name +
-                  "` is not found when generating IR.";
-                throw std::runtime_error(error_message);
-              }
+              kind.symbol_entries[i]->set_ir_operand_id(ir_dst_operand_id);
 
               if (maybe_ast_expr.has_value()) {
                 auto ast_expr = maybe_ast_expr.value();
@@ -155,6 +131,9 @@ void irgen_stmt(
                   }
 
                   std::queue<AstExprPtr> ast_expr_queue;
+                  // The elements of the zero initializers are only needed
+                  // while the queue is drained.
+                  frontend::ast::ExprArena zero_expr_arena;
 
                   ast_expr_queue.push(ast_expr);
 
@@ -180,7 +159,9 @@ void irgen_stmt(
 
                           if (ast_elem_type->is_array()) {
                             sub_expr =
-                              frontend::ast::create_initializer_list_expr({});
+                              frontend::ast::create_initializer_list_expr(
+                                {}, zero_expr_arena
+                              );
 
                             std::get<frontend::ast::expr::InitializerList>(
                               sub_expr->kind
@@ -198,7 +179,7 @@ void irgen_stmt(
                               );
 
                             sub_expr = frontend::ast::create_constant_expr(
-                              ast_zero_constant
+                              ast_zero_constant, zero_expr_arena
                             );
                           }
 
@@ -212,7 +193,7 @@ void irgen_stmt(
                       }
                     } else {
                       auto ir_value_id =
-                        irgen_expr(ast_expr, symtable, builder, false).value();
+                        irgen_expr(ast_expr, builder, false).value();
 
                       if (memset_init) {
                         auto value = std::get_if<IrConstantPtr>(&builder.context.get_operand(ir_value_id)->kind);
@@ -274,7 +255,7 @@ void irgen_stmt(
                   }
                 } else {
                   auto ir_init_operand_id =
-                    irgen_expr(ast_expr, symtable, builder).value();
+                    irgen_expr(ast_expr, builder).value();
                   auto store_instruction = builder.fetch_store_instruction(
                     ir_init_operand_id, ir_dst_operand_id, std::nullopt
                   );
@@ -296,7 +277,6 @@ void irgen_stmt(
         auto symbol = kind.symbol_entry;
 
         std::string function_name = symbol->name;
-        std::vector<IrOperandID> parameter_id_list;
 
         auto ast_func_type = symbol->type;
 
@@ -309,32 +289,27 @@ void irgen_stmt(
         auto ast_func_ret_type = ast_func_type->get_ret_type().value();
         auto ir_func_ret_type = irgen_type(ast_func_ret_type, builder).value();
 
-        // set the operand in the symbol to the parameter first.
-        for (auto param_name : kind.param_names) {
-          auto maybe_ast_param_symbol = kind.symtable->lookup(param_name);
+        // if the function is just a declaration.
+        bool is_declare = !kind.maybe_body.has_value();
 
-          if (!maybe_ast_param_symbol.has_value()) {
-            std::string error_messgae =
-              "Error: parameter `" + param_name + "` is not defined.";
-            throw std::runtime_error(error_messgae);
-          }
+        // The function is added first, so that the parameters are created in
+        // its ID space.
+        builder.add_function(function_name, {}, ir_func_ret_type, is_declare);
 
-          auto ast_param_symbol = maybe_ast_param_symbol.value();
+        // set the operand in the symbol to the parameter first.
+        for (size_t i = 0; i < kind.param_names.size(); i++) {
+          const auto& param_name = kind.param_names[i];
+          auto ast_param_symbol = kind.param_entries[i];
           auto ast_param_type = ast_param_symbol->type;
           auto ir_param_type = irgen_type(ast_param_type, builder).value();
           auto ir_param_operand_id =
             builder.fetch_parameter_operand(ir_param_type, param_name);
           ast_param_symbol->set_ir_operand_id(ir_param_operand_id);
-          parameter_id_list.push_back(ir_param_operand_id);
+          builder.curr_function->parameter_id_list.push_back(
+            ir_param_operand_id
+          );
         }
 
-        // if the function is just a declaration.
-        bool is_declare = !kind.maybe_body.has_value();
-
-        builder.add_function(
-          function_name, parameter_id_list, ir_func_ret_type, is_declare
-        );
-
         if (!is_declare) {
           auto ast_body = kind.maybe_body.value();
 
@@ -347,16 +322,7 @@ void irgen_stmt(
 
           // store all the argument/parameter to the memory and set the operand
           // id of the param symbol to the corresponding pointer.
-          for (auto param_name : kind.param_names) {
-            auto maybe_ast_param_symbol = kind.symtable->lookup(param_name);
-
-            if (!maybe_ast_param_symbol.has_value()) {
-              std::string error_messgae =
-                "Error: parameter `" + param_name + "` is not defined.";
-              throw std::runtime_error(error_messgae);
-            }
-
-            auto ast_param_symbol = maybe_ast_param_symbol.value();
+          for (auto ast_param_symbol : kind.param_entries) {
             auto ir_param_operand_id =
               ast_param_symbol->maybe_ir_operand_id.value();
             auto ir_param_operand =
@@ -367,8 +333,7 @@ void irgen_stmt(
             );
 
             auto alloca_instruction = builder.fetch_alloca_instruction(
-              ir_alloca_dst_id, ir_param_operand->type, std::nullopt,
-              std::nullopt, std::nullopt, true
+              ir_alloca_dst_id, ir_param_operand->type, std::nullopt, true
             );
 
             builder.prepend_instruction_to_curr_function(alloca_instruction);
@@ -395,7 +360,7 @@ void irgen_stmt(
 
             auto alloca_instruction = builder.fetch_alloca_instruction(
               builder.curr_function->maybe_return_operand_id.value(),
-              ir_func_ret_type, std::nullopt, std::nullopt, std::nullopt
+              ir_func_ret_type, std::nullopt
             );
 
             builder.prepend_instruction_to_curr_function(alloca_instruction);
@@ -436,7 +401,7 @@ void irgen_stmt(
 
           // generate the statements in the body
           for (const auto& stmt : ast_block.stmts) {
-            irgen_stmt(stmt, ast_block.symtable, builder);
+            irgen_stmt(stmt, builder);
           }
 
           builder.curr_function->add_terminators(builder);
@@ -445,14 +410,14 @@ void irgen_stmt(
       },
       [&builder](const frontend::ast::stmt::Block& kind) {
         for (auto stmt : kind.stmts) {
-          irgen_stmt(stmt, kind.symtable, builder);
+          irgen_stmt(stmt, builder);
         }
       },
-      [symtable, &builder](const frontend::ast::stmt::Assign& kind) {
+      [&builder](const frontend::ast::stmt::Assign& kind) {
         auto ir_lhs_operand_id =
-          irgen_expr(kind.lhs, symtable, builder, true).value();
+          irgen_expr(kind.lhs, builder, true).value();
         auto ir_rhs_operand_id =
-          irgen_expr(kind.rhs, symtable, builder, false).value();
+          irgen_expr(kind.rhs, builder, false).value();
 
         auto store_instruction = builder.fetch_store_instruction(
           ir_rhs_operand_id, ir_lhs_operand_id, std::nullopt
@@ -460,10 +425,10 @@ void irgen_stmt(
 
         builder.append_instruction(store_instruction);
       },
-      [symtable, &builder](const frontend::ast::stmt::Return& kind) {
+      [&builder](const frontend::ast::stmt::Return& kind) {
         if (kind.maybe_expr.has_value()) {
           auto ir_operand_id =
-            irgen_expr(kind.maybe_expr.value(), symtable, builder, false)
+            irgen_expr(kind.maybe_expr.value(), builder, false)
               .value();
           auto store_instruction = builder.fetch_store_instruction(
             ir_operand_id,
@@ -476,7 +441,7 @@ void irgen_stmt(
         );
         builder.append_instruction(br_instruction);
       },
-      [symtable, &builder](const frontend::ast::stmt::If& kind) {
+      [&builder](const frontend::ast::stmt::If& kind) {
         auto ir_then_basic_block = builder.fetch_basic_block();
         auto maybe_ir_else_basic_block =
           kind.maybe_else_stmt.has_value()
@@ -487,7 +452,7 @@ void irgen_stmt(
 
         // generate condition in the previous basic block.
         auto ir_cond_operand_id =
-          irgen_expr(kind.cond, symtable, builder, false).value();
+          irgen_expr(kind.cond, builder, false).value();
 
         // if the condition is true, jump to the then stmt.
         // otherwise, if there is an else stmt, jump to the else stmt, or jump
@@ -507,13 +472,13 @@ void irgen_stmt(
         if (maybe_block.has_value()) {
           auto block = maybe_block.value();
           for (auto stmt : block.stmts) {
-            irgen_stmt(stmt, block.symtable, builder);
+            irgen_stmt(stmt, builder);
             if (builder.curr_basic_block->has_terminator()) {
               break;
             }
           }
         } else {
-          irgen_stmt(kind.then_stmt, symtable, builder);
+          irgen_stmt(kind.then_stmt, builder);
         }
 
         if (!builder.curr_basic_block->has_terminator()) {
@@ -534,13 +499,13 @@ void irgen_stmt(
           if (maybe_block.has_value()) {
             auto block = maybe_block.value();
             for (auto stmt : block.stmts) {
-              irgen_stmt(stmt, block.symtable, builder);
+              irgen_stmt(stmt, builder);
               if (builder.curr_basic_block->has_terminator()) {
                 break;
               }
             }
           } else {
-            irgen_stmt(ast_else_stmt, symtable, builder);
+            irgen_stmt(ast_else_stmt, builder);
           }
           if (!builder.curr_basic_block->has_terminator()) {
             auto br_instruction =
@@ -553,7 +518,7 @@ void irgen_stmt(
         builder.append_basic_block(ir_tail_basic_block);
         builder.set_curr_basic_block(ir_tail_basic_block);
       },
-      [symtable, &builder](const frontend::ast::stmt::While& kind) {
+      [&builder](const frontend::ast::stmt::While& kind) {
         auto ir_cond_basic_block = builder.fetch_basic_block();
         auto ir_body_basic_block = builder.fetch_basic_block();
         auto ir_tail_basic_block = builder.fetch_basic_block();
@@ -564,7 +529,7 @@ void irgen_stmt(
         builder.append_basic_block(ir_cond_basic_block);
         builder.set_curr_basic_block(ir_cond_basic_block);
         auto ir_cond_operand_id =
-          irgen_expr(kind.cond, symtable, builder, false).value();
+          irgen_expr(kind.cond, builder, false).value();
         auto condbr_instruction = builder.fetch_condbr_instruction(
           ir_cond_operand_id, ir_body_basic_block->id, ir_tail_basic_block->id
         );
@@ -577,13 +542,13 @@ void irgen_stmt(
         if (maybe_block.has_value()) {
           auto block = maybe_block.value();
           for (auto stmt : block.stmts) {
-            irgen_stmt(stmt, block.symtable, builder);
+            irgen_stmt(stmt, builder);
             if (builder.curr_basic_block->has_terminator()) {
               break;
             }
           }
         } else {
-          irgen_stmt(kind.body, symtable, builder);
+          irgen_stmt(kind.body, builder);
         }
 
         if (!builder.curr_basic_block->has_terminator()) {
@@ -598,20 +563,20 @@ void irgen_stmt(
         builder.while_cond_basic_block_stack.pop();
         builder.while_tail_basic_block_stack.pop();
       },
-      [symtable, &builder](const frontend::ast::stmt::Break& kind) {
+      [&builder](const frontend::ast::stmt::Break& kind) {
         auto br_instruction = builder.fetch_br_instruction(
           builder.while_tail_basic_block_stack.top()->id
         );
         builder.append_instruction(br_instruction);
       },
-      [symtable, &builder](const frontend::ast::stmt::Continue& kind) {
+      [&builder](const frontend::ast::stmt::Continue& kind) {
         auto br_instruction = builder.fetch_br_instruction(
           builder.while_cond_basic_block_stack.top()->id
         );
         builder.append_instruction(br_instruction);
       },
-      [symtable, &builder](const frontend::ast::stmt::Expr& kind) {
-        irgen_expr(kind.expr, symtable, builder, false);
+      [&builder](const frontend::ast::stmt::Expr& kind) {
+        irgen_expr(kind.expr, builder, false);
       },
       [&builder](const auto&) {},
     },
@@ -619,12 +584,8 @@ void irgen_stmt(
   );
 }
 
-std::optional<IrOperandID> irgen_expr(
-  AstExprPtr expr,
-  AstSymbolTablePtr symtable,
-  IrBuilder& builder,
-  bool use_address
-) {
+std::optional<IrOperandID>
+irgen_expr(AstExprPtr expr, IrBuilder& builder, bool use_address) {
   return std::visit(
     overloaded{
       [&builder](const frontend::ast::expr::Constant& kind
@@ -634,7 +595,7 @@ std::optional<IrOperandID> irgen_expr(
           builder.fetch_operand(ir_constant->type, ir_constant);
         return ir_constant_operand_id;
       },
-      [symtable, &builder, use_address](const frontend::ast::expr::Binary& kind
+      [&builder, use_address](const frontend::ast::expr::Binary& kind
       ) -> std::optional<IrOperandID> {
         auto symbol = kind.symbol;
 
@@ -647,9 +608,9 @@ std::optional<IrOperandID> irgen_expr(
         switch (kind.op) {
           case AstBinaryOp::Add: {
             auto ir_lhs_operand_id =
-              irgen_expr(kind.lhs, symtable, builder, false).value();
+              irgen_expr(kind.lhs, builder, false).value();
             auto ir_rhs_operand_id =
-              irgen_expr(kind.rhs, symtable, builder, false).value();
+              irgen_expr(kind.rhs, builder, false).value();
 
             ir_dst_operand_id = builder.fetch_arbitrary_operand(
               irgen_type(ast_dst_type, builder).value()
@@ -670,9 +631,9 @@ std::optional<IrOperandID> irgen_expr(
           }
           case AstBinaryOp::Sub: {
             auto ir_lhs_operand_id =
-              irgen_expr(kind.lhs, symtable, builder, false).value();
+              irgen_expr(kind.lhs, builder, false).value();
             auto ir_rhs_operand_id =
-              irgen_expr(kind.rhs, symtable, builder, false).value();
+              irgen_expr(kind.rhs, builder, false).value();
 
             ir_dst_operand_id = builder.fetch_arbitrary_operand(
               irgen_type(ast_dst_type, builder).value()
@@ -693,9 +654,9 @@ std::optional<IrOperandID> irgen_expr(
           }
           case AstBinaryOp::Div: {
             auto ir_lhs_operand_id =
-              irgen_expr(kind.lhs, symtable, builder, false).value();
+              irgen_expr(kind.lhs, builder, false).value();
             auto ir_rhs_operand_id =
-              irgen_expr(kind.rhs, symtable, builder, false).value();
+              irgen_expr(kind.rhs, builder, false).value();
 
             ir_dst_operand_id = builder.fetch_arbitrary_operand(
               irgen_type(ast_dst_type, builder).value()
@@ -716,9 +677,9 @@ std::optional<IrOperandID> irgen_expr(
           }
           case AstBinaryOp::Mul: {
             auto ir_lhs_operand_id =
-              irgen_expr(kind.lhs, symtable, builder, false).value();
+              irgen_expr(kind.lhs, builder, false).value();
             auto ir_rhs_operand_id =
-              irgen_expr(kind.rhs, symtable, builder, false).value();
+              irgen_expr(kind.rhs, builder, false).value();
 
             ir_dst_operand_id = builder.fetch_arbitrary_operand(
               irgen_type(ast_dst_type, builder).value()
@@ -739,9 +700,9 @@ std::optional<IrOperandID> irgen_expr(
           }
           case AstBinaryOp::Mod: {
             auto ir_lhs_operand_id =
-              irgen_expr(kind.lhs, symtable, builder, false).value();
+              irgen_expr(kind.lhs, builder, false).value();
             auto ir_rhs_operand_id =
-              irgen_expr(kind.rhs, symtable, builder, false).value();
+              irgen_expr(kind.rhs, builder, false).value();
 
             ir_dst_operand_id = builder.fetch_arbitrary_operand(
               irgen_type(ast_dst_type, builder).value()
@@ -757,9 +718,9 @@ std::optional<IrOperandID> irgen_expr(
           }
           case AstBinaryOp::Lt: {
             auto ir_lhs_operand_id =
-              irgen_expr(kind.lhs, symtable, builder, false).value();
+              irgen_expr(kind.lhs, builder, false).value();
             auto ir_rhs_operand_id =
-              irgen_expr(kind.rhs, symtable, builder, false).value();
+              irgen_expr(kind.rhs, builder, false).value();
 
             ir_dst_operand_id = builder.fetch_arbitrary_operand(
               irgen_type(ast_dst_type, builder).value()
@@ -783,9 +744,9 @@ std::optional<IrOperandID> irgen_expr(
           }
           case AstBinaryOp::Le: {
             auto ir_lhs_operand_id =
-              irgen_expr(kind.lhs, symtable, builder, false).value();
+              irgen_expr(kind.lhs, builder, false).value();
             auto ir_rhs_operand_id =
-              irgen_expr(kind.rhs, symtable, builder, false).value();
+              irgen_expr(kind.rhs, builder, false).value();
 
             ir_dst_operand_id = builder.fetch_arbitrary_operand(
               irgen_type(ast_dst_type, builder).value()
@@ -809,9 +770,9 @@ std::optional<IrOperandID> irgen_expr(
           }
           case AstBinaryOp::Gt: {
             auto ir_lhs_operand_id =
-              irgen_expr(kind.lhs, symtable, builder, false).value();
+              irgen_expr(kind.lhs, builder, false).value();
             auto ir_rhs_operand_id =
-              irgen_expr(kind.rhs, symtable, builder, false).value();
+              irgen_expr(kind.rhs, builder, false).value();
 
             ir_dst_operand_id = builder.fetch_arbitrary_operand(
               irgen_type(ast_dst_type, builder).value()
@@ -835,9 +796,9 @@ std::optional<IrOperandID> irgen_expr(
           }
           case AstBinaryOp::Ge: {
             auto ir_lhs_operand_id =
-              irgen_expr(kind.lhs, symtable, builder, false).value();
+              irgen_expr(kind.lhs, builder, false).value();
             auto ir_rhs_operand_id =
-              irgen_expr(kind.rhs, symtable, builder, false).value();
+              irgen_expr(kind.rhs, builder, false).value();
 
             ir_dst_operand_id = builder.fetch_arbitrary_operand(
               irgen_type(ast_dst_type, builder).value()
@@ -861,9 +822,9 @@ std::optional<IrOperandID> irgen_expr(
           }
           case AstBinaryOp::Eq: {
             auto ir_lhs_operand_id =
-              irgen_expr(kind.lhs, symtable, builder, false).value();
+              irgen_expr(kind.lhs, builder, false).value();
             auto ir_rhs_operand_id =
-              irgen_expr(kind.rhs, symtable, builder, false).value();
+              irgen_expr(kind.rhs, builder, false).value();
 
             ir_dst_operand_id = builder.fetch_arbitrary_operand(
               irgen_type(ast_dst_type, builder).value()
@@ -887,9 +848,9 @@ std::optional<IrOperandID> irgen_expr(
           }
           case AstBinaryOp::Ne: {
             auto ir_lhs_operand_id =
-              irgen_expr(kind.lhs, symtable, builder, false).value();
+              irgen_expr(kind.lhs, builder, false).value();
             auto ir_rhs_operand_id =
-              irgen_expr(kind.rhs, symtable, builder, false).value();
+              irgen_expr(kind.rhs, builder, false).value();
 
             ir_dst_operand_id = builder.fetch_arbitrary_operand(
               irgen_type(ast_dst_type, builder).value()
@@ -917,8 +878,7 @@ std::optional<IrOperandID> irgen_expr(
               builder.fetch_pointer_type()
             );
             auto alloca_instruction = builder.fetch_alloca_instruction(
-              ir_dst_pointer_operand_id, builder.fetch_i1_type(), std::nullopt,
-              std::nullopt, std::nullopt
+              ir_dst_pointer_operand_id, builder.fetch_i1_type(), std::nullopt
             );
             builder.prepend_instruction_to_curr_function(alloca_instruction);
 
@@ -934,7 +894,7 @@ std::optional<IrOperandID> irgen_expr(
             // generate lhs with short-circuit evaluation.
             // lhs is generated in the previous basic block.
             auto ir_lhs_operand_id =
-              irgen_expr(kind.lhs, symtable, builder, true).value();
+              irgen_expr(kind.lhs, builder, true).value();
             // if lhs is true, evaluate the rhs, otherwise the result is false.
             auto condbr_instruction = builder.fetch_condbr_instruction(
               ir_lhs_operand_id, ir_rhs_basic_block->id,
@@ -946,7 +906,7 @@ std::optional<IrOperandID> irgen_expr(
             builder.append_basic_block(ir_rhs_basic_block);
             builder.set_curr_basic_block(ir_rhs_basic_block);
             auto ir_rhs_operand_id =
-              irgen_expr(kind.rhs, symtable, builder, true).value();
+              irgen_expr(kind.rhs, builder, true).value();
             // if rhs is true, the result is true, otherwise the result is
             // false.
             condbr_instruction = builder.fetch_condbr_instruction(
@@ -1000,8 +960,7 @@ std::optional<IrOperandID> irgen_expr(
               builder.fetch_pointer_type()
             );
             auto alloca_instruction = builder.fetch_alloca_instruction(
-              ir_dst_pointer_operand_id, builder.fetch_i1_type(), std::nullopt,
-              std::nullopt, std::nullopt
+              ir_dst_pointer_operand_id, builder.fetch_i1_type(), std::nullopt
             );
             builder.prepend_instruction_to_curr_function(alloca_instruction);
 
@@ -1017,7 +976,7 @@ std::optional<IrOperandID> irgen_expr(
             // generate lhs with short-circuit evaluation.
             // lhs is generated in the previous basic block.
             auto ir_lhs_operand_id =
-              irgen_expr(kind.lhs, symtable, builder, true).value();
+              irgen_expr(kind.lhs, builder, true).value();
             // if lhs is true, the result is true.
             // this is the only difference between logical and and logical or
             auto condbr_instruction = builder.fetch_condbr_instruction(
@@ -1029,7 +988,7 @@ std::optional<IrOperandID> irgen_expr(
             builder.append_basic_block(ir_rhs_basic_block);
             builder.set_curr_basic_block(ir_rhs_basic_block);
             auto ir_rhs_operand_id =
-              irgen_expr(kind.rhs, symtable, builder, true).value();
+              irgen_expr(kind.rhs, builder, true).value();
             // if rhs is true, the result is true, otherwise the result is
             // false.
             condbr_instruction = builder.fetch_condbr_instruction(
@@ -1084,11 +1043,11 @@ std::optional<IrOperandID> irgen_expr(
 
             if (ast_lhs_type->is_array()) {
               ir_lhs_operand_id =
-                irgen_expr(kind.lhs, symtable, builder, true).value();
+                irgen_expr(kind.lhs, builder, true).value();
               basis_type = irgen_type(ast_lhs_type, builder).value();
             } else if (ast_lhs_type->is_pointer()) {
               ir_lhs_operand_id =
-                irgen_expr(kind.lhs, symtable, builder, false).value();
+                irgen_expr(kind.lhs, builder, false).value();
               basis_type =
                 irgen_type(ast_lhs_type->get_value_type().value(), builder)
                   .value();
@@ -1099,7 +1058,7 @@ std::optional<IrOperandID> irgen_expr(
             }
 
             auto ir_rhs_operand_id =
-              irgen_expr(kind.rhs, symtable, builder, false).value();
+              irgen_expr(kind.rhs, builder, false).value();
 
             if (use_address) {
               ir_dst_operand_id =
@@ -1167,7 +1126,7 @@ std::optional<IrOperandID> irgen_expr(
         }
         return ir_dst_operand_id;
       },
-      [symtable, &builder,
+      [&builder,
        use_address](const frontend::ast::expr::Identifier& kind
       ) -> std::optional<IrOperandID> {
         auto ast_symbol = kind.symbol;
@@ -1195,13 +1154,13 @@ std::optional<IrOperandID> irgen_expr(
 
         return ir_operand_id;
       },
-      [symtable, &builder](const frontend::ast::expr::Cast& kind
+      [&builder](const frontend::ast::expr::Cast& kind
       ) -> std::optional<IrOperandID> {
         auto ast_from_type = kind.expr->get_type();
         auto ast_to_type = kind.type;
 
         auto ir_operand_id =
-          irgen_expr(kind.expr, symtable, builder, false).value();
+          irgen_expr(kind.expr, builder, false).value();
 
         IrOperandID ir_dst_operand_id;
 
@@ -1255,10 +1214,10 @@ std::optional<IrOperandID> irgen_expr(
         }
         return ir_dst_operand_id;
       },
-      [symtable, &builder](const frontend::ast::expr::Unary& kind
+      [&builder](const frontend::ast::expr::Unary& kind
       ) -> std::optional<IrOperandID> {
         auto ir_src_operand_id =
-          irgen_expr(kind.expr, symtable, builder, false).value();
+          irgen_expr(kind.expr, builder, false).value();
 
         IrOperandID ir_dst_operand_id;
 
@@ -1314,7 +1273,7 @@ std::optional<IrOperandID> irgen_expr(
         }
         return ir_dst_operand_id;
       },
-      [symtable, &builder](const frontend::ast::expr::Call& kind
+      [&builder](const frontend::ast::expr::Call& kind
       ) -> std::optional<IrOperandID> {
         auto ast_func_symbol = kind.func_symbol;
 
@@ -1340,7 +1299,7 @@ std::optional<IrOperandID> irgen_expr(
 
           IrOperandID ir_arg_id;
           if (arg->get_type()->is_pointer()) {
-            ir_arg_id = irgen_expr(arg, symtable, builder, false).value();
+            ir_arg_id = irgen_expr(arg, builder, false).value();
             if (arg->get_type() != param_type) {
               // If pointer types are not the same, perform a bitcast so the
               // type is compatible.
@@ -1352,7 +1311,7 @@ std::optional<IrOperandID> irgen_expr(
               ir_arg_id = ir_tmp_id;
             }
           } else if (arg->get_type()->is_array()) {
-            auto ir_arr_id = irgen_expr(arg, symtable, builder, true).value();
+            auto ir_arr_id = irgen_expr(arg, builder, true).value();
 
             auto ir_arg_type = builder.fetch_pointer_type(
             );
@@ -1385,7 +1344,7 @@ std::optional<IrOperandID> irgen_expr(
             }
 
           } else {
-            ir_arg_id = irgen_expr(arg, symtable, builder, false).value();
+            ir_arg_id = irgen_expr(arg, builder, false).value();
           }
           ir_arg_id_list.push_back(ir_arg_id);
         }
@@ -22,7 +22,6 @@ using AstExprPtr = frontend::ast::ExprPtr;
 using AstTypePtr = frontend::TypePtr;
 using AstScope = frontend::Scope;
 using AstSymbolEntryPtr = frontend::SymbolEntryPtr;
-using AstSymbolTablePtr = frontend::SymbolTablePtr;
 using AstComptimeValuePtr = frontend::ComptimeValuePtr;
 
 using IrBinaryOp = ir::instruction::BinaryOp;
@@ -39,21 +38,16 @@ using IrBasicBlockPtr = ir::BasicBlockPtr;
 
 void irgen(const AstCompunit& compunit, IrBuilder& builder);
 
-void irgen_stmt(
-  AstStmtPtr stmt,
-  AstSymbolTablePtr symtable,
-  IrBuilder& builder
-);
+/// Generate IR for statement.
+/// Names are resolved by the parser, so every identifier and declaration
+/// already refers to its symbol entry.
+void irgen_stmt(AstStmtPtr stmt, IrBuilder& builder);
 
 /// Generate IR for expression.
 /// `use_address` is used to decide if the value shall be loaded from the
 /// address or just get a pointer.
-std::optional<IrOperandID> irgen_expr(
-  AstExprPtr expr,
-  AstSymbolTablePtr symtable,
-  IrBuilder& builder,
-  bool use_address = false
-);
+std::optional<IrOperandID>
+irgen_expr(AstExprPtr expr, IrBuilder& builder, bool use_address = false);
 
 std::optional<IrTypePtr> irgen_type(AstTypePtr type, IrBuilder& builder);
 
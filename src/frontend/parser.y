@@ -49,7 +49,7 @@
 %token '+' '-' '*' '/' '%' '=' '[' ']' '(' ')' '{' '}' '!' ',' ';'
 %token LE GE EQ NE LOR LAND
 
-%token <std::string> IDENTIFIER 
+%token <SymbolID> IDENTIFIER 
 %token <ComptimeValuePtr> INTEGER FLOATING
 
 %token IF ELSE WHILE RETURN BREAK CONTINUE 
@@ -136,12 +136,12 @@ Stmt
 
 FuncDef 
   : Type IDENTIFIER '(' ')' {
-    driver.add_function($1, $2, {});
+    driver.add_function($1, driver.interner.get_name($2), {});
   } BlockStmt {
     driver.quit_function();
   }
   | Type IDENTIFIER '(' FuncParamList ')' {
-    driver.add_function($1, $2, $4);
+    driver.add_function($1, driver.interner.get_name($2), $4);
   } BlockStmt {
     driver.quit_function();
   }
@@ -149,23 +149,27 @@ FuncDef
 
 ExprStmt
   : Expr ';' {
-    $$ = ast::create_expr_stmt($1);
+    $$ = ast::create_expr_stmt($1, driver.compunit.stmt_arena);
   }
   ;
 
 DeclStmt
   : Type DefList ';' {
-    $$ = ast::create_decl_stmt(driver.curr_decl_scope, false, $2);
+    $$ = ast::create_decl_stmt(
+      driver.curr_decl_scope, false, $2, driver.take_decl_entries(),
+      driver.compunit.stmt_arena);
   }
   | CONST Type DefList ';' {
-    $$ = ast::create_decl_stmt(driver.curr_decl_scope, true, $3);
+    $$ = ast::create_decl_stmt(
+      driver.curr_decl_scope, true, $3, driver.take_decl_entries(),
+      driver.compunit.stmt_arena);
     driver.is_curr_decl_const = false;
   }
   ;
 
 DefList
   : DefList ',' Def {
-    $$ = $1;
+    $$ = std::move($1);
     $$.push_back($3);
 
     auto symbol_entry = ast::create_symbol_entry_from_decl_def(
@@ -173,7 +177,7 @@ DefList
       driver.is_curr_decl_const,
       $3
     );
-    driver.curr_symtable->add_symbol_entry(symbol_entry);
+    driver.declare_symbol(symbol_entry);
   }
   | Def {
     $$.push_back($1);
@@ -183,13 +187,14 @@ DefList
       driver.is_curr_decl_const,
       $1
     );
-    driver.curr_symtable->add_symbol_entry(symbol_entry);
+    driver.declare_symbol(symbol_entry);
   }
   ;
 
 Def 
   : IDENTIFIER {
-    $$ = std::make_tuple(driver.curr_decl_type, $1, std::nullopt);
+    $$ = std::make_tuple(
+      driver.curr_decl_type, driver.interner.get_name($1), std::nullopt);
   } 
   | IDENTIFIER ArrayIndices {
     TypePtr decl_type = driver.curr_decl_type;
@@ -208,7 +213,8 @@ Def
       ++curr_index_expr;
     }
 
-    $$ = std::make_tuple(decl_type, $1, std::nullopt);
+    $$ = std::make_tuple(
+      decl_type, driver.interner.get_name($1), std::nullopt);
   }
   | IDENTIFIER '=' InitVal {
     auto init_val = $3;
@@ -220,7 +226,7 @@ Def
     }
     $$ = std::make_tuple(
       driver.curr_decl_type, 
-      $1, 
+      driver.interner.get_name($1), 
       std::make_optional(init_val)
     );
   }
@@ -246,7 +252,8 @@ Def
       std::get<ast::expr::InitializerList>(init_val->kind)
         .set_type(decl_type, driver);
     }
-    $$ = std::make_tuple(decl_type, $1, std::make_optional(init_val));
+    $$ = std::make_tuple(
+      decl_type, driver.interner.get_name($1), std::make_optional(init_val));
   }
   ;
 
@@ -255,7 +262,7 @@ ArrayIndices
     $$ = { $2 };
   }
   | ArrayIndices '[' Expr ']' {
-    $$ = $1;
+    $$ = std::move($1);
     $$.push_back($3);
   }
   ;
@@ -265,10 +272,10 @@ InitVal
     $$ = $1;
   }
   | '{' '}' {
-    $$ = ast::create_initializer_list_expr({});
+    $$ = ast::create_initializer_list_expr({}, driver.compunit.expr_arena);
   }
   | '{' InitValList '}' {
-    $$ = ast::create_initializer_list_expr($2);
+    $$ = ast::create_initializer_list_expr($2, driver.compunit.expr_arena);
   }
   ;
 
@@ -277,7 +284,7 @@ InitValList
     $$.push_back($1);
   }
   | InitValList ',' InitVal {
-    $$ = $1;
+    $$ = std::move($1);
     $$.push_back($3);
   } 
   ;
@@ -308,13 +315,13 @@ ReturnStmt
 
 ContinueStmt 
   : CONTINUE ';' {
-    $$ = ast::create_continue_stmt();
+    $$ = ast::create_continue_stmt(driver.compunit.stmt_arena);
   }
   ;
 
 BreakStmt 
   : BREAK ';' {
-    $$ = ast::create_break_stmt();
+    $$ = ast::create_break_stmt(driver.compunit.stmt_arena);
   }
   ;
 
@@ -327,13 +334,13 @@ BlockStmt
   }
   | '{' '}' {
     // Just ignore.
-    $$ = ast::create_blank_stmt();
+    $$ = ast::create_blank_stmt(driver.compunit.stmt_arena);
   }
   ;
 
 BlankStmt 
   : ';' {
-    $$ = ast::create_blank_stmt();
+    $$ = ast::create_blank_stmt(driver.compunit.stmt_arena);
   }
   ;
 
@@ -358,21 +365,23 @@ PrimaryExpr
     $$ = $1;
   }
   | INTEGER {
-    $$ = ast::create_constant_expr($1);
+    $$ = ast::create_constant_expr($1, driver.compunit.expr_arena);
   }
   | FLOATING {
-    $$ = ast::create_constant_expr($1);
+    $$ = ast::create_constant_expr($1, driver.compunit.expr_arena);
   }
   ;
 
 LVal
   : IDENTIFIER {
-    auto maybe_symbol_entry = driver.curr_symtable->lookup($1);
+    auto maybe_symbol_entry = driver.lookup_symbol($1);
     if (!maybe_symbol_entry.has_value()) {
-      std::cerr << @1 << ":" << "Undefined identifier: " + $1;
+      std::cerr << @1 << ":"
+                << "Undefined identifier: " + driver.interner.get_name($1);
       YYABORT;
     }
-    $$ = ast::create_identifier_expr(maybe_symbol_entry.value());
+    $$ = ast::create_identifier_expr(
+      maybe_symbol_entry.value(), driver.compunit.expr_arena);
   }
   | LVal '[' Expr ']' {
     $$ = ast::create_binary_expr(
@@ -401,16 +410,18 @@ UnaryExpr
     $$ = ast::create_unary_expr(UnaryOp::LogicalNot, $2, driver);
   }
   | IDENTIFIER '(' FuncArgList ')' {
-    auto maybe_symbol_entry = driver.compunit.symtable->lookup($1);
+    auto maybe_symbol_entry = driver.lookup_global_symbol($1);
     if (!maybe_symbol_entry.has_value()) {
-      std::cerr << @1 << ":" << "Undefined identifier: " + $1;
+      std::cerr << @1 << ":"
+                << "Undefined identifier: " + driver.interner.get_name($1);
       YYABORT;
     }
     auto maybe_func_type = maybe_symbol_entry.value()->type;
     if (
       !std::holds_alternative<type::Function>(maybe_func_type->kind)
     ) {
-      std::cerr << @1 << ":" << "Not a function: " + $1;
+      std::cerr << @1 << ":"
+                << "Not a function: " + driver.interner.get_name($1);
       YYABORT;
     }
     $$ = ast::create_call_expr(
@@ -420,27 +431,30 @@ UnaryExpr
     );
   }
   | IDENTIFIER '(' ')' {
-    if ($1 == "starttime" || $1 == "stoptime") {
-      auto maybe_symbol_entry = driver.compunit.symtable->lookup("_sysy_" + $1);
+    const auto& name = driver.interner.get_name($1);
+    if (name == "starttime" || name == "stoptime") {
+      auto maybe_symbol_entry = driver.lookup_global_symbol(
+        driver.interner.intern("_sysy_" + name));
       int lineno = @1.end.line;
       auto lineno_expr = ast::create_constant_expr(
-        create_comptime_value(lineno, create_int_type()));
+        create_comptime_value(lineno, create_int_type()),
+        driver.compunit.expr_arena);
       $$ = ast::create_call_expr(
         maybe_symbol_entry.value(), 
         {lineno_expr}, 
         driver
       );
     } else {
-      auto maybe_symbol_entry = driver.compunit.symtable->lookup($1);
+      auto maybe_symbol_entry = driver.lookup_global_symbol($1);
       if (!maybe_symbol_entry.has_value()) {
-        std::cerr << @1 << ":" << "Undefined identifier: " + $1;
+        std::cerr << @1 << ":" << "Undefined identifier: " + name;
         YYABORT;
       }
       auto maybe_func_type = maybe_symbol_entry.value()->type;
       if (
         !std::holds_alternative<type::Function>(maybe_func_type->kind)
       ) {
-        std::cerr << @1 << ":" << "Not a function: " + $1;
+        std::cerr << @1 << ":" << "Not a function: " + name;
         YYABORT;
       }
       $$ = ast::create_call_expr(
@@ -545,7 +559,7 @@ FuncArgList
     $$.push_back($1);
   }
   | FuncArgList ',' Expr {
-    $$ = $1;
+    $$ = std::move($1);
     $$.push_back($3);
   }
   ;
@@ -555,14 +569,14 @@ FuncParamList
     $$.push_back($1);
   }
   | FuncParamList ',' FuncParam {
-    $$ = $1;
+    $$ = std::move($1);
     $$.push_back($3);
   }
   ;
 
 FuncParam
   : Type IDENTIFIER {
-    $$ = std::make_tuple($1, $2);
+    $$ = std::make_tuple($1, driver.interner.get_name($2));
   }
   | Type IDENTIFIER ArrayIndices {
     TypePtr type = $1;
@@ -581,10 +595,11 @@ FuncParam
       ++curr_index_expr;
     }
 
-    $$ = std::make_tuple(type, $2);
+    $$ = std::make_tuple(type, driver.interner.get_name($2));
   }
   | Type IDENTIFIER '[' ']' {
-    $$ = std::make_tuple(create_array_type($1, std::nullopt), $2);
+    $$ = std::make_tuple(
+      create_array_type($1, std::nullopt), driver.interner.get_name($2));
   }
   | Type IDENTIFIER '[' ']' ArrayIndices {
     TypePtr type = $1;
@@ -605,7 +620,7 @@ FuncParam
 
     type = create_array_type(type, std::nullopt);
 
-    $$ = std::make_tuple(type, $2);
+    $$ = std::make_tuple(type, driver.interner.get_name($2));
   }
   ;
 
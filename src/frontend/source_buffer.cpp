@@ -0,0 +1,61 @@
+#include "frontend/source_buffer.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace syc {
+namespace frontend {
+
+SourceBuffer::SourceBuffer(const std::string& filename)
+  : data(nullptr), size(0), mapped_size(0) {
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Error: cannot open " + filename + ".");
+  }
+
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    close(fd);
+    throw std::runtime_error("Error: cannot stat " + filename + ".");
+  }
+
+  size = file_stat.st_size;
+  size_t page_size = sysconf(_SC_PAGESIZE);
+  mapped_size = (size + 2 + page_size - 1) / page_size * page_size;
+
+  // Reserve zeroed pages for the file and the two zero bytes, then map the
+  // file over the start. The rest of the last page of the file reads as zero,
+  // and if the file ends on a page boundary the zeros come from the next page.
+  void* base = mmap(
+    nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+    -1, 0
+  );
+  if (base == MAP_FAILED) {
+    close(fd);
+    throw std::runtime_error("Error: cannot map " + filename + ".");
+  }
+  if (size > 0 && mmap(
+                    base, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED,
+                    fd, 0
+                  ) == MAP_FAILED) {
+    munmap(base, mapped_size);
+    close(fd);
+    throw std::runtime_error("Error: cannot map " + filename + ".");
+  }
+  close(fd);
+
+  data = static_cast<char*>(base);
+  // Sources are scanned once from the start to the end.
+  madvise(base, mapped_size, MADV_SEQUENTIAL);
+}
+
+SourceBuffer::~SourceBuffer() {
+  if (data != nullptr) {
+    munmap(data, mapped_size);
+  }
+}
+
+}  // namespace frontend
+}  // namespace syc
@@ -0,0 +1,44 @@
+#ifndef SYC_FRONTEND_SOURCE_BUFFER_H_
+#define SYC_FRONTEND_SOURCE_BUFFER_H_
+
+#include <string_view>
+
+#include "common.h"
+
+namespace syc {
+namespace frontend {
+
+/// Source file mapped into memory.
+///
+/// The file is mapped privately and followed by two zero bytes, which is the
+/// layout the flex scanner scans in place with `yy_scan_buffer`, so the source
+/// is never copied through stdio buffers. The scanner puts a zero after each
+/// lexeme while it is matched, so the pages are writable, and only the pages
+/// written are copied by the kernel.
+struct SourceBuffer {
+  /// Start of the text.
+  char* data;
+  /// Length of the text, without the two zero bytes.
+  size_t size;
+  /// Length of the whole mapping.
+  size_t mapped_size;
+
+  /// Map the file, throw if it cannot be read.
+  SourceBuffer(const std::string& filename);
+  /// Unmap the file.
+  ~SourceBuffer();
+
+  SourceBuffer(const SourceBuffer&) = delete;
+  SourceBuffer& operator=(const SourceBuffer&) = delete;
+
+  /// The text of the file.
+  std::string_view text() const { return std::string_view(data, size); }
+
+  /// Size of the buffer to give to `yy_scan_buffer`, with the zero bytes.
+  size_t scan_size() const { return size + 2; }
+};
+
+}  // namespace frontend
+}  // namespace syc
+
+#endif
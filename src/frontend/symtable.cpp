@@ -65,37 +65,87 @@ void SymbolEntry::set_ir_operand_id(ir::OperandID ir_operand_id) {
   this->maybe_ir_operand_id = ir_operand_id;
 }
 
-SymbolTablePtr create_symbol_table(std::optional<SymbolTablePtr> maybe_parent) {
-  auto table = std::make_shared<SymbolTable>();
-  table->maybe_parent = maybe_parent;
-  return table;
-}
-
-std::optional<SymbolEntryPtr>
-SymbolTable::lookup(const std::string& name, bool lookup_parent) {
-  auto it = table.find(name);
-  if (it != table.end()) {
-    return it->second;
-  }
-  if (lookup_parent && this->maybe_parent.has_value()) {
-    return this->maybe_parent.value()->lookup(name);
-  }
-  return std::nullopt;
+SymbolTablePtr create_symbol_table() {
+  return std::make_shared<SymbolTable>();
 }
 
 void SymbolTable::add_symbol_entry(SymbolEntryPtr symbol_entry) {
-  table[symbol_entry->name] = symbol_entry;
+  entry_list.push_back(symbol_entry);
 }
 
 std::string SymbolTable::to_string() const {
+  // Listed by name, as they used to be kept in a map.
+  std::vector<SymbolEntryPtr> sorted_entry_list = entry_list;
+  std::stable_sort(
+    sorted_entry_list.begin(), sorted_entry_list.end(),
+    [](const auto& lhs, const auto& rhs) { return lhs->name < rhs->name; }
+  );
+
   std::stringstream ss;
   ss << "SymbolTable: " << std::endl;
-  for (auto& [name, symbol_entry] : table) {
+  for (auto& symbol_entry : sorted_entry_list) {
     ss << "- " << symbol_entry->to_string() << std::endl;
   }
   return ss.str();
 }
 
+SymbolID Interner::intern(std::string_view name) {
+  auto it = id_map.find(name);
+  if (it != id_map.end()) {
+    return it->second;
+  }
+  SymbolID id = name_list.size();
+  name_list.emplace_back(name);
+  id_map.emplace(name_list.back(), id);
+  return id;
+}
+
+void ScopedSymbolTable::push_scope() {
+  scope_mark_list.push_back(undo_list.size());
+}
+
+void ScopedSymbolTable::pop_scope() {
+  if (scope_mark_list.empty()) {
+    throw std::runtime_error("Cannot pop the global scope.");
+  }
+  auto mark = scope_mark_list.back();
+  scope_mark_list.pop_back();
+  while (undo_list.size() > mark) {
+    auto& [id, shadowed_entry] = undo_list.back();
+    binding_list[id] = std::move(shadowed_entry);
+    undo_list.pop_back();
+  }
+}
+
+void ScopedSymbolTable::bind(SymbolID id, SymbolEntryPtr symbol_entry) {
+  if (id >= binding_list.size()) {
+    binding_list.resize(id + 1);
+    global_binding_list.resize(id + 1);
+  }
+  if (depth() == 0) {
+    // The global scope is never popped.
+    global_binding_list[id] = symbol_entry;
+  } else {
+    undo_list.push_back({id, binding_list[id]});
+  }
+  binding_list[id] = std::move(symbol_entry);
+}
+
+std::optional<SymbolEntryPtr> ScopedSymbolTable::lookup(SymbolID id) const {
+  if (id < binding_list.size() && binding_list[id] != nullptr) {
+    return binding_list[id];
+  }
+  return std::nullopt;
+}
+
+std::optional<SymbolEntryPtr> ScopedSymbolTable::lookup_global(SymbolID id
+) const {
+  if (id < global_binding_list.size() && global_binding_list[id] != nullptr) {
+    return global_binding_list[id];
+  }
+  return std::nullopt;
+}
+
 }  // namespace frontend
 
 }  // namespace syc
\ No newline at end of file
@@ -1,6 +1,10 @@
 #ifndef SYC_FRONTEND_SYMTABLE_H_
 #define SYC_FRONTEND_SYMTABLE_H_
 
+#include <deque>
+#include <string_view>
+#include <unordered_map>
+
 #include "common.h"
 #include "frontend/ast.h"
 #include "frontend/comptime.h"
@@ -57,21 +61,33 @@ struct SymbolEntry {
   void set_ir_operand_id(ir::OperandID ir_operand_id);
 };
 
-/// Symbol Table
-/// A symbol table is attached to the block, function or global context.
+/// Identifiers interned by the lexer.
+///
+/// Each distinct identifier gets a dense ID, so the scoped symbol table can
+/// be indexed by it instead of comparing strings.
+struct Interner {
+  /// Names by ID. A deque never moves its elements, so the keys of `id_map`
+  /// stay valid.
+  std::deque<std::string> name_list;
+  /// IDs by name, viewing into `name_list`.
+  std::unordered_map<std::string_view, SymbolID> id_map;
+
+  /// Get the ID of the name, adding it if it is new.
+  SymbolID intern(std::string_view name);
+
+  /// Get the name of an ID.
+  const std::string& get_name(SymbolID id) const { return name_list[id]; }
+
+  size_t size() const { return name_list.size(); }
+};
+
+/// Symbol entries declared in one scope, in declaration order.
+/// A symbol table is attached to the block, function or global context. It
+/// owns the entries and is used for display, names are resolved by the
+/// `ScopedSymbolTable` of the driver while parsing.
 struct SymbolTable {
-  /// Table, indexed by the name.
-  std::map<std::string, SymbolEntryPtr> table;
-  /// The parent table.
-  /// The hierarchy can be resolved while traversing the AST.
-  /// `parent` here is used for looking up the symbol.
-  std::optional<SymbolTablePtr> maybe_parent;
-
-  /// Lookup a symbol in the table by its name.
-  /// If the symbol is not found in the current table, the parent table will be
-  /// searched. Return nullopt if no symbol is found.
-  std::optional<SymbolEntryPtr>
-  lookup(const std::string& name, bool lookup_parent = true);
+  /// Entries, including the temporary ones.
+  std::vector<SymbolEntryPtr> entry_list;
 
   /// Add a symbol entry into the symbol table.
   void add_symbol_entry(SymbolEntryPtr symbol_entry);
@@ -79,6 +95,41 @@ struct SymbolTable {
   std::string to_string() const;
 };
 
+/// Flat table of the visible symbols while parsing.
+///
+/// The innermost visible entry of every identifier is kept in one array
+/// indexed by the symbol ID, so a lookup costs the same at any nesting depth.
+/// Binding an identifier saves the entry it shadows on an undo stack, and
+/// popping a scope restores the saved entries back to the mark of the scope.
+struct ScopedSymbolTable {
+  /// Visible entry of each symbol ID, null if none.
+  std::vector<SymbolEntryPtr> binding_list;
+  /// Entry of each symbol ID in the global scope, null if none.
+  std::vector<SymbolEntryPtr> global_binding_list;
+  /// Shadowed entries to restore, with their symbol IDs.
+  std::vector<std::pair<SymbolID, SymbolEntryPtr>> undo_list;
+  /// Size of `undo_list` when each open scope was pushed.
+  std::vector<size_t> scope_mark_list;
+
+  /// Open a nested scope.
+  void push_scope();
+
+  /// Close the innermost scope and restore what it shadowed.
+  void pop_scope();
+
+  /// Number of open scopes, 0 in the global scope.
+  size_t depth() const { return scope_mark_list.size(); }
+
+  /// Bind the symbol in the innermost scope.
+  void bind(SymbolID id, SymbolEntryPtr symbol_entry);
+
+  /// Get the visible entry of the symbol.
+  std::optional<SymbolEntryPtr> lookup(SymbolID id) const;
+
+  /// Get the entry of the symbol in the global scope.
+  std::optional<SymbolEntryPtr> lookup_global(SymbolID id) const;
+};
+
 /// Create a new symbol entry.
 SymbolEntryPtr create_symbol_entry(
   Scope scope,
@@ -89,9 +140,7 @@ SymbolEntryPtr create_symbol_entry(
 );
 
 /// Create a new symbol table.
-SymbolTablePtr create_symbol_table(
-  std::optional<SymbolTablePtr> maybe_parent = std::nullopt
-);
+SymbolTablePtr create_symbol_table();
 
 }  // namespace frontend
 }  // namespace syc
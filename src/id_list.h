@@ -0,0 +1,144 @@
+#ifndef SYC_ID_LIST_H_
+#define SYC_ID_LIST_H_
+
+#include <unordered_map>
+
+#include "common.h"
+
+namespace syc {
+
+/// Ordered list of IDs with constant time removal.
+///
+/// The list keeps the insertion order and allows duplicates, removing an ID
+/// removes all of its occurrences. Short lists are plain vectors. Once a list
+/// grows past `INDEX_THRESHOLD`, the positions of each ID are indexed and
+/// removal leaves tombstones instead of shifting the elements, so removing
+/// from the use list of a heavily used operand (e.g. `sp`) does not scan the
+/// whole list. Tombstones are compacted when they outnumber the live entries.
+template <typename ID>
+struct IdList {
+  static constexpr ID TOMBSTONE = std::numeric_limits<ID>::max();
+  static constexpr size_t INDEX_THRESHOLD = 16;
+
+  /// Entries in insertion order, may contain tombstones if indexed.
+  std::vector<ID> slot_list;
+  /// Number of entries that are not tombstones.
+  size_t live_count = 0;
+  /// Positions of the entries in `slot_list`, only built for long lists.
+  std::optional<std::unordered_map<ID, std::vector<size_t>>> maybe_index;
+
+  /// Iterator over the live entries.
+  struct Iterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = ID;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const ID*;
+    using reference = ID;
+
+    const ID* curr;
+    const ID* last;
+
+    Iterator(const ID* curr, const ID* last) : curr(curr), last(last) {
+      skip_tombstones();
+    }
+
+    void skip_tombstones() {
+      while (curr != last && *curr == TOMBSTONE) {
+        curr++;
+      }
+    }
+
+    ID operator*() const { return *curr; }
+
+    Iterator& operator++() {
+      curr++;
+      skip_tombstones();
+      return *this;
+    }
+
+    bool operator==(const Iterator& other) const { return curr == other.curr; }
+    bool operator!=(const Iterator& other) const { return curr != other.curr; }
+  };
+
+  Iterator begin() const {
+    return Iterator(slot_list.data(), slot_list.data() + slot_list.size());
+  }
+  Iterator end() const {
+    return Iterator(
+      slot_list.data() + slot_list.size(), slot_list.data() + slot_list.size()
+    );
+  }
+
+  size_t size() const { return live_count; }
+
+  bool empty() const { return live_count == 0; }
+
+  /// The first live entry.
+  ID front() const { return *begin(); }
+
+  /// If the ID is in the list.
+  bool contains(ID id) const {
+    if (maybe_index.has_value()) {
+      return maybe_index->count(id) > 0;
+    }
+    return std::find(slot_list.begin(), slot_list.end(), id) != slot_list.end();
+  }
+
+  /// Append an ID to the end of the list.
+  void push_back(ID id) {
+    slot_list.push_back(id);
+    live_count++;
+    if (maybe_index.has_value()) {
+      (*maybe_index)[id].push_back(slot_list.size() - 1);
+    } else if (live_count > INDEX_THRESHOLD) {
+      rebuild();
+    }
+  }
+
+  /// Remove all the occurrences of the ID.
+  void remove(ID id) {
+    if (!maybe_index.has_value()) {
+      auto new_end = std::remove(slot_list.begin(), slot_list.end(), id);
+      live_count -= slot_list.end() - new_end;
+      slot_list.erase(new_end, slot_list.end());
+      return;
+    }
+
+    auto it = maybe_index->find(id);
+    if (it == maybe_index->end()) {
+      return;
+    }
+    for (auto position : it->second) {
+      slot_list[position] = TOMBSTONE;
+    }
+    live_count -= it->second.size();
+    maybe_index->erase(it);
+
+    if (slot_list.size() - live_count > live_count) {
+      rebuild();
+    }
+  }
+
+  /// Copy the live entries, for iterating while the list is modified.
+  std::vector<ID> to_vector() const { return std::vector<ID>(begin(), end()); }
+
+  /// Drop the tombstones and rebuild the index if the list is still long.
+  void rebuild() {
+    slot_list.erase(
+      std::remove(slot_list.begin(), slot_list.end(), TOMBSTONE),
+      slot_list.end()
+    );
+    if (live_count <= INDEX_THRESHOLD) {
+      maybe_index.reset();
+      return;
+    }
+    maybe_index.emplace();
+    for (size_t position = 0; position < slot_list.size(); position++) {
+      (*maybe_index)[slot_list[position]].push_back(position);
+    }
+  }
+};
+
+}  // namespace syc
+
+#endif
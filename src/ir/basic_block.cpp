@@ -1,33 +1,52 @@
 #include "ir/basic_block.h"
 #include "ir/builder.h"
 #include "ir/context.h"
+#include "ir/function.h"
 #include "ir/instruction.h"
 
 namespace syc {
 namespace ir {
 
-BasicBlockPtr
-create_basic_block(BasicBlockID id, std::string parent_function_name) {
-  return std::make_shared<BasicBlock>(id, parent_function_name);
-}
-
-BasicBlockPtr create_dummy_basic_block() {
-  return std::make_shared<BasicBlock>(
-    std::numeric_limits<BasicBlockID>::max(), ""
-  );
-}
-
-BasicBlock::BasicBlock(BasicBlockID id, std::string parent_function_name)
-  : id(id), parent_function_name(parent_function_name), next(nullptr) {
-  this->head_instruction = create_dummy_instruction();
-  this->tail_instruction = create_dummy_instruction();
+BasicBlockPtr create_basic_block(
+  BasicBlockID id,
+  Function* parent_function,
+  Context& context
+) {
+  return context.get_id_space(id_space_of(id))
+    .basic_block_arena.create(id, parent_function);
+}
+
+BasicBlock::BasicBlock(BasicBlockID id, Function* parent_function)
+  : id(id),
+    parent_function(parent_function),
+    head_guard(
+      std::numeric_limits<InstructionID>::max(),
+      instruction::Dummy{},
+      std::numeric_limits<BasicBlockID>::max()
+    ),
+    tail_guard(
+      std::numeric_limits<InstructionID>::max(),
+      instruction::Dummy{},
+      std::numeric_limits<BasicBlockID>::max()
+    ),
+    next(nullptr),
+    prev(nullptr) {
+  this->head_instruction = &this->head_guard;
+  this->tail_instruction = &this->tail_guard;
 
   this->head_instruction->insert_next(this->tail_instruction);
 }
 
 void BasicBlock::insert_next(BasicBlockPtr basic_block) {
+  // Blocks are created in the space of their function, see `IdSpace`. The
+  // guards of the function have no space.
+  assert(
+    !this->parent_function ||
+    basic_block->id == std::numeric_limits<BasicBlockID>::max() ||
+    id_space_of(basic_block->id) == this->parent_function->id_space
+  );
   basic_block->next = this->next;
-  basic_block->prev = this->shared_from_this();
+  basic_block->prev = this;
 
   if (this->next) {
     this->next->prev = basic_block;
@@ -37,10 +56,15 @@ void BasicBlock::insert_next(BasicBlockPtr basic_block) {
 }
 
 void BasicBlock::insert_prev(BasicBlockPtr basic_block) {
-  basic_block->next = this->shared_from_this();
+  assert(
+    !this->parent_function ||
+    basic_block->id == std::numeric_limits<BasicBlockID>::max() ||
+    id_space_of(basic_block->id) == this->parent_function->id_space
+  );
+  basic_block->next = this;
   basic_block->prev = this->prev;
 
-  if (auto prev = this->prev.lock()) {
+  if (auto prev = this->prev) {
     prev->next = basic_block;
   }
 
@@ -56,7 +80,7 @@ void BasicBlock::remove(Context& context) {
     curr_instruction = next_instruction;
   }
 
-  if (auto prev = this->prev.lock()) {
+  if (auto prev = this->prev) {
     prev->next = this->next;
   }
 
@@ -65,36 +89,48 @@ void BasicBlock::remove(Context& context) {
   }
 }
 
-std::string BasicBlock::to_string(Context& context) {
-  std::string label = this->get_label();
-  std::string result = label + ": ";
+void BasicBlock::emit(Emitter& out, Context& context) {
+  out << this->get_label() << ": ";
 
-  result += "; use count: " + std::to_string(this->use_id_list.size());
-  result += "; succ: ";
+  out << "; use count: " << this->use_id_list.size();
+  out << "; succ: ";
   for (auto succ_id : this->succ_list) {
-    result += std::to_string(succ_id) + ", ";
+    out.id(succ_id) << ", ";
   }
-  result += "; pred: ";
+  out << "; pred: ";
   for (auto pred_id : this->pred_list) {
-    result += std::to_string(pred_id) + ", ";
+    out.id(pred_id) << ", ";
   }
-  result += "\n";
+  out << "\n";
 
   auto curr_instruction = this->head_instruction->next;
 
   while (curr_instruction != this->tail_instruction) {
-    result += "  " + curr_instruction->to_string(context) + "\n";
+    out << "  " << curr_instruction->to_string(context) << "\n";
     curr_instruction = curr_instruction->next;
   };
+}
 
-  return result;
+std::string BasicBlock::to_string(Context& context) {
+  Emitter out;
+  emit(out, context);
+  return out.str();
 }
 
 void BasicBlock::append_instruction(InstructionPtr instruction) {
+  // Instructions are created in the space of their function, see `IdSpace`.
+  assert(
+    !this->parent_function ||
+    id_space_of(instruction->id) == this->parent_function->id_space
+  );
   this->tail_instruction->insert_prev(instruction);
 }
 
 void BasicBlock::prepend_instruction(InstructionPtr instruction) {
+  assert(
+    !this->parent_function ||
+    id_space_of(instruction->id) == this->parent_function->id_space
+  );
   this->head_instruction->insert_next(instruction);
 }
 
@@ -184,7 +220,7 @@ bool BasicBlock::has_terminator() const {
   if (this->head_instruction->next == this->tail_instruction) {
     return false;
   }
-  return this->tail_instruction->prev.lock()->is_terminator();
+  return this->tail_instruction->prev->is_terminator();
 }
 
 bool BasicBlock::has_use() const {
@@ -195,7 +231,7 @@ std::vector<BasicBlockID> BasicBlock::get_succ() const {
   std::vector<BasicBlockID> result;
   if (this->head_instruction->next == this->tail_instruction)
     return result;
-  auto tail_instruction_ptr = this->tail_instruction->prev.lock();
+  auto tail_instruction_ptr = this->tail_instruction->prev;
   if (tail_instruction_ptr) {
     std::visit(
       overloaded{
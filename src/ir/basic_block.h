@@ -4,16 +4,19 @@
 #include "common.h"
 #include "ir/builder.h"
 #include "ir/context.h"
+#include "ir/instruction.h"
 
 namespace syc {
 namespace ir {
 
-struct BasicBlock : std::enable_shared_from_this<BasicBlock> {
+/// Basic block
+/// The basic block is owned by the arena in the context.
+struct BasicBlock {
   /// ID of the basic block in the context
   BasicBlockID id;
 
-  /// Name of the parent function
-  std::string parent_function_name;
+  /// Parent function, owned by the function table of the context.
+  Function* parent_function;
 
   /// Head instruction
   /// The head instruction is a dummy instruction to index the initial
@@ -24,6 +27,10 @@ struct BasicBlock : std::enable_shared_from_this<BasicBlock> {
   /// instruction.
   InstructionPtr tail_instruction;
 
+  /// Storage of the dummy head and tail instructions.
+  Instruction head_guard;
+  Instruction tail_guard;
+
   /// List of id of instructions that use this block
   std::vector<InstructionID> use_id_list;
 
@@ -36,7 +43,10 @@ struct BasicBlock : std::enable_shared_from_this<BasicBlock> {
   BasicBlockPrevPtr prev;
 
   /// Constructor
-  BasicBlock(BasicBlockID id, std::string parent_function_name);
+  BasicBlock(BasicBlockID id, Function* parent_function);
+
+  BasicBlock(const BasicBlock&) = delete;
+  BasicBlock& operator=(const BasicBlock&) = delete;
 
   /// Append instruction to the end of the basic block.
   void append_instruction(InstructionPtr instruction);
@@ -68,7 +78,10 @@ struct BasicBlock : std::enable_shared_from_this<BasicBlock> {
 
   /// Get the label name of the basic block.
   /// Note that the returned string cannot be directly used as an IR operand.
-  std::string get_label() const { return "bb_" + std::to_string(id); }
+  std::string get_label() const { return "bb_" + id_to_string(id); }
+
+  /// Emit the basic block and its instructions in IR form.
+  void emit(Emitter& out, Context& context);
 
   /// Convert the basic block and its instructions to a string in IR form.
   std::string to_string(Context& context);
@@ -82,12 +95,12 @@ struct BasicBlock : std::enable_shared_from_this<BasicBlock> {
   std::vector<BasicBlockID> get_succ() const;
 };
 
-/// Create a basic block.
-BasicBlockPtr
-create_basic_block(BasicBlockID id, std::string parent_function_name);
-
-/// Create a dummy basic block.
-BasicBlockPtr create_dummy_basic_block();
+/// Create a basic block in the arena of the context.
+BasicBlockPtr create_basic_block(
+  BasicBlockID id,
+  Function* parent_function,
+  Context& context
+);
 
 }  // namespace ir
 }  // namespace syc
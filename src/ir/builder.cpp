@@ -1,4 +1,5 @@
 #include "ir/builder.h"
+#include <cstring>
 #include "ir/basic_block.h"
 #include "ir/context.h"
 #include "ir/function.h"
@@ -9,10 +10,54 @@
 namespace syc {
 namespace ir {
 
+Builder::Builder()
+  : owned_context(std::make_unique<Context>()), context(*owned_context) {}
+
+Builder::Builder(Context& context) : context(context) {}
+
+size_t Builder::get_curr_id_space() const {
+  return curr_function ? curr_function->id_space : 0;
+}
+
 OperandID Builder::fetch_operand(TypePtr type, OperandKind kind) {
-  auto id = context.get_next_operand_id();
-  auto operand = std::make_shared<Operand>(id, type, kind);
+  // Scalar constants are interned, the same value of the same type is always
+  // the same operand.
+  std::optional<std::tuple<Type*, size_t, uint32_t>> maybe_constant_key =
+    std::nullopt;
+
+  if (std::holds_alternative<operand::ConstantPtr>(kind)) {
+    auto constant = std::get<operand::ConstantPtr>(kind);
+    if (constant->type == type) {
+      uint32_t bits = 0;
+      if (std::holds_alternative<int>(constant->kind)) {
+        bits = static_cast<uint32_t>(std::get<int>(constant->kind));
+        maybe_constant_key = std::make_tuple(type.get(), 0, bits);
+      } else if (std::holds_alternative<float>(constant->kind)) {
+        float value = std::get<float>(constant->kind);
+        std::memcpy(&bits, &value, sizeof(bits));
+        maybe_constant_key = std::make_tuple(type.get(), 1, bits);
+      }
+    }
+  }
+
+  auto space = get_curr_id_space();
+  auto& id_space = context.get_id_space(space);
+
+  if (maybe_constant_key.has_value()) {
+    auto it = id_space.constant_operand_table.find(maybe_constant_key.value());
+    if (it != id_space.constant_operand_table.end()) {
+      return it->second;
+    }
+  }
+
+  auto id = context.get_next_operand_id(space);
+  auto operand = id_space.operand_arena.create(id, type, kind);
   context.register_operand(operand);
+
+  if (maybe_constant_key.has_value()) {
+    id_space.constant_operand_table[maybe_constant_key.value()] = id;
+  }
+
   return id;
 }
 
@@ -52,22 +97,20 @@ InstructionPtr Builder::fetch_binary_instruction(
   OperandID rhs_id,
   bool indvar_overflow_hint
 ) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
 
   auto kind = InstructionKind(instruction::Binary{
     op, dst_id, lhs_id, rhs_id, indvar_overflow_hint});
 
-  auto instruction = create_instruction(id, kind, curr_basic_block->id);
+  auto instruction = create_instruction(id, kind, curr_basic_block->id, context);
 
   context.register_instruction(instruction);
 
   context.operand_table[dst_id]->set_def(id);
-  context.operand_table[lhs_id]->add_use(id);
-  context.operand_table[rhs_id]->add_use(id);
 
   instruction->set_def(dst_id);
-  instruction->add_use(lhs_id);
-  instruction->add_use(rhs_id);
+  instruction->add_use(lhs_id, context);
+  instruction->add_use(rhs_id, context);
 
   return instruction;
 }
@@ -78,21 +121,19 @@ InstructionPtr Builder::fetch_icmp_instruction(
   OperandID lhs_id,
   OperandID rhs_id
 ) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
 
   auto kind = InstructionKind(instruction::ICmp{cond, dst_id, lhs_id, rhs_id});
 
-  auto instruction = create_instruction(id, kind, curr_basic_block->id);
+  auto instruction = create_instruction(id, kind, curr_basic_block->id, context);
 
   context.register_instruction(instruction);
 
   context.operand_table[dst_id]->set_def(id);
-  context.operand_table[lhs_id]->add_use(id);
-  context.operand_table[rhs_id]->add_use(id);
 
   instruction->set_def(dst_id);
-  instruction->add_use(lhs_id);
-  instruction->add_use(rhs_id);
+  instruction->add_use(lhs_id, context);
+  instruction->add_use(rhs_id, context);
 
   return instruction;
 }
@@ -103,21 +144,19 @@ InstructionPtr Builder::fetch_fcmp_instruction(
   OperandID lhs_id,
   OperandID rhs_id
 ) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
 
   auto kind = InstructionKind(instruction::FCmp{cond, dst_id, lhs_id, rhs_id});
 
-  auto instruction = create_instruction(id, kind, curr_basic_block->id);
+  auto instruction = create_instruction(id, kind, curr_basic_block->id, context);
 
   context.register_instruction(instruction);
 
   context.operand_table[dst_id]->set_def(id);
-  context.operand_table[lhs_id]->add_use(id);
-  context.operand_table[rhs_id]->add_use(id);
 
   instruction->set_def(dst_id);
-  instruction->add_use(lhs_id);
-  instruction->add_use(rhs_id);
+  instruction->add_use(lhs_id, context);
+  instruction->add_use(rhs_id, context);
 
   return instruction;
 }
@@ -127,19 +166,18 @@ InstructionPtr Builder::fetch_cast_instruction(
   OperandID dst_id,
   OperandID src_id
 ) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
 
   auto kind = InstructionKind(instruction::Cast{op, dst_id, src_id});
 
-  auto instruction = create_instruction(id, kind, curr_basic_block->id);
+  auto instruction = create_instruction(id, kind, curr_basic_block->id, context);
 
   context.register_instruction(instruction);
 
   context.operand_table[dst_id]->set_def(id);
-  context.operand_table[src_id]->add_use(id);
 
   instruction->set_def(dst_id);
-  instruction->add_use(src_id);
+  instruction->add_use(src_id, context);
 
   return instruction;
 }
@@ -147,17 +185,16 @@ InstructionPtr Builder::fetch_cast_instruction(
 InstructionPtr Builder::fetch_ret_instruction(
   std::optional<OperandID> maybe_value_id
 ) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
 
   auto kind = InstructionKind(instruction::Ret{maybe_value_id});
 
-  auto instruction = create_instruction(id, kind, curr_basic_block->id);
+  auto instruction = create_instruction(id, kind, curr_basic_block->id, context);
 
   context.register_instruction(instruction);
 
   if (maybe_value_id.has_value()) {
-    context.operand_table[maybe_value_id.value()]->add_use(id);
-    instruction->add_use(maybe_value_id.value());
+    instruction->add_use(maybe_value_id.value(), context);
   }
 
   return instruction;
@@ -168,7 +205,7 @@ InstructionPtr Builder::fetch_condbr_instruction(
   BasicBlockID then_block_id,
   BasicBlockID else_block_id
 ) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
 
   auto kind = InstructionKind(instruction::CondBr{
     cond_id,
@@ -176,25 +213,24 @@ InstructionPtr Builder::fetch_condbr_instruction(
     else_block_id,
   });
 
-  auto instruction = create_instruction(id, kind, curr_basic_block->id);
+  auto instruction = create_instruction(id, kind, curr_basic_block->id, context);
 
   context.register_instruction(instruction);
 
-  context.operand_table[cond_id]->add_use(id);
   context.basic_block_table[then_block_id]->add_use(id);
   context.basic_block_table[else_block_id]->add_use(id);
 
-  instruction->add_use(cond_id);
+  instruction->add_use(cond_id, context);
 
   return instruction;
 }
 
 InstructionPtr Builder::fetch_br_instruction(BasicBlockID block_id) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
 
   auto kind = InstructionKind(instruction::Br{block_id});
 
-  auto instruction = create_instruction(id, kind, curr_basic_block->id);
+  auto instruction = create_instruction(id, kind, curr_basic_block->id, context);
 
   context.register_instruction(instruction);
 
@@ -207,10 +243,10 @@ InstructionPtr Builder::fetch_phi_instruction(
   OperandID dst_id,
   std::vector<std::tuple<OperandID, BasicBlockID>> incoming_list
 ) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
   auto kind = InstructionKind(instruction::Phi{dst_id, incoming_list});
 
-  auto instruction = create_instruction(id, kind, curr_basic_block->id);
+  auto instruction = create_instruction(id, kind, curr_basic_block->id, context);
 
   context.register_instruction(instruction);
 
@@ -218,9 +254,8 @@ InstructionPtr Builder::fetch_phi_instruction(
 
   context.operand_table[dst_id]->set_def(id);
   for (auto [value_id, block_id] : incoming_list) {
-    context.operand_table[value_id]->add_use(id);
     context.basic_block_table[block_id]->add_use(id);
-    instruction->add_use(value_id);
+    instruction->add_use(value_id, context);
   }
 
   return instruction;
@@ -229,40 +264,26 @@ InstructionPtr Builder::fetch_phi_instruction(
 InstructionPtr Builder::fetch_alloca_instruction(
   OperandID dst_id,
   TypePtr allocaed_type,
-  std::optional<OperandID> maybe_size_id,
   std::optional<OperandID> maybe_align_id,
-  std::optional<OperandID> maybe_addrspace_id,
   bool alloca_for_param
 ) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
   auto kind = InstructionKind(instruction::Alloca{
     dst_id,
     allocaed_type,
-    maybe_size_id,
     maybe_align_id,
-    maybe_addrspace_id,
     alloca_for_param,
   });
 
-  auto instruction = create_instruction(id, kind, curr_basic_block->id);
+  auto instruction = create_instruction(id, kind, curr_basic_block->id, context);
 
   context.register_instruction(instruction);
 
   instruction->set_def(dst_id);
 
   context.operand_table[dst_id]->set_def(id);
-  if (maybe_size_id.has_value()) {
-    context.operand_table[maybe_size_id.value()]->add_use(id);
-    instruction->add_use(maybe_size_id.value());
-  }
   if (maybe_align_id.has_value()) {
-    context.operand_table[maybe_align_id.value()]->add_use(id);
-    instruction->add_use(maybe_align_id.value());
-  }
-  if (maybe_addrspace_id.has_value()) {
-    context.operand_table[maybe_addrspace_id.value()]->use_id_list.push_back(id
-    );
-    instruction->add_use(maybe_addrspace_id.value());
+    instruction->add_use(maybe_align_id.value(), context);
   }
 
   return instruction;
@@ -273,26 +294,24 @@ InstructionPtr Builder::fetch_load_instruction(
   OperandID ptr_id,
   std::optional<OperandID> maybe_align_id
 ) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
   auto kind = InstructionKind(instruction::Load{
     dst_id,
     ptr_id,
     maybe_align_id,
   });
 
-  auto instruction = create_instruction(id, kind, curr_basic_block->id);
+  auto instruction = create_instruction(id, kind, curr_basic_block->id, context);
 
   context.register_instruction(instruction);
 
   context.operand_table[dst_id]->set_def(id);
-  context.operand_table[ptr_id]->add_use(id);
 
   instruction->set_def(dst_id);
-  instruction->add_use(ptr_id);
+  instruction->add_use(ptr_id, context);
 
   if (maybe_align_id.has_value()) {
-    context.operand_table[maybe_align_id.value()]->add_use(id);
-    instruction->add_use(maybe_align_id.value());
+    instruction->add_use(maybe_align_id.value(), context);
   }
 
   return instruction;
@@ -303,26 +322,22 @@ InstructionPtr Builder::fetch_store_instruction(
   OperandID ptr_id,
   std::optional<OperandID> maybe_align_id
 ) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
   auto kind = InstructionKind(instruction::Store{
     value_id,
     ptr_id,
     maybe_align_id,
   });
 
-  auto instruction = create_instruction(id, kind, curr_basic_block->id);
+  auto instruction = create_instruction(id, kind, curr_basic_block->id, context);
 
   context.register_instruction(instruction);
 
-  context.operand_table[value_id]->add_use(id);
-  context.operand_table[ptr_id]->add_use(id);
-
-  instruction->add_use(value_id);
-  instruction->add_use(ptr_id);
+  instruction->add_use(value_id, context);
+  instruction->add_use(ptr_id, context);
 
   if (maybe_align_id.has_value()) {
-    context.operand_table[maybe_align_id.value()]->add_use(id);
-    instruction->add_use(maybe_align_id.value());
+    instruction->add_use(maybe_align_id.value(), context);
   }
 
   return instruction;
@@ -333,14 +348,15 @@ InstructionPtr Builder::fetch_call_instruction(
   std::string function_name,
   std::vector<OperandID> args_id
 ) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
+  auto callee = context.get_function(function_name);
   auto kind = InstructionKind(instruction::Call{
     maybe_dst_id,
-    function_name,
+    callee.get(),
     args_id,
   });
 
-  auto instruction = create_instruction(id, kind, curr_basic_block->id);
+  auto instruction = create_instruction(id, kind, curr_basic_block->id, context);
 
   context.register_instruction(instruction);
 
@@ -349,10 +365,9 @@ InstructionPtr Builder::fetch_call_instruction(
     instruction->set_def(maybe_dst_id.value());
   }
   for (auto arg_id : args_id) {
-    context.operand_table[arg_id]->add_use(id);
-    instruction->add_use(arg_id);
+    instruction->add_use(arg_id, context);
   }
-  context.function_table[function_name]->caller_id_list.push_back(id);
+  callee->add_caller(id);
 
   return instruction;
 }
@@ -363,7 +378,7 @@ InstructionPtr Builder::fetch_getelementptr_instruction(
   OperandID ptr_id,
   std::vector<OperandID> indices_id
 ) {
-  auto id = context.get_next_instruction_id();
+  auto id = context.get_next_instruction_id(get_curr_id_space());
   auto kind = InstructionKind(instruction::GetElementPtr{
     dst_id,
     basis_type,
@@ -371,19 +386,17 @@ InstructionPtr Builder::fetch_getelementptr_instruction(
     indices_id,
   });
 
-  auto instruction = create_instruction(id, kind, curr_basic_block->id);
+  auto instruction = create_instruction(id, kind, curr_basic_block->id, context);
 
   context.register_instruction(instruction);
 
   context.operand_table[dst_id]->set_def(id);
-  context.operand_table[ptr_id]->add_use(id);
 
   instruction->set_def(dst_id);
-  instruction->add_use(ptr_id);
+  instruction->add_use(ptr_id, context);
 
   for (auto index_id : indices_id) {
-    context.operand_table[index_id]->add_use(id);
-    instruction->add_use(index_id);
+    instruction->add_use(index_id, context);
   }
 
   return instruction;
@@ -431,8 +444,8 @@ void Builder::prepend_instruction_to_curr_function(InstructionPtr instruction) {
 }
 
 BasicBlockPtr Builder::fetch_basic_block() {
-  auto id = context.get_next_basic_block_id();
-  auto basic_block = create_basic_block(id, curr_function->name);
+  auto id = context.get_next_basic_block_id(get_curr_id_space());
+  auto basic_block = create_basic_block(id, curr_function.get(), context);
 
   context.register_basic_block(basic_block);
   return basic_block;
@@ -459,6 +472,7 @@ void Builder::add_function(
   auto function = std::make_shared<Function>(
     function_name, return_type, parameter_id_list, is_declare
   );
+  function->id_space = context.create_id_space();
   context.register_function(function);
   curr_function = function;
 }
@@ -9,8 +9,10 @@ namespace syc {
 namespace ir {
 
 struct Builder {
+  /// Context owned by this builder, null if the context is shared.
+  std::unique_ptr<Context> owned_context;
   /// Context of the intermediate representation.
-  Context context;
+  Context& context;
 
   /// Current function
   FunctionPtr curr_function;
@@ -23,22 +25,33 @@ struct Builder {
   /// Stack to record the tail basic block of while statement.
   std::stack<BasicBlockPtr> while_tail_basic_block_stack;
 
-  Builder() = default;
+  /// Create a builder with a new context.
+  Builder();
 
-  TypePtr fetch_i32_type() { return std::make_shared<Type>(type::Integer{32}); }
+  /// Create a builder on an existing context, e.g. for a worker thread that
+  /// builds one function at a time.
+  explicit Builder(Context& context);
 
-  TypePtr fetch_i1_type() { return std::make_shared<Type>(type::Integer{1}); }
+  Builder(const Builder&) = delete;
+  Builder& operator=(const Builder&) = delete;
 
-  TypePtr fetch_float_type() { return std::make_shared<Type>(type::Float{}); }
+  /// Get the ID space to allocate new nodes in, the space of the current
+  /// function or the space of the module if there is no current function.
+  size_t get_curr_id_space() const;
 
-  TypePtr fetch_void_type() { return std::make_shared<Type>(type::Void{}); }
+  /// Types are interned, each distinct type is only created once.
+  TypePtr fetch_i32_type() { return get_i32_type(); }
 
-  TypePtr fetch_pointer_type() {
-    return std::make_shared<Type>(type::Pointer{});
-  }
+  TypePtr fetch_i1_type() { return get_i1_type(); }
+
+  TypePtr fetch_float_type() { return get_float_type(); }
+
+  TypePtr fetch_void_type() { return get_void_type(); }
+
+  TypePtr fetch_pointer_type() { return get_pointer_type(); }
 
   TypePtr fetch_array_type(size_t length, TypePtr element_type) {
-    return std::make_shared<Type>(type::Array{length, element_type});
+    return context.fetch_array_type(length, element_type);
   }
 
   /// Make an operand and register it to the context.
@@ -127,9 +140,7 @@ struct Builder {
   InstructionPtr fetch_alloca_instruction(
     OperandID dst_id,
     TypePtr allocated_type,
-    std::optional<OperandID> maybe_size_id,
     std::optional<OperandID> maybe_align_id,
-    std::optional<OperandID> maybe_addrspace_id,
     bool alloca_for_param = false
   );
 
@@ -17,6 +17,21 @@ void codegen(
   IrContext& ir_context,
   AsmBuilder& builder,
   CodegenContext& codegen_context
+) {
+  codegen_globals(ir_context, builder, codegen_context);
+
+  for (auto& [ir_function_name, ir_function] : ir_context.function_table) {
+    if (ir_function->is_declare) {
+      continue;
+    }
+    codegen_function(ir_function, ir_context, builder, codegen_context);
+  }
+}
+
+void codegen_globals(
+  IrContext& ir_context,
+  AsmBuilder& builder,
+  CodegenContext& codegen_context
 ) {
   for (auto& ir_operand_id : ir_context.global_list) {
     auto& ir_global = std::get<ir::operand::Global>(
@@ -108,11 +123,13 @@ void codegen(
     }
   }
 
+  // Functions are added before any of them is lowered, so the function table
+  // is not changed while the functions are lowered on different threads.
   for (auto& [ir_function_name, ir_function] : ir_context.function_table) {
     if (ir_function->is_declare) {
       continue;
     }
-    codegen_function(ir_function, ir_context, builder, codegen_context);
+    builder.add_function(ir_function_name);
   }
 }
 
@@ -135,13 +152,25 @@ void codegen_rest(
   }
 }
 
+void codegen_function_rest(
+  std::string function_name,
+  IrContext& ir_context,
+  AsmBuilder& builder,
+  CodegenContext& codegen_context
+) {
+  backend::greedy_allocation(
+    builder.context.get_function(function_name), builder
+  );
+  codegen_function_prolouge(function_name, ir_context, builder, codegen_context);
+  codegen_function_epilouge(function_name, builder, codegen_context);
+}
+
 void codegen_function(
   IrFunctionPtr ir_function,
   IrContext& ir_context,
   AsmBuilder& builder,
   CodegenContext& codegen_context
 ) {
-  builder.add_function(ir_function->name);
   builder.switch_function(ir_function->name);
 
   auto curr_ir_basic_block = ir_function->head_basic_block->next;
@@ -209,6 +238,11 @@ void codegen_function(
       offset, backend::Register{backend::GeneralRegister::S0}
     );
     codegen_context.operand_map[ir_operand_id] = asm_local_memory_id;
+    // Load the parameter once in the entry block. Otherwise each use loads it
+    // in place, and the load of a phi incoming would end up in the block of
+    // the phi instead of the predecessor.
+    codegen_context.operand_map[ir_operand_id] =
+      codegen_operand(ir_operand_id, ir_context, builder, codegen_context);
     offset += 8;
   }
 
@@ -1509,7 +1543,7 @@ void codegen_instruction(
         }
 
         auto call_instruction =
-          builder.fetch_call_instruction(call.function_name, used_arg_reg_set);
+          builder.fetch_call_instruction(call.callee->name, used_arg_reg_set);
 
         builder.append_instruction(call_instruction);
 
@@ -46,6 +46,13 @@ void codegen(
   CodegenContext& codegen_context
 );
 
+/// Generate the globals and add all the functions to the asm context.
+void codegen_globals(
+  IrContext& ir_context,
+  AsmBuilder& builder,
+  CodegenContext& codegen_context
+);
+
 void codegen_function(
   IrFunctionPtr ir_function,
   IrContext& ir_context,
@@ -59,6 +66,14 @@ void codegen_rest(
   CodegenContext& codegen_context
 );
 
+/// Allocate the registers of a function and add its prologue and epilogue.
+void codegen_function_rest(
+  std::string function_name,
+  IrContext& ir_context,
+  AsmBuilder& builder,
+  CodegenContext& codegen_context
+);
+
 void codegen_function_prolouge(
   std::string function_name,
   IrContext& ir_context,
@@ -4,15 +4,31 @@
 #include "ir/instruction.h"
 #include "ir/operand.h"
 #include "ir/type.h"
+#include "ir/use.h"
 
 namespace syc {
 namespace ir {
 
+Context::Context() {
+  create_id_space();
+}
+
+Context::~Context() = default;
+
+size_t Context::create_id_space() {
+  auto space = id_space_list.size();
+  id_space_list.push_back(std::make_unique<IdSpace>());
+  operand_table.reserve_space(space);
+  instruction_table.reserve_space(space);
+  basic_block_table.reserve_space(space);
+  return space;
+}
+
 void Context::register_operand(OperandPtr operand) {
-  if (operand_table.find(operand->id) != operand_table.end()) {
+  if (operand_table.contains(operand->id)) {
     throw std::runtime_error("Operand ID already exists.");
   }
-  operand_table[operand->id] = operand;
+  operand_table.insert(operand->id, operand);
 
   // If the operand is global, add it to the global list.
   if (std::holds_alternative<operand::Global>(operand->kind)) {
@@ -20,18 +36,18 @@ void Context::register_operand(OperandPtr operand) {
   }
 }
 
-void Context::register_basic_block(std::shared_ptr<BasicBlock> basic_block) {
-  if (basic_block_table.find(basic_block->id) != basic_block_table.end()) {
+void Context::register_basic_block(BasicBlockPtr basic_block) {
+  if (basic_block_table.contains(basic_block->id)) {
     throw std::runtime_error("BasicBlock ID already exists.");
   }
-  basic_block_table[basic_block->id] = basic_block;
+  basic_block_table.insert(basic_block->id, basic_block);
 }
 
 void Context::register_instruction(InstructionPtr instruction) {
-  if (instruction_table.find(instruction->id) != instruction_table.end()) {
+  if (instruction_table.contains(instruction->id)) {
     throw std::runtime_error("Instruction ID already exists.");
   }
-  instruction_table[instruction->id] = instruction;
+  instruction_table.insert(instruction->id, instruction);
 }
 
 void Context::register_function(std::shared_ptr<Function> function) {
@@ -57,9 +73,19 @@ FunctionPtr Context::get_function(std::string function_name) {
   return function_table.at(function_name);
 }
 
-std::string Context::to_string() {
-  std::string result = "";
+TypePtr Context::fetch_array_type(size_t length, TypePtr element_type) {
+  std::lock_guard<std::mutex> lock(array_type_mutex);
+  auto key = std::make_tuple(length, element_type.get());
+  auto it = array_type_table.find(key);
+  if (it != array_type_table.end()) {
+    return it->second;
+  }
+  auto array_type = std::make_shared<Type>(type::Array{length, element_type});
+  array_type_table[key] = array_type;
+  return array_type;
+}
 
+void Context::emit(Emitter& out) {
   // Global variable/constants.
   for (auto operand_id : global_list) {
     auto global = std::get<operand::Global>(operand_table[operand_id]->kind);
@@ -69,28 +95,101 @@ std::string Context::to_string() {
     // Note that if global variable is used as an operand, it must be used as a
     // pointer/address.
 
-    result += "@" + global.name + " = ";
+    out << "@" << global.name << " = ";
 
     if (global.is_constant_value) {
-      result += "constant ";
+      out << "constant ";
     } else {
-      result += "global ";
+      out << "global ";
     }
 
     auto operand = operand_table[global.init];
 
-    result += operand->to_string(true);
+    operand->emit(out, true);
+
+    out << "\n";
+  }
+  out << "\n";
 
-    result += "\n";
+  for (auto& [function_name, function] : function_table) {
+    function->emit(out, *this);
+    out << "\n";
   }
-  result += "\n";
+}
 
+void Context::count_nodes(CountList& count_list) {
+  static const char* instruction_kind_names[] = {
+    "binary", "icmp", "fcmp",  "cast", "ret",           "condbr", "br",
+    "phi",    "alloca", "load", "store", "call", "getelementptr", "dummy"};
+  static_assert(
+    std::size(instruction_kind_names) == std::variant_size_v<InstructionKind>
+  );
+
+  // Nodes reachable from the functions, the rest are removed but still held by
+  // the arenas.
+  size_t basic_block_count = 0;
+  std::vector<size_t> instruction_count_list(
+    std::variant_size_v<InstructionKind>, 0
+  );
   for (auto& [function_name, function] : function_table) {
-    result += function->to_string(*this) + "\n";
+    auto curr_bb = function->head_basic_block->next;
+    while (curr_bb != function->tail_basic_block) {
+      basic_block_count++;
+      auto curr_instruction = curr_bb->head_instruction->next;
+      while (curr_instruction != curr_bb->tail_instruction) {
+        instruction_count_list[curr_instruction->kind.index()]++;
+        curr_instruction = curr_instruction->next;
+      }
+      curr_bb = curr_bb->next;
+    }
+  }
+
+  count_list.push_back({"ir.functions", function_table.size()});
+  count_list.push_back({"ir.globals", global_list.size()});
+  count_list.push_back({"ir.live_basic_blocks", basic_block_count});
+  for (size_t i = 0; i < instruction_count_list.size(); i++) {
+    count_list.push_back(
+      {std::string("ir.live_instructions.") + instruction_kind_names[i],
+       instruction_count_list[i]}
+    );
   }
 
-  return result;
+  size_t constant_count = 0;
+  size_t operand_object_count = 0;
+  size_t instruction_object_count = 0;
+  size_t basic_block_object_count = 0;
+  size_t use_object_count = 0;
+  size_t arena_bytes = 0;
+  for (const auto& id_space : id_space_list) {
+    constant_count += id_space->constant_operand_table.size();
+    operand_object_count += id_space->operand_arena.size();
+    instruction_object_count += id_space->instruction_arena.size();
+    basic_block_object_count += id_space->basic_block_arena.size();
+    use_object_count += id_space->use_arena.size();
+    arena_bytes += id_space->operand_arena.reserved_bytes() +
+                   id_space->instruction_arena.reserved_bytes() +
+                   id_space->basic_block_arena.reserved_bytes() +
+                   id_space->use_arena.reserved_bytes();
+  }
+
+  count_list.push_back({"ir.id_spaces", id_space_list.size()});
+  count_list.push_back({"ir.arena.operands", operand_object_count});
+  count_list.push_back({"ir.arena.instructions", instruction_object_count});
+  count_list.push_back({"ir.arena.basic_blocks", basic_block_object_count});
+  count_list.push_back({"ir.arena.uses", use_object_count});
+  count_list.push_back({"ir.arena.reserved_bytes", arena_bytes});
+  count_list.push_back({"ir.table.operands", operand_table.size()});
+  count_list.push_back({"ir.table.instructions", instruction_table.size()});
+  count_list.push_back({"ir.table.basic_blocks", basic_block_table.size()});
+  count_list.push_back({"ir.interned_constants", constant_count});
+  count_list.push_back({"ir.interned_array_types", array_type_table.size()});
+}
+
+std::string Context::to_string() {
+  Emitter out;
+  emit(out);
+  return out.str();
 }
 
 }  // namespace ir
-}  // namespace syc
\ No newline at end of file
+}  // namespace syc
\ No newline at end of file
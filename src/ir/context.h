@@ -1,32 +1,88 @@
 #ifndef SYC_IR_CONTEXT_H_
 #define SYC_IR_CONTEXT_H_
 
+#include <mutex>
+
+#include "arena.h"
 #include "common.h"
+#include "dense_table.h"
+#include "emitter.h"
 
 namespace syc {
 namespace ir {
 
+/// Counters, node storage and interned constants of an ID space.
+///
+/// Space 0 belongs to the module and every function has its own space. A
+/// builder allocates from the space of its current function, so building a
+/// function never touches the state of another one, and the functions can be
+/// built on different threads with the same IDs as on one thread.
+struct IdSpace {
+  /// Storage of the operands, instructions and basic blocks of the space.
+  /// Nodes are never freed before the context itself, so the pointers in the
+  /// tables and in the linked lists are always valid.
+  Arena<Operand> operand_arena;
+  Arena<Instruction> instruction_arena;
+  Arena<BasicBlock> basic_block_arena;
+  /// Uses of the operands by the instructions of the space. Released uses are
+  /// kept in `free_use_list` and reused before the arena grows.
+  Arena<Use> use_arena;
+  std::vector<Use*> free_use_list;
+
+  /// Interned scalar constants, keyed by the type, the index of the value in
+  /// `ConstantKind` and the bits of the value.
+  std::map<std::tuple<Type*, size_t, uint32_t>, OperandID>
+    constant_operand_table;
+
+  size_t next_operand_local = 0;
+  size_t next_instruction_local = 0;
+  size_t next_basic_block_local = 0;
+};
+
 struct Context {
-  std::map<OperandID, OperandPtr> operand_table;
-  std::map<InstructionID, InstructionPtr> instruction_table;
-  std::map<BasicBlockID, BasicBlockPtr> basic_block_table;
+  /// ID spaces, indexed by the space of the IDs.
+  std::vector<std::unique_ptr<IdSpace>> id_space_list;
+
+  /// Tables from the dense IDs to the nodes.
+  DenseTable<OperandID, OperandPtr> operand_table;
+  DenseTable<InstructionID, InstructionPtr> instruction_table;
+  DenseTable<BasicBlockID, BasicBlockPtr> basic_block_table;
 
   std::map<std::string, FunctionPtr> function_table;
   std::vector<OperandID> global_list;
 
-  OperandID next_operand_id = 0;
-  InstructionID next_instruction_id = 0;
-  BasicBlockID next_basic_block_id = 0;
+  /// Interned array types, keyed by the length and the element type.
+  /// Element types are interned as well, so the raw pointer is a unique key.
+  std::map<std::tuple<size_t, Type*>, TypePtr> array_type_table;
+  /// Array types may be fetched by builders on different threads.
+  std::mutex array_type_mutex;
+
+  /// Create the context with the space of the module.
+  Context();
+  /// Destructor, defined where the node types are complete.
+  ~Context();
 
-  Context() = default;
+  Context(const Context&) = delete;
+  Context& operator=(const Context&) = delete;
 
-  OperandID get_next_operand_id() { return next_operand_id++; }
-  InstructionID get_next_instruction_id() { return next_instruction_id++; }
-  BasicBlockID get_next_basic_block_id() { return next_basic_block_id++; }
+  /// Add a new ID space, must not run concurrently with other users.
+  size_t create_id_space();
+
+  IdSpace& get_id_space(size_t space) { return *id_space_list[space]; }
+
+  OperandID get_next_operand_id(size_t space) {
+    return make_id(space, get_id_space(space).next_operand_local++);
+  }
+  InstructionID get_next_instruction_id(size_t space) {
+    return make_id(space, get_id_space(space).next_instruction_local++);
+  }
+  BasicBlockID get_next_basic_block_id(size_t space) {
+    return make_id(space, get_id_space(space).next_basic_block_local++);
+  }
 
   void register_operand(OperandPtr operand);
 
-  void register_basic_block(std::shared_ptr<BasicBlock> basic_block);
+  void register_basic_block(BasicBlockPtr basic_block);
 
   void register_instruction(InstructionPtr instruction);
 
@@ -40,7 +96,16 @@ struct Context {
 
   FunctionPtr get_function(std::string function_name);
 
+  /// Get the unique array type of the given length and element type.
+  TypePtr fetch_array_type(size_t length, TypePtr element_type);
+
+  /// Emit the globals and the functions in IR form.
+  void emit(Emitter& out);
+
   std::string to_string();
+
+  /// Count the live nodes by kind and the sizes of the tables and arenas.
+  void count_nodes(CountList& count_list);
 };
 
 }  // namespace ir
@@ -16,9 +16,11 @@ Function::Function(
   : name(name),
     return_type(return_type),
     parameter_id_list(parameter_id_list),
+    head_guard(std::numeric_limits<BasicBlockID>::max(), this),
+    tail_guard(std::numeric_limits<BasicBlockID>::max(), this),
     is_declare(is_declare) {
-  this->head_basic_block = create_dummy_basic_block();
-  this->tail_basic_block = create_dummy_basic_block();
+  this->head_basic_block = &this->head_guard;
+  this->tail_basic_block = &this->tail_guard;
 
   this->maybe_return_operand_id = std::nullopt;
   this->maybe_return_block = std::nullopt;
@@ -38,48 +40,42 @@ void Function::prepend_basic_block(BasicBlockPtr basic_block) {
   this->head_basic_block->insert_next(basic_block);
 }
 
-std::string Function::to_string(Context& context) {
+void Function::emit(Emitter& out, Context& context) {
   if (this->is_declare) {
-    std::string result =
-      "declare " + return_type->to_string() + " @" + name + "(";
-    for (auto operand_id : parameter_id_list) {
-      auto operand = context.get_operand(operand_id);
-      result += operand->get_type()->to_string() + ", ";
-    }
-    if (parameter_id_list.size() > 0) {
-      result.pop_back();
-      result.pop_back();
+    out << "declare " << return_type->to_string() << " @" << name << "(";
+    for (size_t i = 0; i < parameter_id_list.size(); i++) {
+      auto operand = context.get_operand(parameter_id_list[i]);
+      out << (i == 0 ? "" : ", ") << operand->get_type()->to_string();
     }
-    result += ")\n";
-    return result;
+    out << ")\n";
+    return;
   }
 
-  std::string result = "define " + return_type->to_string() + " @" + name + "(";
+  out << "define " << return_type->to_string() << " @" << name << "(";
 
-  for (auto operand_id : parameter_id_list) {
-    auto operand = context.get_operand(operand_id);
-
-    result +=
-      operand->get_type()->to_string() + " " + operand->to_string() + ", ";
-  }
+  for (size_t i = 0; i < parameter_id_list.size(); i++) {
+    auto operand = context.get_operand(parameter_id_list[i]);
 
-  if (parameter_id_list.size() > 0) {
-    result.pop_back();
-    result.pop_back();
+    out << (i == 0 ? "" : ", ") << operand->get_type()->to_string() << " ";
+    operand->emit(out);
   }
 
-  result += ") {\n";
+  out << ") {\n";
 
   auto curr_basic_block = this->head_basic_block->next;
 
   while (curr_basic_block != this->tail_basic_block) {
-    result += curr_basic_block->to_string(context);
+    curr_basic_block->emit(out, context);
     curr_basic_block = curr_basic_block->next;
   }
 
-  result += "}\n";
+  out << "}\n";
+}
 
-  return result;
+std::string Function::to_string(Context& context) {
+  Emitter out;
+  emit(out, context);
+  return out.str();
 }
 
 void Function::add_terminators(Builder& builder) {
@@ -98,7 +94,13 @@ void Function::add_terminators(Builder& builder) {
   }
 }
 
+void Function::add_caller(InstructionID caller_id) {
+  std::lock_guard<std::mutex> lock(caller_mutex);
+  this->caller_id_list.push_back(caller_id);
+}
+
 void Function::remove_caller(InstructionID caller_id) {
+  std::lock_guard<std::mutex> lock(caller_mutex);
   this->caller_id_list.erase(
     std::remove(
       this->caller_id_list.begin(), this->caller_id_list.end(), caller_id
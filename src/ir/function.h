@@ -1,6 +1,8 @@
 #ifndef SYC_IR_FUNCTION_H_
 #define SYC_IR_FUNCTION_H_
 
+#include <mutex>
+
 #include "common.h"
 #include "ir/basic_block.h"
 #include "ir/builder.h"
@@ -21,8 +23,17 @@ struct Function {
   /// Tail basic block of the function.
   /// This block is a dummy block to index the final basic block.
   BasicBlockPtr tail_basic_block;
+  /// Storage of the dummy head and tail basic blocks.
+  BasicBlock head_guard;
+  BasicBlock tail_guard;
   /// List of id of instructions that use this function
   std::vector<InstructionID> caller_id_list;
+  /// Callers may be added or removed by builders of other functions on
+  /// different threads.
+  std::mutex caller_mutex;
+
+  /// ID space of the nodes of this function.
+  size_t id_space = 0;
 
   bool is_declare;
 
@@ -43,12 +54,17 @@ struct Function {
   /// Prepend basic block to the beginning of the function.
   void prepend_basic_block(BasicBlockPtr basic_block);
 
+  /// Emit the function and its basic blocks in IR form.
+  void emit(Emitter& out, Context& context);
+
   /// Convert the function and its basic blocks to a string in IR form.
   std::string to_string(Context& context);
 
   /// Add terminator to each block if there is no terminator in it.
   void add_terminators(Builder& builder);
 
+  void add_caller(InstructionID caller_id);
+
   void remove_caller(InstructionID caller_id);
 
   void remove_unused_basic_blocks(Context& context);
@@ -4,6 +4,7 @@
 #include "ir/function.h"
 #include "ir/operand.h"
 #include "ir/type.h"
+#include "ir/use.h"
 
 namespace syc {
 namespace ir {
@@ -11,21 +12,24 @@ namespace ir {
 InstructionPtr create_instruction(
   InstructionID id,
   InstructionKind kind,
-  BasicBlockID parent_block_id
+  BasicBlockID parent_block_id,
+  Context& context
 ) {
-  return std::make_shared<Instruction>(id, kind, parent_block_id);
-}
-
-InstructionPtr create_dummy_instruction() {
-  return create_instruction(
-    std::numeric_limits<OperandID>::max(), instruction::Dummy{},
-    std::numeric_limits<BasicBlockID>::max()
-  );
+  return context.get_id_space(id_space_of(id))
+    .instruction_arena.create(id, kind, parent_block_id);
 }
 
 void Instruction::insert_next(InstructionPtr instruction) {
+  // Neighbours are in the same function and so in the same space. The guards
+  // of the blocks have no space, instructions next to them are checked by the
+  // blocks.
+  assert(
+    this->id == std::numeric_limits<InstructionID>::max() ||
+    instruction->id == std::numeric_limits<InstructionID>::max() ||
+    id_space_of(instruction->id) == id_space_of(this->id)
+  );
   instruction->next = this->next;
-  instruction->prev = this->shared_from_this();
+  instruction->prev = this;
 
   if (this->next) {
     this->next->prev = instruction;
@@ -34,10 +38,15 @@ void Instruction::insert_next(InstructionPtr instruction) {
 }
 
 void Instruction::insert_prev(InstructionPtr instruction) {
-  instruction->next = this->shared_from_this();
+  assert(
+    this->id == std::numeric_limits<InstructionID>::max() ||
+    instruction->id == std::numeric_limits<InstructionID>::max() ||
+    id_space_of(instruction->id) == id_space_of(this->id)
+  );
+  instruction->next = this;
   instruction->prev = this->prev;
 
-  if (auto prev = this->prev.lock()) {
+  if (auto prev = this->prev) {
     prev->next = instruction;
   }
 
@@ -48,20 +57,32 @@ void Instruction::set_def(OperandID def_id) {
   this->maybe_def_id = def_id;
 }
 
-void Instruction::add_use(OperandID use_id) {
-  if (std::find(this->use_id_list.begin(), this->use_id_list.end(), use_id) ==
-      this->use_id_list.end()) {
-    this->use_id_list.push_back(use_id);
-  } else {
+void Instruction::add_use(OperandID use_id, Context& context) {
+  auto use = create_use(use_id, this, context);
+  this->use_list.push_back(use);
+  context.operand_table[use_id]->link_use(use);
+}
+
+void Instruction::remove_use(OperandID use_id, Context& context) {
+  auto it = std::find_if(
+    this->use_list.begin(), this->use_list.end(),
+    [use_id](Use* use) { return use->operand_id == use_id; }
+  );
+  if (it == this->use_list.end()) {
     return;
   }
+  auto use = *it;
+  this->use_list.erase(it);
+  context.operand_table[use_id]->unlink_use(use);
+  release_use(use, context);
 }
 
-void Instruction::remove_use(OperandID use_id) {
-  this->use_id_list.erase(
-    std::remove(this->use_id_list.begin(), this->use_id_list.end(), use_id),
-    this->use_id_list.end()
-  );
+void Instruction::remove_all_uses(Context& context) {
+  for (auto use : this->use_list) {
+    context.operand_table[use->operand_id]->unlink_use(use);
+    release_use(use, context);
+  }
+  this->use_list.clear();
 }
 
 void Instruction::replace_operand(
@@ -75,18 +96,28 @@ void Instruction::replace_operand(
     context.operand_table[new_operand_id]->set_def(this->id);
   }
 
-  for (auto& use_id : this->use_id_list) {
-    if (use_id == old_operand_id) {
-      use_id = new_operand_id;
-      context.operand_table[old_operand_id]->remove_use(this->id);
-      context.operand_table[new_operand_id]->add_use(this->id);
+  if (old_operand_id != new_operand_id) {
+    for (auto use : this->use_list) {
+      if (use->operand_id == old_operand_id) {
+        context.operand_table[old_operand_id]->unlink_use(use);
+        use->operand_id = new_operand_id;
+        context.operand_table[new_operand_id]->link_use(use);
+      }
     }
   }
 
+  this->replace_operand_in_kind(old_operand_id, new_operand_id, true);
+}
+
+void Instruction::replace_operand_in_kind(
+  OperandID old_operand_id,
+  OperandID new_operand_id,
+  bool with_def
+) {
   std::visit(
     overloaded{
       [&](instruction::Binary& kind) {
-        if (kind.dst_id == old_operand_id) {
+        if (with_def && kind.dst_id == old_operand_id) {
           kind.dst_id = new_operand_id;
         }
         if (kind.lhs_id == old_operand_id) {
@@ -97,7 +128,7 @@ void Instruction::replace_operand(
         }
       },
       [&](instruction::ICmp& kind) {
-        if (kind.dst_id == old_operand_id) {
+        if (with_def && kind.dst_id == old_operand_id) {
           kind.dst_id = new_operand_id;
         }
         if (kind.lhs_id == old_operand_id) {
@@ -108,7 +139,7 @@ void Instruction::replace_operand(
         }
       },
       [&](instruction::FCmp& kind) {
-        if (kind.dst_id == old_operand_id) {
+        if (with_def && kind.dst_id == old_operand_id) {
           kind.dst_id = new_operand_id;
         }
         if (kind.lhs_id == old_operand_id) {
@@ -119,7 +150,7 @@ void Instruction::replace_operand(
         }
       },
       [&](instruction::Cast& kind) {
-        if (kind.dst_id == old_operand_id) {
+        if (with_def && kind.dst_id == old_operand_id) {
           kind.dst_id = new_operand_id;
         }
         if (kind.src_id == old_operand_id) {
@@ -138,7 +169,7 @@ void Instruction::replace_operand(
       },
       [&](instruction::Br& kind) {},
       [&](instruction::Phi& kind) {
-        if (kind.dst_id == old_operand_id) {
+        if (with_def && kind.dst_id == old_operand_id) {
           kind.dst_id = new_operand_id;
         }
         for (auto& [value_id, block_id] : kind.incoming_list) {
@@ -148,21 +179,15 @@ void Instruction::replace_operand(
         }
       },
       [&](instruction::Alloca& kind) {
-        if (kind.dst_id == old_operand_id) {
+        if (with_def && kind.dst_id == old_operand_id) {
           kind.dst_id = new_operand_id;
         }
-        if (kind.maybe_size_id.has_value() && kind.maybe_size_id.value() == old_operand_id) {
-          kind.maybe_size_id = new_operand_id;
-        }
         if (kind.maybe_align_id.has_value() && kind.maybe_align_id.value() == old_operand_id) {
           kind.maybe_align_id = new_operand_id;
         }
-        if (kind.maybe_addrspace_id.has_value() && kind.maybe_addrspace_id.value() == old_operand_id) {
-          kind.maybe_addrspace_id = new_operand_id;
-        }
       },
       [&](instruction::Load& kind) {
-        if (kind.dst_id == old_operand_id) {
+        if (with_def && kind.dst_id == old_operand_id) {
           kind.dst_id = new_operand_id;
         }
         if (kind.ptr_id == old_operand_id) {
@@ -178,7 +203,8 @@ void Instruction::replace_operand(
         }
       },
       [&](instruction::Call& kind) {
-        if (kind.maybe_dst_id.has_value() && kind.maybe_dst_id.value() == old_operand_id) {
+        if (with_def && kind.maybe_dst_id.has_value() &&
+            kind.maybe_dst_id.value() == old_operand_id) {
           kind.maybe_dst_id = new_operand_id;
         }
         for (auto& arg_id : kind.arg_id_list) {
@@ -188,7 +214,7 @@ void Instruction::replace_operand(
         }
       },
       [&](instruction::GetElementPtr& kind) {
-        if (kind.dst_id == old_operand_id) {
+        if (with_def && kind.dst_id == old_operand_id) {
           kind.dst_id = new_operand_id;
         }
         if (kind.ptr_id == old_operand_id) {
@@ -207,32 +233,11 @@ void Instruction::replace_operand(
 }
 
 void Instruction::remove(Context& context) {
+  this->remove_all_uses(context);
+
   std::visit(
     overloaded{
-      [this, &context](const instruction::Binary& kind) {
-        context.operand_table[kind.lhs_id]->remove_use(this->id);
-        context.operand_table[kind.rhs_id]->remove_use(this->id);
-      },
-      [this, &context](const instruction::ICmp& kind) {
-        context.operand_table[kind.lhs_id]->remove_use(this->id);
-        context.operand_table[kind.rhs_id]->remove_use(this->id);
-      },
-      [this, &context](const instruction::FCmp& kind) {
-        context.operand_table[kind.lhs_id]->remove_use(this->id);
-        context.operand_table[kind.rhs_id]->remove_use(this->id);
-      },
-      [this, &context](const instruction::Cast& kind) {
-        context.operand_table[kind.src_id]->remove_use(this->id);
-      },
-      [this, &context](const instruction::Ret& kind) {
-        if (kind.maybe_value_id.has_value()) {
-          context.operand_table[kind.maybe_value_id.value()]->remove_use(
-            this->id
-          );
-        }
-      },
       [this, &context](const instruction::CondBr& kind) {
-        context.operand_table[kind.cond_id]->remove_use(this->id);
         context.basic_block_table[kind.then_block_id]->remove_use(this->id);
         context.basic_block_table[kind.else_block_id]->remove_use(this->id);
 
@@ -262,65 +267,18 @@ void Instruction::remove(Context& context) {
       },
       [this, &context](const instruction::Phi& kind) {
         for (auto [operand_id, basic_block_id] : kind.incoming_list) {
-          context.operand_table[operand_id]->remove_use(this->id);
           context.basic_block_table[basic_block_id]->remove_use(this->id);
         }
       },
-      [this, &context](const instruction::Alloca& kind) {
-        if (kind.maybe_size_id.has_value()) {
-          context.operand_table[kind.maybe_size_id.value()]->remove_use(this->id
-          );
-        }
-        if (kind.maybe_align_id.has_value()) {
-          context.operand_table[kind.maybe_align_id.value()]->remove_use(
-            this->id
-          );
-        }
-        if (kind.maybe_addrspace_id.has_value()) {
-          context.operand_table[kind.maybe_addrspace_id.value()]->remove_use(
-            this->id
-          );
-        }
-      },
-      [this, &context](const instruction::Load& kind) {
-        context.operand_table[kind.ptr_id]->remove_use(this->id);
-        if (kind.maybe_align_id.has_value()) {
-          context.operand_table[kind.maybe_align_id.value()]->remove_use(
-            this->id
-          );
-        }
-      },
-      [this, &context](const instruction::Store& kind) {
-        context.operand_table[kind.value_id]->remove_use(this->id);
-        context.operand_table[kind.ptr_id]->remove_use(this->id);
-        if (kind.maybe_align_id.has_value()) {
-          context.operand_table[kind.maybe_align_id.value()]->remove_use(
-            this->id
-          );
-        }
-      },
       [this, &context](const instruction::Call& kind) {
-        if (kind.maybe_dst_id.has_value()) {
-          context.operand_table[kind.maybe_dst_id.value()]->remove_use(this->id
-          );
-        }
-        context.function_table[kind.function_name]->remove_caller(this->id);
-        for (auto arg_id : kind.arg_id_list) {
-          context.operand_table[arg_id]->remove_use(this->id);
-        }
+        kind.callee->remove_caller(this->id);
       },
-      [this, &context](const instruction::GetElementPtr& kind) {
-        context.operand_table[kind.ptr_id]->remove_use(this->id);
-        for (auto index_id : kind.index_id_list) {
-          context.operand_table[index_id]->remove_use(this->id);
-        }
-      },
-      [this, &context](const instruction::Dummy& kind) {},
+      [](const auto& kind) {},
     },
     this->kind
   );
 
-  if (auto prev = this->prev.lock()) {
+  if (auto prev = this->prev) {
     prev->next = this->next;
   }
   if (this->next) {
@@ -329,7 +287,7 @@ void Instruction::remove(Context& context) {
 }
 
 void Instruction::raw_remove() {
-  if (auto prev = this->prev.lock()) {
+  if (auto prev = this->prev) {
     prev->next = this->next;
   }
   if (this->next) {
@@ -401,9 +359,8 @@ void Instruction::add_phi_operand(
   }
   std::get<instruction::Phi>(this->kind)
     .incoming_list.emplace_back(incoming_operand_id, incoming_block_id);
-  context.operand_table[incoming_operand_id]->add_use(this->id);
   context.basic_block_table[incoming_block_id]->add_use(this->id);
-  this->add_use(incoming_operand_id);
+  this->add_use(incoming_operand_id, context);
 }
 
 std::optional<OperandID> Instruction::remove_phi_operand(
@@ -426,17 +383,20 @@ std::optional<OperandID> Instruction::remove_phi_operand(
     return std::nullopt;
   }
 
-  auto operand_id = std::get<0>(*it);
-  context.operand_table[operand_id]->remove_use(this->id);
+  auto incoming = *it;
+  auto operand_id = std::get<0>(incoming);
+  size_t erased_count =
+    std::count(incoming_list.begin(), incoming_list.end(), incoming);
   context.basic_block_table[incoming_block_id]->remove_use(this->id);
-  this->remove_use(operand_id);
-  
-  // Erase from the incoming list
+
+  // Erase from the incoming list, and one use for each erased entry
   incoming_list.erase(
-    std::remove(incoming_list.begin(), incoming_list.end(), *it),
+    std::remove(incoming_list.begin(), incoming_list.end(), incoming),
     incoming_list.end()
   );
-
+  for (size_t i = 0; i < erased_count; i++) {
+    this->remove_use(operand_id, context);
+  }
 
   return operand_id;
 }
@@ -446,7 +406,11 @@ Instruction::Instruction(
   InstructionKind kind,
   BasicBlockID parent_block_id
 )
-  : id(id), kind(kind), parent_block_id(parent_block_id), next(nullptr) {}
+  : id(id),
+    kind(kind),
+    parent_block_id(parent_block_id),
+    next(nullptr),
+    prev(nullptr) {}
 
 std::string Instruction::to_string(Context& context) {
   using namespace instruction;
@@ -702,14 +666,6 @@ std::string Instruction::to_string(Context& context) {
         auto allocated_type_str = instruction.allocated_type->to_string();
         auto result = dst_str + " = alloca " + allocated_type_str;
 
-        if (instruction.maybe_size_id.has_value()) {
-          auto size = context.get_operand(instruction.maybe_size_id.value());
-          auto size_type_str = size->get_type()->to_string();
-          auto size_str = size->to_string();
-
-          result += ", " + size_type_str + " " + size_str;
-        }
-
         if (instruction.maybe_align_id.has_value()) {
           auto align_str =
             context.get_operand(instruction.maybe_align_id.value())
@@ -717,13 +673,6 @@ std::string Instruction::to_string(Context& context) {
           result += ", align " + align_str;
         }
 
-        if (instruction.maybe_addrspace_id.has_value()) {
-          auto addrspace_str =
-            context.get_operand(instruction.maybe_addrspace_id.value())
-              ->to_string();
-          result += ", addrspace(" + addrspace_str + ")";
-        }
-
         return result;
       },
       [&context](const Load& instruction) {
@@ -769,12 +718,10 @@ std::string Instruction::to_string(Context& context) {
         return result;
       },
       [&context](const Call& instruction) {
-        auto function = context.get_function(instruction.function_name);
-
-        auto return_type_str = function->return_type->to_string();
+        auto return_type_str = instruction.callee->return_type->to_string();
 
         auto result =
-          "call " + return_type_str + " @" + instruction.function_name + "(";
+          "call " + return_type_str + " @" + instruction.callee->name + "(";
 
         for (auto& operand_id : instruction.arg_id_list) {
           auto operand = context.get_operand(operand_id);
@@ -826,10 +773,10 @@ std::string Instruction::to_string(Context& context) {
     kind
   );
 
-  result += "\t; parent: " + std::to_string(this->parent_block_id);
+  result += "\t; parent: " + id_to_string(this->parent_block_id);
 
   return result;
 }
 
 }  // namespace ir
-}  // namespace syc
\ No newline at end of file
+}  // namespace syc
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define SYC_IR_INSTRUCTION_H_
 
 #include "common.h"
+#include "small_list.h"
 
 namespace syc {
 namespace ir {
@@ -185,7 +186,7 @@ struct Phi {
   /// List of incoming operands.
   ///
   /// This is a list of (operand ID, block ID) pairs.
-  std::vector<std::tuple<OperandID, BasicBlockID>> incoming_list;
+  SmallList<std::tuple<OperandID, BasicBlockID>, 2> incoming_list;
 
   bool operator==(const Phi& other) const {
     return incoming_list == other.incoming_list;
@@ -198,20 +199,14 @@ struct Alloca {
   OperandID dst_id;
   /// Type of the allocated memory.
   TypePtr allocated_type;
-  /// Size of the allocated memory.
-  std::optional<OperandID> maybe_size_id;
   /// Alignment size of the allocated memory.
   std::optional<OperandID> maybe_align_id;
-  /// Address space of the allocated memory.
-  std::optional<OperandID> maybe_addrspace_id;
   /// If the address is for parameter
   bool alloca_for_param;
 
   bool operator==(const Alloca& other) const {
     return allocated_type == other.allocated_type &&
-           maybe_size_id == other.maybe_size_id &&
            maybe_align_id == other.maybe_align_id &&
-           maybe_addrspace_id == other.maybe_addrspace_id &&
            alloca_for_param == other.alloca_for_param;
   }
 };
@@ -249,14 +244,13 @@ struct Store {
 struct Call {
   /// Destination operand ID.
   std::optional<OperandID> maybe_dst_id;
-  /// Function operand ID.
-  std::string function_name;
+  /// Called function, owned by the function table of the context.
+  Function* callee;
   /// List of argument operand IDs.
-  std::vector<OperandID> arg_id_list;
+  SmallList<OperandID, 2> arg_id_list;
 
   bool operator==(const Call& other) const {
-    return function_name == other.function_name &&
-           arg_id_list == other.arg_id_list;
+    return callee == other.callee && arg_id_list == other.arg_id_list;
   }
 };
 
@@ -269,7 +263,7 @@ struct GetElementPtr {
   /// Pointer operand ID.
   OperandID ptr_id;
   /// List of indices.
-  std::vector<OperandID> index_id_list;
+  SmallList<OperandID, 2> index_id_list;
 
   bool operator==(const GetElementPtr& other) const {
     return basis_type == other.basis_type && ptr_id == other.ptr_id &&
@@ -286,7 +280,8 @@ struct Dummy {
 
 /// Instruction
 /// Instruction is stored in a bidirectional linked list.
-struct Instruction : std::enable_shared_from_this<Instruction> {
+/// The instruction is owned by the arena in the context.
+struct Instruction {
   /// Instruction ID in the context
   InstructionID id;
   /// Instruction kind.
@@ -299,12 +294,18 @@ struct Instruction : std::enable_shared_from_this<Instruction> {
   InstructionPrevPtr prev;
 
   std::optional<OperandID> maybe_def_id;
-  std::vector<OperandID> use_id_list;
+  /// Uses of the operands, one for each operand slot, see `Use`.
+  SmallList<Use*, 2> use_list;
 
   void set_def(OperandID def_id);
-  void add_use(OperandID use_id);
+  /// Create a use of the operand and link it to the operand.
+  void add_use(OperandID use_id, Context& context);
 
-  void remove_use(OperandID use_id);
+  /// Unlink and release one use of the operand.
+  void remove_use(OperandID use_id, Context& context);
+
+  /// Unlink and release all the uses.
+  void remove_all_uses(Context& context);
 
   void replace_operand(
     OperandID old_operand_id,
@@ -312,6 +313,14 @@ struct Instruction : std::enable_shared_from_this<Instruction> {
     Context& context
   );
 
+  /// Replace the operand in the fields of the kind, and in the destination
+  /// only if `with_def`. Neither the uses nor the definition are updated.
+  void replace_operand_in_kind(
+    OperandID old_operand_id,
+    OperandID new_operand_id,
+    bool with_def
+  );
+
   /// Constructor
   Instruction(
     InstructionID id,
@@ -319,6 +328,9 @@ struct Instruction : std::enable_shared_from_this<Instruction> {
     BasicBlockID parent_block_id
   );
 
+  Instruction(const Instruction&) = delete;
+  Instruction& operator=(const Instruction&) = delete;
+
   /// Insert the instruction after the current instruction.
   /// Note that if the instruction is a terminator, insertion will not do
   /// anything.
@@ -392,17 +404,15 @@ struct Instruction : std::enable_shared_from_this<Instruction> {
   bool operator==(const Instruction& other) const { return kind == other.kind; }
 };
 
-/// Create an instruction.
+/// Create an instruction in the arena of the context.
 /// Return the pointer to the created instruction.
 InstructionPtr create_instruction(
   InstructionID id,
   InstructionKind kind,
-  BasicBlockID parent_block_id
+  BasicBlockID parent_block_id,
+  Context& context
 );
 
-/// Create a dummy instruction.
-InstructionPtr create_dummy_instruction();
-
 }  // namespace ir
 }  // namespace syc
 
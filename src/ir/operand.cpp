@@ -1,5 +1,8 @@
 #include "ir/operand.h"
 #include <sstream>
+#include "dense_table.h"
+#include "ir/context.h"
+#include "ir/instruction.h"
 #include "ir/operand.h"
 #include "ir/type.h"
 
@@ -7,37 +10,39 @@ namespace syc {
 
 namespace ir {
 
-std::string operand::Constant::to_string(bool with_type) const {
-  std::stringstream buf;
-
+void operand::Constant::emit(Emitter& out, bool with_type) const {
   if (with_type) {
-    buf << this->type->to_string() << " ";
+    out << this->type->to_string() << " ";
   }
 
   std::visit(
     overloaded{
-      [&](int v) { buf << v; },
+      [&](int v) { out << v; },
       [&](float v) {
         double v_double = static_cast<double>(v);
         uint64_t v_hexadecimal = *reinterpret_cast<uint64_t*>(&v_double);
-        buf << "0x" << std::hex << std::uppercase << v_hexadecimal;
+        out.hex(v_hexadecimal, 0, true);
       },
-      [&](Zeroinitializer v) { buf << "zeroinitializer"; },
+      [&](Zeroinitializer v) { out << "zeroinitializer"; },
       [&](const std::vector<ConstantPtr>& v) {
-        buf << "[";
+        out << "[";
         for (size_t i = 0; i < v.size(); i++) {
-          buf << v[i]->to_string(true);
+          v[i]->emit(out, true);
           if (i != v.size() - 1) {
-            buf << ", ";
+            out << ", ";
           }
         }
-        buf << "]";
+        out << "]";
       },
     },
     this->kind
   );
+}
 
-  return buf.str();
+std::string operand::Constant::to_string(bool with_type) const {
+  Emitter out;
+  emit(out, with_type);
+  return out.str();
 }
 
 bool operand::Constant::is_zero() const {
@@ -63,29 +68,38 @@ bool operand::Constant::get_bool_value() const {
   );
 }
 
+std::mutex Operand::shared_use_mutex;
+
 Operand::Operand(OperandID id, TypePtr type, OperandKind kind)
   : id(id), type(type), kind(kind), maybe_def_id(std::nullopt) {}
 
-std::string Operand::to_string(bool with_type) const {
+void Operand::emit(Emitter& out, bool with_type) const {
   using namespace operand;
-  return std::visit(
+  std::visit(
     overloaded{
-      [](const Global& k) { return "@" + k.name; },
-      [=](ConstantPtr k) { return k->to_string(with_type); },
-      [](const Parameter& k) { return "%" + k.name; },
-      [this](const Arbitrary& k) { return "%t" + std::to_string(id); },
+      [&](const Global& k) { out << "@" << k.name; },
+      [&](ConstantPtr k) { k->emit(out, with_type); },
+      [&](const Parameter& k) { out << "%" << k.name; },
+      [&](const Arbitrary& k) {
+        out << "%t";
+        out.id(id);
+      },
     },
     kind
   );
 }
 
+std::string Operand::to_string(bool with_type) const {
+  Emitter out;
+  emit(out, with_type);
+  return out.str();
+}
+
 TypePtr Operand::get_type() const {
   using namespace operand;
   return std::visit(
     overloaded{
-      [this](const Global& k) {
-        return std::make_shared<Type>(type::Pointer{});
-      },
+      [this](const Global& k) { return get_pointer_type(); },
       [this](const auto& k) { return type; }},
     kind
   );
@@ -94,19 +108,56 @@ void Operand::set_def(InstructionID def_id) {
   this->maybe_def_id = def_id;
 }
 
-void Operand::add_use(InstructionID use_id) {
-  use_id_list.push_back(use_id);
+void Operand::link_use(Use* use) {
+  if (is_shared()) {
+    std::lock_guard<std::mutex> lock(shared_use_mutex);
+    use_id_list.push_back(use);
+    return;
+  }
+  use_id_list.push_back(use);
 }
 
 void Operand::remove_def() {
   this->maybe_def_id = std::nullopt;
 }
 
-void Operand::remove_use(InstructionID use_id) {
-  this->use_id_list.erase(
-    std::remove(this->use_id_list.begin(), this->use_id_list.end(), use_id),
-    this->use_id_list.end()
-  );
+void Operand::unlink_use(Use* use) {
+  if (is_shared()) {
+    std::lock_guard<std::mutex> lock(shared_use_mutex);
+    this->use_id_list.remove(use);
+    return;
+  }
+  this->use_id_list.remove(use);
+}
+
+void Operand::replace_all_uses_with(
+  OperandID new_operand_id,
+  Context& context
+) {
+  if (new_operand_id == this->id) {
+    return;
+  }
+  auto new_operand = context.operand_table[new_operand_id];
+
+  std::unique_lock<std::mutex> lock(shared_use_mutex, std::defer_lock);
+  if (this->is_shared() || new_operand->is_shared()) {
+    lock.lock();
+  }
+  // Other threads may link uses of a shared operand, so its use list is only
+  // read under the lock.
+  if (this->use_id_list.empty()) {
+    return;
+  }
+
+  // Rewrite the slots before the splice, the uses of this operand are exactly
+  // the ones to rewrite. A user with several uses is rewritten once for each,
+  // the later ones find nothing left to replace.
+  for (auto use = this->use_id_list.head; use; use = use->next) {
+    use->operand_id = new_operand_id;
+    use->user->replace_operand_in_kind(this->id, new_operand_id, false);
+  }
+
+  new_operand->use_id_list.splice_back(this->use_id_list);
 }
 
 bool Operand::is_constant() const {
@@ -136,6 +187,10 @@ bool Operand::is_global() const {
   return std::holds_alternative<operand::Global>(kind);
 }
 
+bool Operand::is_shared() const {
+  return is_constant() || is_global();
+}
+
 }  // namespace ir
 
 }  // namespace syc
\ No newline at end of file
@@ -1,7 +1,11 @@
 #ifndef SYC_IR_OPERAND_H_
 #define SYC_IR_OPERAND_H_
 
+#include <mutex>
+
 #include "common.h"
+#include "emitter.h"
+#include "ir/use.h"
 
 namespace syc {
 namespace ir {
@@ -27,6 +31,9 @@ struct Constant {
   /// Type of the constant.
   TypePtr type;
 
+  /// Emit the constant, with the type before it if `with_type`.
+  void emit(Emitter& out, bool with_type = false) const;
+
   std::string to_string(bool with_type = false) const;
 
   bool get_bool_value() const;
@@ -43,8 +50,6 @@ struct Parameter {
 /// Arbitrary operand/variable.
 struct Arbitrary {};
 
-using OperandPtr = std::shared_ptr<Operand>;
-
 }  // namespace operand
 
 /// Operand
@@ -57,12 +62,23 @@ struct Operand {
   OperandKind kind;
   /// ID of the instruction that defines this operand.
   std::optional<InstructionID> maybe_def_id;
-  /// IDs of the instructions that use this operand.
-  std::vector<InstructionID> use_id_list;
+  /// Uses of this operand, one for each operand slot of the instructions.
+  /// Iterating the list yields the IDs of the instructions, see `UseList`.
+  UseList use_id_list;
+
+  /// Constants and globals may be used by several functions that are built on
+  /// different threads, so their use lists are only updated under this lock.
+  /// Reads are not locked: function passes must not read the use lists of
+  /// shared operands (see `is_shared`), only module passes, which run alone,
+  /// may.
+  static std::mutex shared_use_mutex;
 
   /// Constructor
   Operand(OperandID id, TypePtr type, OperandKind kind);
 
+  /// Emit the representation of the operand (in llvm ir).
+  void emit(Emitter& out, bool with_type = false) const;
+
   /// Get the stringified representation of the operand (in llvm ir).
   std::string to_string(bool with_type = false) const;
 
@@ -73,11 +89,19 @@ struct Operand {
 
   void set_def(InstructionID def_id);
 
-  void add_use(InstructionID use_id);
+  /// Link a use of this operand, only called by the user.
+  void link_use(Use* use);
 
   void remove_def();
 
-  void remove_use(InstructionID use_id);
+  /// Unlink a use of this operand, only called by the user.
+  void unlink_use(Use* use);
+
+  /// Replace all the uses of this operand by another operand.
+  /// The uses are moved to the other operand in one splice and the operand
+  /// slots of the users are rewritten, so this takes time linear in the
+  /// number of uses. The definition of this operand is left alone.
+  void replace_all_uses_with(OperandID new_operand_id, Context& context);
 
   bool is_constant() const;
 
@@ -90,6 +114,9 @@ struct Operand {
   bool is_zero() const;
 
   bool is_global() const;
+
+  /// If the operand may be used by more than one function.
+  bool is_shared() const;
 };
 
 }  // namespace ir
@@ -43,7 +43,7 @@ bool operator==(const Type& lhs, const Type& rhs) {
 }
 
 bool operator==(TypePtr lhs, TypePtr rhs) {
-  return *lhs == *rhs;
+  return lhs.get() == rhs.get();
 }
 
 bool operator!=(const Type& lhs, const Type& rhs) {
@@ -74,5 +74,30 @@ size_t get_size(TypePtr type) {
   return type->get_size();
 }
 
+TypePtr get_void_type() {
+  static const TypePtr void_type = std::make_shared<Type>(type::Void{});
+  return void_type;
+}
+
+TypePtr get_i1_type() {
+  static const TypePtr i1_type = std::make_shared<Type>(type::Integer{1});
+  return i1_type;
+}
+
+TypePtr get_i32_type() {
+  static const TypePtr i32_type = std::make_shared<Type>(type::Integer{32});
+  return i32_type;
+}
+
+TypePtr get_float_type() {
+  static const TypePtr float_type = std::make_shared<Type>(type::Float{});
+  return float_type;
+}
+
+TypePtr get_pointer_type() {
+  static const TypePtr pointer_type = std::make_shared<Type>(type::Pointer{});
+  return pointer_type;
+}
+
 }  // namespace ir
 }  // namespace syc
\ No newline at end of file
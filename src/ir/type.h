@@ -36,12 +36,23 @@ struct Type {
   std::optional<T> as();
 };
 
+/// Structural equality.
 bool operator==(const Type& lhs, const Type& rhs);
+/// Types are interned, so shared types are equal iff they are the same.
 bool operator==(TypePtr lhs, TypePtr rhs);
 
 bool operator!=(const Type& lhs, const Type& rhs);
 bool operator!=(TypePtr lhs, TypePtr rhs);
 
+/// Get the unique instance of a primitive type.
+/// Primitive types are immutable, so one instance is shared by all the
+/// contexts. Array types are uniqued by `Context::fetch_array_type`.
+TypePtr get_void_type();
+TypePtr get_i1_type();
+TypePtr get_i32_type();
+TypePtr get_float_type();
+TypePtr get_pointer_type();
+
 size_t get_size(TypePtr type);
 
 template <typename T>
@@ -0,0 +1,40 @@
+#include "ir/use.h"
+#include "ir/context.h"
+#include "ir/instruction.h"
+
+namespace syc {
+namespace ir {
+
+thread_local size_t worker_id_space = NO_WORKER_ID_SPACE;
+
+InstructionID UseList::Iterator::operator*() const {
+  return curr->user->id;
+}
+
+Use* create_use(OperandID operand_id, InstructionPtr user, Context& context) {
+  assert(
+    worker_id_space == NO_WORKER_ID_SPACE ||
+    id_space_of(user->id) == worker_id_space
+  );
+  auto& id_space = context.get_id_space(id_space_of(user->id));
+  if (id_space.free_use_list.empty()) {
+    return id_space.use_arena.create(operand_id, user);
+  }
+  auto use = id_space.free_use_list.back();
+  id_space.free_use_list.pop_back();
+  use->operand_id = operand_id;
+  use->user = user;
+  return use;
+}
+
+void release_use(Use* use, Context& context) {
+  assert(
+    worker_id_space == NO_WORKER_ID_SPACE ||
+    id_space_of(use->user->id) == worker_id_space
+  );
+  auto& id_space = context.get_id_space(id_space_of(use->user->id));
+  id_space.free_use_list.push_back(use);
+}
+
+}  // namespace ir
+}  // namespace syc
@@ -0,0 +1,164 @@
+#ifndef SYC_IR_USE_H_
+#define SYC_IR_USE_H_
+
+#include "common.h"
+
+namespace syc {
+namespace ir {
+
+/// Use of an operand by an instruction.
+///
+/// Every operand slot of an instruction has its own use, so an instruction
+/// using the same operand twice (e.g. `mul %1, %1`) holds two uses. The uses
+/// of an operand are linked into its `UseList`, and the instruction keeps its
+/// own uses in `Instruction::use_list`.
+///
+/// Uses are stored in the ID space of the user and recycled once released, so
+/// rewriting the operands of an instruction does not allocate.
+struct Use {
+  /// ID of the used operand.
+  OperandID operand_id;
+  /// Instruction using the operand.
+  InstructionPtr user;
+  /// Neighbours in the use list of the operand.
+  Use* prev = nullptr;
+  Use* next = nullptr;
+
+  Use(OperandID operand_id, InstructionPtr user)
+    : operand_id(operand_id), user(user) {}
+};
+
+/// Intrusive doubly linked list of the uses of an operand.
+///
+/// Linking and unlinking a use are constant time, and all the uses of an
+/// operand are moved to another operand with one splice, see
+/// `Operand::replace_all_uses_with`. Iterating the list yields the ID of the
+/// user of each use, in the order the uses were linked.
+struct UseList {
+  Use* head = nullptr;
+  Use* tail = nullptr;
+  /// Number of linked uses.
+  size_t count = 0;
+
+  /// Iterator over the IDs of the users.
+  struct Iterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = InstructionID;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const InstructionID*;
+    using reference = InstructionID;
+
+    const Use* curr;
+
+    InstructionID operator*() const;
+
+    Iterator& operator++() {
+      curr = curr->next;
+      return *this;
+    }
+
+    bool operator==(const Iterator& other) const { return curr == other.curr; }
+    bool operator!=(const Iterator& other) const { return curr != other.curr; }
+  };
+
+  Iterator begin() const { return Iterator{head}; }
+  Iterator end() const { return Iterator{nullptr}; }
+
+  size_t size() const { return count; }
+
+  bool empty() const { return count == 0; }
+
+  /// The user of the first use.
+  InstructionID front() const { return *begin(); }
+
+  /// If the instruction uses the operand.
+  bool contains(InstructionID id) const {
+    return std::find(begin(), end(), id) != end();
+  }
+
+  /// Copy the IDs of the users, for iterating while the list is modified.
+  std::vector<InstructionID> to_vector() const {
+    return std::vector<InstructionID>(begin(), end());
+  }
+
+  /// Link a use at the end of the list.
+  void push_back(Use* use) {
+    use->prev = tail;
+    use->next = nullptr;
+    if (tail) {
+      tail->next = use;
+    } else {
+      head = use;
+    }
+    tail = use;
+    count++;
+  }
+
+  /// Unlink a use of the list.
+  void remove(Use* use) {
+    if (use->prev) {
+      use->prev->next = use->next;
+    } else {
+      head = use->next;
+    }
+    if (use->next) {
+      use->next->prev = use->prev;
+    } else {
+      tail = use->prev;
+    }
+    use->prev = nullptr;
+    use->next = nullptr;
+    count--;
+  }
+
+  /// Move all the uses of another list to the end of this one.
+  void splice_back(UseList& other) {
+    if (other.head == nullptr) {
+      return;
+    }
+    if (tail) {
+      tail->next = other.head;
+      other.head->prev = tail;
+    } else {
+      head = other.head;
+    }
+    tail = other.tail;
+    count += other.count;
+
+    other.head = nullptr;
+    other.tail = nullptr;
+    other.count = 0;
+  }
+};
+
+/// Value of `worker_id_space` outside of the function passes.
+constexpr size_t NO_WORKER_ID_SPACE = std::numeric_limits<size_t>::max();
+
+/// ID space of the function the function passes on this thread run on, or
+/// `NO_WORKER_ID_SPACE` outside of them.
+///
+/// Uses are taken from and given back to the space of their user without a
+/// lock, so a worker must only create and release the uses of its own
+/// function. `create_use` and `release_use` assert this.
+extern thread_local size_t worker_id_space;
+
+/// Set `worker_id_space` for the lifetime of the scope.
+struct WorkerIdSpaceScope {
+  explicit WorkerIdSpaceScope(size_t space) { worker_id_space = space; }
+  ~WorkerIdSpaceScope() { worker_id_space = NO_WORKER_ID_SPACE; }
+
+  WorkerIdSpaceScope(const WorkerIdSpaceScope&) = delete;
+  WorkerIdSpaceScope& operator=(const WorkerIdSpaceScope&) = delete;
+};
+
+/// Create a use of an operand in the ID space of the user, reusing a released
+/// use if there is one. The use is not linked.
+Use* create_use(OperandID operand_id, InstructionPtr user, Context& context);
+
+/// Give an unlinked use back to the ID space of its user.
+void release_use(Use* use, Context& context);
+
+}  // namespace ir
+}  // namespace syc
+
+#endif
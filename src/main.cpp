@@ -1,6 +1,8 @@
 #include <fstream>
 #include <iostream>
 #include "backend/builder.h"
+#include "compile_cache.h"
+#include "emitter.h"
 #include "frontend/driver.h"
 #include "frontend/irgen.h"
 #include "ir/builder.h"
@@ -11,6 +13,7 @@
 #include "passes/asm/fast_divmod.h"
 #include "passes/asm/instr_fuse.h"
 #include "passes/asm/lvn.h"
+#include "passes/asm/pass_manager.h"
 #include "passes/asm/peephole.h"
 #include "passes/asm/peephole_final.h"
 #include "passes/asm/peephole_second.h"
@@ -29,6 +32,7 @@
 #include "passes/ir/loop_unrolling.h"
 #include "passes/ir/math_opt.h"
 #include "passes/ir/mem2reg.h"
+#include "passes/ir/pass_manager.h"
 #include "passes/ir/peephole.h"
 #include "passes/ir/purity_opt.h"
 #include "passes/ir/store_elim.h"
@@ -36,22 +40,41 @@
 #include "passes/ir/strength_reduce.h"
 #include "passes/ir/tco.h"
 #include "passes/ir/unreach_elim.h"
+#include "parallel.h"
+#include "statistics.h"
 #include "utils.h"
 
-int main(int argc, char* argv[]) {
-  using namespace syc;
+namespace syc {
 
-  auto options = parse_args(argc, argv);
+/// Compile one file with the options, and add the counts of the compile cache
+/// to `cache_counts`. Returns the exit code.
+int compile(const Options& options, CacheCounts& cache_counts) {
+  auto& statistics = get_statistics();
 
-  frontend::Driver parse_driver(options.input_filename);
+  // The AST is only needed until the IR is generated.
+  auto parse_driver = std::make_unique<frontend::Driver>(
+    options.input_filename, options.token_file.has_value()
+  );
 
-  int parse_success = parse_driver.parser->parse();
+  int parse_success = 0;
+  time_pass(
+    "frontend.parse", [&]() { parse_success = parse_driver->parser->parse(); },
+    []() { return size_t(0); }
+  );
 
-  auto& compunit = parse_driver.compunit;
+  auto& compunit = parse_driver->compunit;
+
+  if (statistics.enabled) {
+    CountList count_list = {
+      {"frontend.token_text_bytes", parse_driver->tokens.capacity()},
+      {"frontend.interned_identifiers", parse_driver->interner.size()}};
+    compunit.count_nodes(count_list);
+    statistics.add_memory_snapshot("frontend", std::move(count_list));
+  }
 
   if (options.token_file.has_value()) {
     std::ofstream token_file(options.token_file.value());
-    token_file << parse_driver.tokens;
+    token_file << parse_driver->tokens;
   }
 
   if (options.ast_file.has_value()) {
@@ -60,76 +83,151 @@ int main(int argc, char* argv[]) {
   }
 
   auto ir_builder = ir::Builder();
+  auto pass_manager = ir::PassManager(ir_builder);
+  pass_manager.thread_count = options.thread_count;
 
-  irgen(compunit, ir_builder);
-
-  bool aggressive_opt = options.aggressive_opt;
-  aggressive_opt = true;
-
-  if (options.optimization_level > 0) {
-    ir::mem2reg(ir_builder);
-    ir::func_ret_opt(ir_builder);
-    ir::purity_opt(ir_builder);
-    ir::auto_inline(ir_builder);
-    ir::global2local(ir_builder);
-    ir::mem2reg(ir_builder);
-    ir::gvn(ir_builder, aggressive_opt);
-    ir::load_elim(ir_builder);
-    ir::loop_invariant_motion(ir_builder);
-    ir::peephole(ir_builder);
-    ir::unreach_elim(ir_builder);
-    ir::straighten(ir_builder);
-    for (int i = 0; i < 3; i++) {
-      ir::peephole(ir_builder);
-      ir::dce(ir_builder);
-    }
-    ir::math_opt(ir_builder);
-    ir::dce(ir_builder);
-    ir::copyprop(ir_builder);
-    ir::peephole(ir_builder);
-    ir::loop_unrolling(ir_builder);
-    ir::copyprop(ir_builder);
-    ir::gvn(ir_builder, aggressive_opt);
-    ir::copyprop(ir_builder);
-    ir::load_elim(ir_builder);
-    ir::loop_invariant_motion(ir_builder);
-    ir::peephole(ir_builder);
-    ir::unreach_elim(ir_builder);
-    ir::straighten(ir_builder);
-    for (int i = 0; i < 3; i++) {
-      ir::peephole(ir_builder);
-      ir::dce(ir_builder);
-    }
-    ir::loop_indvar_simplify(ir_builder);
-    ir::math_opt(ir_builder);
-    ir::straighten(ir_builder);
-    ir::gvn(ir_builder, aggressive_opt);
-    ir::peephole(ir_builder);
-    ir::dce(ir_builder);
-    ir::copyprop(ir_builder);
-    ir::math_opt(ir_builder);
-    ir::dce(ir_builder);
-    ir::store_elim(ir_builder);
-    ir::dce(ir_builder);
-    ir::loop_indvar_simplify(ir_builder);
-    ir::dce(ir_builder);
-    ir::straighten(ir_builder);
-    ir::strength_reduce(ir_builder);
-    ir::tco(ir_builder);
-    ir::unreach_elim(ir_builder);
-    ir::loop_invariant_motion(ir_builder);
-    for (int i = 0; i < 3; i++) {
-      ir::peephole(ir_builder);
-      ir::dce(ir_builder);
-    }
-    ir::straighten(ir_builder);
-    ir::strength_reduce(ir_builder);
-    ir::dce(ir_builder);
+  pass_manager.run(
+    "irgen", [&](ir::Builder& builder) { irgen(compunit, builder); },
+    ir::CfgEffect::Change
+  );
+
+  // Free the AST and the symbol tables in bulk.
+  parse_driver.reset();
+
+  auto level = options.optimization_level;
+  // -O3 always optimizes the memory accesses aggressively.
+  bool aggressive_opt = options.aggressive_opt || level >= 3;
+
+  // -O2 only inlines small functions and unrolls short loops, -O3 has no
+  // limit. The options override the growth and add a time limit.
+  ir::InlineBudget inline_budget;
+  ir::LoopUnrollingBudget unrolling_budget;
+  if (level == 2) {
+    inline_budget.max_callee_size = 64;
+    inline_budget.max_growth = 4096;
+    unrolling_budget.max_trip_count = 32;
+    unrolling_budget.max_growth = 512;
+  }
+  if (options.inline_budget.has_value()) {
+    inline_budget.max_growth = options.inline_budget.value();
+  }
+  if (options.unroll_budget.has_value()) {
+    unrolling_budget.max_growth = options.unroll_budget.value();
+  }
+  if (options.opt_time_budget_ms.has_value()) {
+    inline_budget.max_seconds = options.opt_time_budget_ms.value() / 1000.0;
+    unrolling_budget.max_seconds = inline_budget.max_seconds;
+  }
+
+  // Peephole exposes dead code and the other way around, so they are run
+  // until neither changes anything.
+  ir::PassManager::FixpointGroup peephole_dce = {
+    {"peephole", ir::peephole_function},
+    {"dce", ir::dce_function},
+  };
+
+  if (level == 1) {
+    // Only promote the variables to registers and clean up each function.
+    pass_manager.run_function_pass("mem2reg", ir::mem2reg_function);
+    pass_manager.run_function_pass("peephole", ir::peephole_function);
+    pass_manager.run_function_pass("unreach_elim", ir::unreach_elim_function);
+    pass_manager.run_function_pass("straighten", ir::straighten_function);
+    pass_manager.run_fixpoint_group("peephole_dce", peephole_dce);
+    pass_manager.run_function_pass("copyprop", ir::copyprop_function);
+    pass_manager.run_function_pass("dce", ir::dce_function);
+  } else if (level >= 2) {
+    auto gvn = [&](
+                 ir::FunctionPtr function, ir::Builder& builder,
+                 ir::AnalysisManager& am
+               ) {
+      ir::gvn_function(function, builder, am, aggressive_opt);
+    };
+    auto auto_inline = [&](ir::Builder& builder) {
+      ir::auto_inline(builder, inline_budget);
+    };
+    auto loop_unrolling = [&](
+                            ir::FunctionPtr function, ir::Builder& builder,
+                            ir::AnalysisManager& am
+                          ) {
+      ir::loop_unrolling_function(function, builder, am, unrolling_budget);
+    };
+
+    pass_manager.run_function_pass("mem2reg", ir::mem2reg_function);
+    pass_manager.run("func_ret_opt", ir::func_ret_opt);
+    pass_manager.run("purity_opt", ir::purity_opt);
+    pass_manager.run("auto_inline", auto_inline, ir::CfgEffect::Change);
+    pass_manager.run("global2local", ir::global2local);
+    pass_manager.run_function_pass("mem2reg", ir::mem2reg_function);
+    pass_manager.run_function_pass("gvn", gvn);
+    pass_manager.run_function_pass("load_elim", ir::load_elim_function);
+    pass_manager.run_function_pass(
+      "loop_invariant_motion", ir::loop_invariant_motion_function
+    );
+    pass_manager.run_function_pass("peephole", ir::peephole_function);
+    pass_manager.run_function_pass("unreach_elim", ir::unreach_elim_function);
+    pass_manager.run_function_pass("straighten", ir::straighten_function);
+    pass_manager.run_fixpoint_group("peephole_dce", peephole_dce);
+    pass_manager.run_function_pass("math_opt", ir::math_opt_function);
+    pass_manager.run_function_pass("dce", ir::dce_function);
+    pass_manager.run_function_pass("copyprop", ir::copyprop_function);
+    pass_manager.run_function_pass("peephole", ir::peephole_function);
+    pass_manager.run_function_pass("loop_unrolling", loop_unrolling);
+    pass_manager.run_function_pass("copyprop", ir::copyprop_function);
+    pass_manager.run_function_pass("gvn", gvn);
+    pass_manager.run_function_pass("copyprop", ir::copyprop_function);
+    pass_manager.run_function_pass("load_elim", ir::load_elim_function);
+    pass_manager.run_function_pass(
+      "loop_invariant_motion", ir::loop_invariant_motion_function
+    );
+    pass_manager.run_function_pass("peephole", ir::peephole_function);
+    pass_manager.run_function_pass("unreach_elim", ir::unreach_elim_function);
+    pass_manager.run_function_pass("straighten", ir::straighten_function);
+    pass_manager.run_fixpoint_group("peephole_dce", peephole_dce);
+    pass_manager.run_function_pass(
+      "loop_indvar_simplify", ir::loop_indvar_simplify_function
+    );
+    pass_manager.run_function_pass("math_opt", ir::math_opt_function);
+    pass_manager.run_function_pass("straighten", ir::straighten_function);
+    pass_manager.run_function_pass("gvn", gvn);
+    pass_manager.run_function_pass("peephole", ir::peephole_function);
+    pass_manager.run_function_pass("dce", ir::dce_function);
+    pass_manager.run_function_pass("copyprop", ir::copyprop_function);
+    pass_manager.run_function_pass("math_opt", ir::math_opt_function);
+    pass_manager.run_function_pass("dce", ir::dce_function);
+    pass_manager.run("store_elim", ir::store_elim);
+    pass_manager.run_function_pass("dce", ir::dce_function);
+    pass_manager.run_function_pass(
+      "loop_indvar_simplify", ir::loop_indvar_simplify_function
+    );
+    pass_manager.run_function_pass("dce", ir::dce_function);
+    pass_manager.run_function_pass("straighten", ir::straighten_function);
+    pass_manager.run_function_pass(
+      "strength_reduce", ir::strength_reduce_function
+    );
+    pass_manager.run("tco", ir::tco, ir::CfgEffect::Change);
+    pass_manager.run_function_pass("unreach_elim", ir::unreach_elim_function);
+    pass_manager.run_function_pass(
+      "loop_invariant_motion", ir::loop_invariant_motion_function
+    );
+    pass_manager.run_fixpoint_group("peephole_dce", peephole_dce);
+    pass_manager.run_function_pass("straighten", ir::straighten_function);
+    pass_manager.run_function_pass(
+      "strength_reduce", ir::strength_reduce_function
+    );
+    pass_manager.run_function_pass("dce", ir::dce_function);
+  }
+  pass_manager.flush();
+
+  if (statistics.enabled) {
+    CountList count_list;
+    ir_builder.context.count_nodes(count_list);
+    statistics.add_memory_snapshot("ir", std::move(count_list));
   }
 
   if (options.ir_file.has_value()) {
     std::ofstream ir_file(options.ir_file.value());
-    ir_file << ir_builder.context.to_string();
+    Emitter out(ir_file);
+    ir_builder.context.emit(out);
   }
 
   if (parse_success != 0) {
@@ -138,44 +236,284 @@ int main(int argc, char* argv[]) {
   }
 
   auto asm_builder = backend::Builder();
+  auto asm_pass_manager = backend::PassManager(asm_builder);
   auto codegen_context = CodegenContext();
 
-  codegen(ir_builder.context, asm_builder, codegen_context);
+  asm_pass_manager.thread_count = options.thread_count;
 
-  backend::peephole(asm_builder);
-  backend::dce(asm_builder);
+  asm_pass_manager.run("codegen_globals", [&](backend::Builder& builder) {
+    codegen_globals(ir_builder.context, builder, codegen_context);
+  });
 
-  if (options.optimization_level > 0) {
-    backend::phi_elim(asm_builder);
-    for (int i = 0; i < 3; i++) {
-      backend::peephole(asm_builder);
-      backend::dce(asm_builder);
+  // The functions found in the compile cache skip the whole backend.
+  std::optional<CompileCache> compile_cache;
+  if (options.cache_dir.has_value()) {
+    auto maybe_fingerprint = build_fingerprint();
+    if (maybe_fingerprint.has_value()) {
+      compile_cache.emplace(
+        options.cache_dir.value(),
+        "syc " + maybe_fingerprint.value() + " -O" +
+          std::to_string(options.optimization_level) +
+          (aggressive_opt ? " -aggressive" : "")
+      );
+      asm_pass_manager.run("cache_lookup", [&](backend::Builder& builder) {
+        compile_cache->fetch_cached_functions(
+          ir_builder.context, builder.context
+        );
+      });
+    } else {
+      std::cerr << "warning: compile cache disabled, the build of syc cannot "
+                   "be identified"
+                << std::endl;
     }
-    backend::addr_simplification(asm_builder);
-    backend::fast_divmod(asm_builder);
-    backend::unused_store_elim(asm_builder);
-    backend::store_fuse(asm_builder);
-    if (aggressive_opt) {
-      backend::instr_fuse(asm_builder);
-      backend::dce(asm_builder);
+  }
+
+  // Lowering, the asm passes and the register allocation of each function
+  // only touch that function, so they are queued and run function by function
+  // on `thread_count` threads.
+  asm_pass_manager.run_function_pass(
+    "codegen",
+    [&](backend::FunctionPtr function, backend::Builder& builder) {
+      // The lowering of a function only adds its own entries to the context.
+      auto function_codegen_context = codegen_context;
+      codegen_function(
+        ir_builder.context.get_function(function->name), ir_builder.context,
+        builder, function_codegen_context
+      );
     }
-    backend::lvn(asm_builder);
-    for (int i = 0; i < 3; i++) {
-      backend::peephole(asm_builder);
-      backend::dce(asm_builder);
+  );
+
+  asm_pass_manager.run_function_pass("peephole", backend::peephole_function);
+  asm_pass_manager.run_function_pass("dce", backend::dce_function);
+
+  backend::PassManager::FixpointGroup asm_peephole_dce = {
+    {"peephole", backend::peephole_function},
+    {"dce", backend::dce_function},
+  };
+
+  if (level > 0) {
+    asm_pass_manager.run_function_pass("phi_elim", backend::phi_elim_function);
+    asm_pass_manager.run_fixpoint_group("peephole_dce", asm_peephole_dce);
+  }
+
+  if (level >= 2) {
+    asm_pass_manager.run_function_pass(
+      "addr_simplification", backend::addr_simplification_function
+    );
+    asm_pass_manager.run_function_pass(
+      "fast_divmod", backend::fast_divmod_function
+    );
+    asm_pass_manager.run_function_pass(
+      "unused_store_elim", backend::unused_store_elim_function
+    );
+    asm_pass_manager.run_function_pass(
+      "store_fuse", backend::store_fuse_function
+    );
+    if (aggressive_opt) {
+      asm_pass_manager.run_function_pass(
+        "instr_fuse", backend::instr_fuse_function
+      );
+      asm_pass_manager.run_function_pass("dce", backend::dce_function);
     }
+    asm_pass_manager.run_function_pass("lvn", backend::lvn_function);
+    asm_pass_manager.run_fixpoint_group("peephole_dce", asm_peephole_dce);
 
-    backend::peephole_second(asm_builder);
+    asm_pass_manager.run_function_pass(
+      "peephole_second", backend::peephole_second_function
+    );
   }
 
-  codegen_rest(ir_builder.context, asm_builder, codegen_context);
+  asm_pass_manager.run_function_pass(
+    "codegen_rest",
+    [&](backend::FunctionPtr function, backend::Builder& builder) {
+      codegen_function_rest(
+        function->name, ir_builder.context, builder, codegen_context
+      );
+    }
+  );
 
-  backend::peephole_final(asm_builder);
+  asm_pass_manager.run_function_pass(
+    "peephole_final", backend::peephole_final_function
+  );
+
+  asm_pass_manager.flush();
+
+  if (compile_cache.has_value()) {
+    asm_pass_manager.run("cache_store", [&](backend::Builder& builder) {
+      compile_cache->store_missed_functions(
+        builder.context, asm_pass_manager.function_seconds_map
+      );
+    });
+    cache_counts.add(compile_cache->counts);
+  }
 
   if (options.output_file.has_value()) {
-    std::ofstream output_file(options.output_file.value());
-    output_file << asm_builder.context.to_string();
+    asm_pass_manager.run("emit", [&](backend::Builder& builder) {
+      std::ofstream output_file(options.output_file.value());
+      Emitter out(output_file);
+      builder.context.emit(out);
+    });
+  }
+
+  if (statistics.enabled) {
+    CountList count_list;
+    asm_builder.context.count_nodes(count_list);
+    statistics.add_memory_snapshot("asm", std::move(count_list));
+  }
+
+  if (options.time_passes) {
+    std::cerr << statistics.pass_table();
+  }
+  if (options.stats) {
+    std::cerr << statistics.counter_table();
+  }
+  if (options.mem_report) {
+    std::cerr << statistics.memory_table();
+  }
+  if (options.stats_file.has_value()) {
+    std::ofstream stats_file(options.stats_file.value());
+    stats_file << statistics.to_json();
   }
 
   return 0;
 }
+
+/// Collect the files of the batch inputs. A directory stands for the `.sy`
+/// files in it and any other file than a `.sy` file is a list of files, one
+/// per line.
+std::vector<std::filesystem::path> collect_batch_inputs(
+  const std::vector<std::string>& input_list
+) {
+  std::vector<std::filesystem::path> path_list;
+  for (const auto& input : input_list) {
+    std::filesystem::path input_path(input);
+    if (std::filesystem::is_directory(input_path)) {
+      std::vector<std::filesystem::path> dir_path_list;
+      auto dir_iterator = std::filesystem::directory_iterator(input_path);
+      for (const auto& entry : dir_iterator) {
+        if (entry.is_regular_file() && entry.path().extension() == ".sy") {
+          dir_path_list.push_back(entry.path());
+        }
+      }
+      std::sort(dir_path_list.begin(), dir_path_list.end());
+      path_list.insert(
+        path_list.end(), dir_path_list.begin(), dir_path_list.end()
+      );
+    } else if (input_path.extension() == ".sy") {
+      path_list.push_back(input_path);
+    } else {
+      std::ifstream list_file(input_path);
+      std::string line;
+      while (std::getline(list_file, line)) {
+        if (!line.empty()) {
+          path_list.push_back(line);
+        }
+      }
+    }
+  }
+  return path_list;
+}
+
+/// Compile every file of the batch into `<output dir>/<stem>.s`.
+///
+/// The files are compiled `thread_count` at a time, each with its own driver
+/// and builders and with the passes on one thread. The largest files start
+/// first and each thread takes the next file as soon as it is done, so one
+/// large file does not hold up the rest. An error in a file only fails that
+/// file, and all the failures are reported at the end.
+int compile_batch(const Options& options, CacheCounts& cache_counts) {
+  auto path_list = collect_batch_inputs(options.batch_input_list);
+  std::filesystem::path output_dir(options.output_file.value());
+
+  std::map<std::string, std::filesystem::path> stem_map;
+  for (const auto& path : path_list) {
+    auto stem = path.stem().string();
+    if (stem_map.count(stem) && stem_map[stem] != path) {
+      std::cerr << "error: " << stem_map[stem].string() << " and "
+                << path.string() << " have the same output file" << std::endl;
+      return 1;
+    }
+    stem_map[stem] = path;
+  }
+
+  std::error_code error;
+  std::filesystem::create_directories(output_dir, error);
+  if (error) {
+    std::cerr << "error: cannot create " << output_dir.string() << ": "
+              << error.message() << std::endl;
+    return 1;
+  }
+
+  std::vector<size_t> size_list;
+  for (const auto& path : path_list) {
+    auto size = std::filesystem::file_size(path, error);
+    size_list.push_back(error ? 0 : size);
+  }
+  auto order_list = largest_first_order(size_list);
+
+  std::vector<std::optional<std::string>> error_list(path_list.size());
+  std::vector<CacheCounts> cache_counts_list(path_list.size());
+
+  parallel_for(order_list.size(), options.thread_count, [&](size_t i) {
+    auto index = order_list[i];
+    auto output_path = output_dir / (path_list[index].stem().string() + ".s");
+
+    auto job_options = options;
+    job_options.batch = false;
+    job_options.input_filename = path_list[index].string();
+    job_options.output_file = output_path.string();
+    job_options.thread_count = 1;
+
+    try {
+      if (compile(job_options, cache_counts_list[index]) != 0) {
+        error_list[index] = "Parse failed.";
+      }
+    } catch (const std::exception& e) {
+      error_list[index] = e.what();
+    } catch (...) {
+      error_list[index] = "unknown error";
+    }
+
+    // Leave no output of an earlier run behind for a failed file.
+    if (error_list[index].has_value()) {
+      std::error_code remove_error;
+      std::filesystem::remove(output_path, remove_error);
+    }
+  });
+
+  size_t failed_count = 0;
+  for (size_t i = 0; i < path_list.size(); i++) {
+    cache_counts.add(cache_counts_list[i]);
+    if (error_list[i].has_value()) {
+      failed_count++;
+      std::cerr << "error: " << path_list[i].string() << ": "
+                << error_list[i].value() << std::endl;
+    }
+  }
+  std::cerr << "batch: " << path_list.size() - failed_count << " compiled, "
+            << failed_count << " failed" << std::endl;
+
+  return failed_count > 0 ? 1 : 0;
+}
+
+}  // namespace syc
+
+int main(int argc, char* argv[]) {
+  using namespace syc;
+
+  auto options = parse_args(argc, argv);
+
+  auto& statistics = get_statistics();
+  statistics.enabled = options.time_passes || options.stats ||
+                       options.mem_report || options.stats_file.has_value();
+
+  CacheCounts cache_counts;
+  auto exit_code = options.batch ? compile_batch(options, cache_counts)
+                                 : compile(options, cache_counts);
+
+  if (options.cache_report && options.cache_dir.has_value()) {
+    std::cerr << cache_counts.report();
+  }
+
+  return exit_code;
+}
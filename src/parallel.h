@@ -0,0 +1,75 @@
+#ifndef SYC_PARALLEL_H_
+#define SYC_PARALLEL_H_
+
+#include <atomic>
+#include <thread>
+
+#include "common.h"
+
+namespace syc {
+
+/// Indices of the sizes from the largest to the smallest, ties in order.
+/// Used to start the largest jobs of `parallel_for` first.
+inline std::vector<size_t> largest_first_order(
+  const std::vector<size_t>& size_list
+) {
+  std::vector<size_t> order_list(size_list.size());
+  for (size_t i = 0; i < order_list.size(); i++) {
+    order_list[i] = i;
+  }
+  std::stable_sort(
+    order_list.begin(), order_list.end(),
+    [&](size_t lhs, size_t rhs) { return size_list[lhs] > size_list[rhs]; }
+  );
+  return order_list;
+}
+
+/// Run `job(index)` for every index in `[0, count)` on up to `thread_count`
+/// threads.
+///
+/// Each thread takes the next index as soon as it finishes one, so jobs of
+/// uneven sizes are balanced as long as the large ones come first. With one
+/// thread the jobs run in order on the calling thread. If any job throws, the
+/// exception of the smallest index is rethrown after all the jobs are done.
+template <typename Job>
+void parallel_for(size_t count, size_t thread_count, Job&& job) {
+  std::vector<std::exception_ptr> exception_list(count);
+  std::atomic<size_t> next_index = 0;
+
+  auto work = [&]() {
+    while (true) {
+      auto index = next_index++;
+      if (index >= count) {
+        break;
+      }
+      try {
+        job(index);
+      } catch (...) {
+        exception_list[index] = std::current_exception();
+      }
+    }
+  };
+
+  auto worker_count = std::min(thread_count, count);
+  if (worker_count <= 1) {
+    work();
+  } else {
+    std::vector<std::thread> thread_list;
+    for (size_t i = 0; i < worker_count; i++) {
+      thread_list.emplace_back(work);
+    }
+    for (auto& thread : thread_list) {
+      thread.join();
+    }
+  }
+
+  for (auto& exception : exception_list) {
+    if (exception) {
+      std::rethrow_exception(exception);
+    }
+  }
+}
+
+}  // namespace syc
+
+#endif
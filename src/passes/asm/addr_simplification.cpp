@@ -12,6 +12,7 @@ namespace backend {
 
 void addr_simplification(Builder& builder) {
   for (auto [function_name, function] : builder.context.function_table) {
+    builder.switch_function(function_name);
     addr_simplification_function(function, builder);
   }
 }
@@ -50,7 +51,7 @@ void addr_simplification_basic_block(
           // std::cout << "find addi " << rd_id << ", sp, " << "imm" <<
           // std::endl;
           bool do_remove = true;
-          auto use_id_list_copy = rd_operand->use_id_list;
+          auto use_id_list_copy = rd_operand->use_id_list.to_vector();
           for (InstructionID use : use_id_list_copy) {
             // std::cout << "use: " << use << std::endl;
             auto use_inst = builder.context.get_instruction(use);
@@ -4,23 +4,39 @@
 #include "backend/function.h"
 #include "backend/instruction.h"
 #include "backend/operand.h"
+#include "statistics.h"
 
 namespace syc {
 namespace backend {
 
 void dce(Builder& builder) {
+  for (auto [function_name, function] : builder.context.function_table) {
+    builder.switch_function(function_name);
+    dce_function(function, builder);
+  }
+}
+
+bool dce_function(FunctionPtr function, Builder& builder) {
   // TODO: use-def chain
 
+  bool changed = false;
+
   // remove all the operands and its corresponding def instructions
-  for (auto [operand_id, operand] : builder.context.operand_table) {
+  auto operand_range =
+    builder.context.operand_table.space_entries(function->id_space);
+  for (auto [operand_id, operand] : operand_range) {
     bool removable = operand->is_vreg() && operand->use_id_list.size() == 0 &&
                      operand->def_id_list.size() == 1;
     if (removable) {
       auto instruction =
-        builder.context.get_instruction(operand->def_id_list[0]);
+        builder.context.get_instruction(operand->def_id_list.front());
       instruction->remove(builder.context);
+      bump_counter("asm.dce", "instructions removed");
+      changed = true;
     }
   }
+
+  return changed;
 }
 
 }  // namespace backend
@@ -8,6 +8,11 @@ namespace backend {
 
 void dce(Builder& builder);
 
+/// Remove the instructions that only define unused virtual registers.
+/// Virtual registers live in the ID space of their function, so only the
+/// operands of that space are visited. Return if anything is removed.
+bool dce_function(FunctionPtr function, Builder& builder);
+
 }
 }  // namespace syc
 
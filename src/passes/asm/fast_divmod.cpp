@@ -51,6 +51,7 @@ struct ms magic(int d) {  // Must have 2 <= d <= 2**31-1 or -2**31 <= d <= -2.
 
 void fast_divmod(Builder& builder) {
   for (auto [function_name, function] : builder.context.function_table) {
+    builder.switch_function(function_name);
     fast_divmod_function(function, builder);
   }
 }
@@ -1,5 +1,6 @@
 #include "passes/asm/greedy_allocation.h"
 #include "ir/codegen.h"
+#include "statistics.h"
 
 namespace syc {
 namespace backend {
@@ -138,6 +139,218 @@ calc_alloc_priority(AllocID alloc_id, GreedyAllocationContext& ga_ctx) {
   );
 }
 
+bool RangeTree::key_less(const AllocRange& lhs, const AllocRange& rhs) {
+  return std::make_tuple(lhs.range.st, lhs.range.ed, lhs.alloc_id) <
+         std::make_tuple(rhs.range.st, rhs.range.ed, rhs.alloc_id);
+}
+
+size_t RangeTree::new_node(AllocRange alloc_range) {
+  // Mix the key for the priority (splitmix64).
+  uint64_t hash = alloc_range.range.st * 0x9e3779b97f4a7c15ull ^
+                  alloc_range.range.ed * 0xbf58476d1ce4e5b9ull ^
+                  alloc_range.alloc_id * 0x94d049bb133111ebull;
+  hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+  hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebull;
+  hash = hash ^ (hash >> 31);
+
+  if (!free_list.empty()) {
+    auto node = free_list.back();
+    free_list.pop_back();
+    node_list[node] = Node(alloc_range, hash);
+    return node;
+  }
+  node_list.emplace_back(alloc_range, hash);
+  return node_list.size() - 1;
+}
+
+void RangeTree::update(size_t node) {
+  auto& curr = node_list[node];
+  curr.max_ed = curr.alloc_range.range.ed;
+  if (curr.left != NONE) {
+    curr.max_ed = std::max(curr.max_ed, node_list[curr.left].max_ed);
+  }
+  if (curr.right != NONE) {
+    curr.max_ed = std::max(curr.max_ed, node_list[curr.right].max_ed);
+  }
+}
+
+void RangeTree::split(
+  size_t node,
+  const AllocRange& key,
+  size_t& left,
+  size_t& right
+) {
+  if (node == NONE) {
+    left = NONE;
+    right = NONE;
+    return;
+  }
+  if (key_less(node_list[node].alloc_range, key)) {
+    split(node_list[node].right, key, node_list[node].right, right);
+    left = node;
+  } else {
+    split(node_list[node].left, key, left, node_list[node].left);
+    right = node;
+  }
+  update(node);
+}
+
+size_t RangeTree::merge(size_t left, size_t right) {
+  if (left == NONE) {
+    return right;
+  }
+  if (right == NONE) {
+    return left;
+  }
+  if (node_list[left].priority > node_list[right].priority) {
+    auto merged = merge(node_list[left].right, right);
+    node_list[left].right = merged;
+    update(left);
+    return left;
+  }
+  auto merged = merge(left, node_list[right].left);
+  node_list[right].left = merged;
+  update(right);
+  return right;
+}
+
+void RangeTree::insert(const Range& range, AllocID alloc_id) {
+  auto key = AllocRange(range, alloc_id);
+
+  auto node = root;
+  while (node != NONE) {
+    const auto& curr = node_list[node].alloc_range;
+    if (key_less(key, curr)) {
+      node = node_list[node].left;
+    } else if (key_less(curr, key)) {
+      node = node_list[node].right;
+    } else {
+      return;
+    }
+  }
+
+  auto new_root = new_node(key);
+  size_t left;
+  size_t right;
+  split(root, key, left, right);
+  root = merge(merge(left, new_root), right);
+}
+
+size_t RangeTree::erase(size_t node, const AllocRange& key) {
+  if (node == NONE) {
+    return NONE;
+  }
+  const auto& curr = node_list[node].alloc_range;
+  if (key_less(key, curr)) {
+    auto left = erase(node_list[node].left, key);
+    node_list[node].left = left;
+  } else if (key_less(curr, key)) {
+    auto right = erase(node_list[node].right, key);
+    node_list[node].right = right;
+  } else {
+    free_list.push_back(node);
+    return merge(node_list[node].left, node_list[node].right);
+  }
+  update(node);
+  return node;
+}
+
+void RangeTree::erase(const Range& range, AllocID alloc_id) {
+  root = erase(root, AllocRange(range, alloc_id));
+}
+
+std::optional<std::pair<InstrNum, InstrNum>> RangeTree::find_prev(
+  const Range& range
+) const {
+  std::optional<std::pair<InstrNum, InstrNum>> maybe_prev = std::nullopt;
+  auto key = std::make_pair(range.st, range.ed);
+  auto node = root;
+  while (node != NONE) {
+    const auto& curr = node_list[node].alloc_range.range;
+    auto curr_key = std::make_pair(curr.st, curr.ed);
+    if (curr_key < key) {
+      maybe_prev = curr_key;
+      node = node_list[node].right;
+    } else {
+      node = node_list[node].left;
+    }
+  }
+  return maybe_prev;
+}
+
+bool RangeTree::any_conflict(const Range& range) const {
+  return any_conflict(root, range);
+}
+
+bool RangeTree::any_conflict(size_t node, const Range& range) const {
+  // A conflict implies that the ranges overlap as closed intervals.
+  if (node == NONE || node_list[node].max_ed < range.st) {
+    return false;
+  }
+  const auto& curr = node_list[node];
+  if (any_conflict(curr.left, range)) {
+    return true;
+  }
+  if (curr.alloc_range.range.st > range.ed) {
+    return false;
+  }
+  return range.conflict(curr.alloc_range.range) ||
+         any_conflict(curr.right, range);
+}
+
+void RangeTree::collect_conflicts(
+  const Range& range,
+  std::optional<std::pair<InstrNum, InstrNum>> maybe_first,
+  std::set<AllocID>& alloc_id_set
+) const {
+  collect_conflicts(root, range, maybe_first, alloc_id_set);
+}
+
+void RangeTree::collect_conflicts(
+  size_t node,
+  const Range& range,
+  const std::optional<std::pair<InstrNum, InstrNum>>& maybe_first,
+  std::set<AllocID>& alloc_id_set
+) const {
+  if (node == NONE || node_list[node].max_ed < range.st) {
+    return;
+  }
+  const auto& curr = node_list[node];
+  const auto& curr_range = curr.alloc_range.range;
+
+  // The left subtree is ordered before this node.
+  bool is_skipped = maybe_first.has_value() &&
+                    std::make_pair(curr_range.st, curr_range.ed) <
+                      maybe_first.value();
+  if (!is_skipped) {
+    collect_conflicts(curr.left, range, maybe_first, alloc_id_set);
+  }
+  if (curr_range.st > range.ed) {
+    return;
+  }
+  if (!is_skipped && range.conflict(curr_range)) {
+    alloc_id_set.insert(curr.alloc_range.alloc_id);
+  }
+  collect_conflicts(curr.right, range, maybe_first, alloc_id_set);
+}
+
+const RangeTree& GreedyAllocationContext::get_fixed_range_tree(
+  Register reg,
+  Builder& builder,
+  LivenessAnalysisContext& la_ctx
+) {
+  auto iter = fixed_range_map.find(reg);
+  if (iter != fixed_range_map.end()) {
+    return iter->second;
+  }
+  auto& fixed_range_tree = fixed_range_map[reg];
+  auto reg_id = builder.fetch_register(reg);
+  for (const auto& reg_range : la_ctx.live_range_map[reg_id]) {
+    fixed_range_tree.insert(reg_range, 0);
+  }
+  return fixed_range_tree;
+}
+
 void GreedyAllocationContext::try_allocate(
   AllocID alloc_id,
   Builder& builder,
@@ -183,16 +396,12 @@ void GreedyAllocationContext::try_allocate(
 
     // Check conflict if the register might be used somewhere.
     if (REG_ARGS.count(reg) || REG_TEMP.count(reg)) {
-      auto reg_id = builder.fetch_register(reg);
-      for (auto reg_range : la_ctx.live_range_map[reg_id]) {
-        for (const auto& range : range_list) {
-          if (range.conflict(reg_range)) {
-            is_conflict = true;
-            hard_conflict_set.insert(reg);
-            break;
-          }
-        }
-        if (is_conflict) {
+      const auto& fixed_range_tree =
+        get_fixed_range_tree(reg, builder, la_ctx);
+      for (const auto& range : range_list) {
+        if (fixed_range_tree.any_conflict(range)) {
+          is_conflict = true;
+          hard_conflict_set.insert(reg);
           break;
         }
       }
@@ -206,22 +415,16 @@ void GreedyAllocationContext::try_allocate(
       maybe_allocated_reg = reg;
       break;
     }
-    auto iter = occupied_range_map[reg].lower_bound(alloc_range);
-    if (iter != occupied_range_map[reg].begin()) {
-      iter--;
-    }
-    // Check conflict and find all conflicts
-    while (iter != occupied_range_map[reg].end()) {
-      const auto& occupied_range = iter->range;
-      for (const auto& range : range_list) {
-        if (range.conflict(occupied_range)) {
-          is_conflict = true;
-          conflict_map[reg].insert(iter->alloc_id);
-          break;
-        }
-      }
-      iter++;
+    // Check conflict and find all conflicts. Only the ranges from the last
+    // one ordered before the first range of the alloc are checked.
+    const auto& occupied_range_tree = occupied_range_map[reg];
+    auto maybe_first = occupied_range_tree.find_prev(alloc_range.range);
+    for (const auto& range : range_list) {
+      occupied_range_tree.collect_conflicts(
+        range, maybe_first, conflict_map[reg]
+      );
     }
+    is_conflict = !conflict_map[reg].empty();
 
     if (!is_conflict) {
       maybe_allocated_reg = reg;
@@ -234,8 +437,8 @@ void GreedyAllocationContext::try_allocate(
     // Update occupied_map
     occupied_map[allocated_reg].insert(alloc_id);
     // Update occupied_range_map
-    for (auto range : range_list) {
-      occupied_range_map[allocated_reg].insert(AllocRange(range, alloc_id));
+    for (const auto& range : range_list) {
+      occupied_range_map[allocated_reg].insert(range, alloc_id);
     }
     // Update alloc_map
     alloc_map[alloc_id] = allocated_reg;
@@ -284,13 +487,8 @@ void GreedyAllocationContext::try_allocate(
         // Update occupied_map
         occupied_map[min_weight_reg].erase(conflict_id);
         // Update occupied_range_map
-        auto iter = occupied_range_map[min_weight_reg].begin();
-        while (iter != occupied_range_map[min_weight_reg].end()) {
-          if (iter->alloc_id == conflict_id) {
-            iter = occupied_range_map[min_weight_reg].erase(iter);
-          } else {
-            iter++;
-          }
+        for (const auto& range : alloc_range_map[conflict_id]) {
+          occupied_range_map[min_weight_reg].erase(range, conflict_id);
         }
         // Update alloc_map
         alloc_map.erase(conflict_id);
@@ -301,8 +499,8 @@ void GreedyAllocationContext::try_allocate(
       // Update occupied_map
       occupied_map[min_weight_reg].insert(alloc_id);
       // Update occupied_range_map
-      for (auto range : range_list) {
-        occupied_range_map[min_weight_reg].insert(AllocRange(range, alloc_id));
+      for (const auto& range : range_list) {
+        occupied_range_map[min_weight_reg].insert(range, alloc_id);
       }
       // Update alloc_map
       alloc_map[alloc_id] = min_weight_reg;
@@ -330,6 +528,8 @@ void GreedyAllocationContext::spill(
 
   using namespace instruction;
 
+  bump_counter("asm.greedy_allocation", "spills");
+
   auto instr_def_worklist = std::vector<InstructionPtr>();
   auto instr_use_worklist = std::vector<InstructionPtr>();
 
@@ -566,7 +766,7 @@ void greedy_allocation(FunctionPtr function, Builder& builder) {
   // Initialize occupied_map
   for (auto reg : REG_ALLOC) {
     ga_ctx.occupied_map[reg] = std::set<AllocID>();
-    ga_ctx.occupied_range_map[reg] = std::set<AllocRange>();
+    ga_ctx.occupied_range_map[reg] = RangeTree();
   }
 
   // Initialize block_weight_map
@@ -40,6 +40,77 @@ struct AllocRange {
   }
 };
 
+/// Ranges with their alloc IDs in a treap, for overlap queries.
+///
+/// Nodes are ordered by the start, the end and the alloc ID of the range, and
+/// each node keeps the largest end in its subtree, so a query skips the
+/// subtrees that end before the queried range, and the right subtrees that
+/// start after it. Queries thus take logarithmic time plus the number of
+/// ranges found, instead of a scan over all the ranges of the register.
+/// Priorities are hashes of the keys, so the shape of the tree is
+/// deterministic.
+struct RangeTree {
+  static constexpr size_t NONE = std::numeric_limits<size_t>::max();
+
+  struct Node {
+    AllocRange alloc_range;
+    uint64_t priority;
+    /// Largest end of the ranges in the subtree
+    InstrNum max_ed;
+    size_t left = NONE;
+    size_t right = NONE;
+
+    Node(AllocRange alloc_range, uint64_t priority)
+      : alloc_range(alloc_range),
+        priority(priority),
+        max_ed(alloc_range.range.ed) {}
+  };
+
+  /// Nodes, including the freed ones.
+  std::vector<Node> node_list;
+  /// Freed nodes to be reused.
+  std::vector<size_t> free_list;
+  size_t root = NONE;
+
+  bool empty() const { return root == NONE; }
+
+  /// Insert a range, nothing is done if it is already in the tree.
+  void insert(const Range& range, AllocID alloc_id);
+
+  /// Erase a range, nothing is done if it is not in the tree.
+  void erase(const Range& range, AllocID alloc_id);
+
+  /// Start and end of the last range ordered before `range`, if any.
+  std::optional<std::pair<InstrNum, InstrNum>> find_prev(const Range& range
+  ) const;
+
+  /// If `range` conflicts with any range in the tree.
+  bool any_conflict(const Range& range) const;
+
+  /// Collect the alloc IDs of the ranges `range` conflicts with, skipping the
+  /// ranges ordered before `maybe_first`.
+  void collect_conflicts(
+    const Range& range,
+    std::optional<std::pair<InstrNum, InstrNum>> maybe_first,
+    std::set<AllocID>& alloc_id_set
+  ) const;
+
+  static bool key_less(const AllocRange& lhs, const AllocRange& rhs);
+
+  size_t new_node(AllocRange alloc_range);
+  void update(size_t node);
+  void split(size_t node, const AllocRange& key, size_t& left, size_t& right);
+  size_t merge(size_t left, size_t right);
+  size_t erase(size_t node, const AllocRange& key);
+  bool any_conflict(size_t node, const Range& range) const;
+  void collect_conflicts(
+    size_t node,
+    const Range& range,
+    const std::optional<std::pair<InstrNum, InstrNum>>& maybe_first,
+    std::set<AllocID>& alloc_id_set
+  ) const;
+};
+
 /// Prioritized alloc id used in priority queue
 struct PrioritizedAlloc {
   /// AllocID
@@ -90,8 +161,10 @@ struct GreedyAllocationContext {
   /// a register
   std::unordered_map<Register, std::set<AllocID>, RegisterHash> occupied_map;
   /// Allocated range
-  std::unordered_map<Register, std::set<AllocRange>, RegisterHash>
-    occupied_range_map;
+  std::unordered_map<Register, RangeTree, RegisterHash> occupied_range_map;
+  /// Live ranges of the argument and temporary registers, which cannot be
+  /// evicted
+  std::unordered_map<Register, RangeTree, RegisterHash> fixed_range_map;
 
   std::unordered_map<AllocID, AllocStage> alloc_stage_map;
 
@@ -112,6 +185,14 @@ struct GreedyAllocationContext {
 
   GreedyAllocationContext() = default;
 
+  /// Get the live ranges of an argument or temporary register, built on the
+  /// first query.
+  const RangeTree& get_fixed_range_tree(
+    Register reg,
+    Builder& builder,
+    LivenessAnalysisContext& la_ctx
+  );
+
   void try_allocate(AllocID, Builder&, LivenessAnalysisContext&);
   void try_split(AllocID, Builder&);
   void spill(AllocID, FunctionPtr, Builder&, LivenessAnalysisContext&);
@@ -12,6 +12,7 @@ namespace backend {
 
 void instr_fuse(Builder& builder) {
   for (auto [function_name, function] : builder.context.function_table) {
+    builder.switch_function(function_name);
     instr_fuse_function(function, builder);
   }
 }
@@ -44,7 +45,7 @@ void instr_fuse_basic_block(BasicBlockPtr basic_block, Builder& builder) {
         // remove: fsgnj v0, v1, v1
         // make all the uses of v0 use v1 instead
         if (rd->def_id_list.size() == 1 && rs1->def_id_list.size() == 1) {
-          auto use_id_list_copy = rd->use_id_list;
+          auto use_id_list_copy = rd->use_id_list.to_vector();
           for (auto use_instruction_id : use_id_list_copy) {
             auto instruction =
               builder.context.get_instruction(use_instruction_id);
@@ -25,30 +25,11 @@ void dfn(BasicBlockPtr bb, Builder& builder, LivenessAnalysisContext& la_ctx) {
 
   la_ctx.visited_map[bb->id] = true;
 
-  la_ctx.live_def_map[bb->id] = std::set<OperandID>();
-  la_ctx.live_use_map[bb->id] = std::set<OperandID>();
-
   auto curr_instr = bb->head_instruction->next;
   while (curr_instr != bb->tail_instruction) {
     auto instr_num = la_ctx.get_next_instr_num();
     la_ctx.instr_num_map[curr_instr->id] = instr_num;
     la_ctx.instr_map[instr_num] = curr_instr->id;
-
-    for (auto operand_id : curr_instr->use_id_list) {
-      auto operand = builder.context.get_operand(operand_id);
-      if ((operand->is_vreg() || operand->is_reg()) && 
-          !la_ctx.live_def_map[bb->id].count(operand_id)) {
-        la_ctx.live_use_map[bb->id].insert(operand_id);
-      }
-    }
-
-    for (auto operand_id : curr_instr->def_id_list) {
-      auto operand = builder.context.get_operand(operand_id);
-      if ((operand->is_vreg() || operand->is_reg())) {
-        la_ctx.live_def_map[bb->id].insert(operand_id);
-      }
-    }
-
     curr_instr = curr_instr->next;
   }
 
@@ -79,85 +60,82 @@ void liveness_analysis(
 
   dfn(function->head_basic_block->next, builder, la_ctx);
 
-  std::vector<BasicBlockID> bb_reverse_order;
-  auto exit_bb = function->tail_basic_block->prev.lock();
-
-  std::queue<BasicBlockID> bb_queue;
-  bb_queue.push(exit_bb->id);
+  auto is_allocatable = [&](OperandID operand_id) {
+    auto operand = builder.context.get_operand(operand_id);
+    return operand->is_vreg() || operand->is_reg();
+  };
 
+  // Number the blocks and the registers
+  la_ctx.block_index_map.clear();
+  la_ctx.operand_list.clear();
+  la_ctx.operand_bit_map.clear();
   curr_bb = function->head_basic_block->next;
   while (curr_bb != function->tail_basic_block) {
-    la_ctx.visited_map[curr_bb->id] = false;
+    auto block_index = la_ctx.block_index_map.size();
+    la_ctx.block_index_map[curr_bb->id] = block_index;
+    for (auto instr = curr_bb->head_instruction->next;
+         instr != curr_bb->tail_instruction; instr = instr->next) {
+      for (auto operand_id : instr->use_id_list) {
+        la_ctx.operand_list.push_back(operand_id);
+      }
+      for (auto operand_id : instr->def_id_list) {
+        la_ctx.operand_list.push_back(operand_id);
+      }
+    }
     curr_bb = curr_bb->next;
   }
+  auto& operand_list = la_ctx.operand_list;
+  std::sort(operand_list.begin(), operand_list.end());
+  operand_list.erase(
+    std::unique(operand_list.begin(), operand_list.end()), operand_list.end()
+  );
+  operand_list.erase(
+    std::remove_if(
+      operand_list.begin(), operand_list.end(),
+      [&](OperandID operand_id) { return !is_allocatable(operand_id); }
+    ),
+    operand_list.end()
+  );
+  for (size_t bit = 0; bit < operand_list.size(); bit++) {
+    la_ctx.operand_bit_map[operand_list[bit]] = bit;
+  }
 
-  while (!bb_queue.empty()) {
-    auto bb_id = bb_queue.front();
-    bb_queue.pop();
-
-    if (la_ctx.visited_map[bb_id]) {
-      continue;
-    }
-
-    la_ctx.visited_map[bb_id] = true;
-    bb_reverse_order.push_back(bb_id);
-
-    auto bb = builder.context.get_basic_block(bb_id);
-    for (auto pred_id : bb->pred_list) {
-      bb_queue.push(pred_id);
+  // live-in = (live-out - live-def) + live-use
+  auto problem = DataflowProblem(
+    DataflowDirection::Backward, DataflowMeet::Union,
+    la_ctx.block_index_map.size(), operand_list.size()
+  );
+  curr_bb = function->head_basic_block->next;
+  while (curr_bb != function->tail_basic_block) {
+    auto block_index = la_ctx.block_index_map[curr_bb->id];
+    for (auto succ_id : curr_bb->succ_list) {
+      problem.add_edge(block_index, la_ctx.block_index_map.at(succ_id));
     }
-  }
 
-  // Compute live-in and live-out
-  bool changed = true;
-  while (changed) {
-    changed = false;
-    for (auto bb_id : bb_reverse_order) {
-      auto bb = builder.context.get_basic_block(bb_id);
-      auto live_out = std::set<OperandID>();
-      auto live_in = std::set<OperandID>();
-
-      for (auto succ_id : bb->succ_list) {
-        if (!la_ctx.live_in_map.count(succ_id)) {
-          la_ctx.live_in_map[succ_id] = std::set<OperandID>();
-        }
-        // Union
-        for (auto operand_id : la_ctx.live_in_map[succ_id]) {
-          live_out.insert(operand_id);
+    auto& live_use = problem.gen_list[block_index];
+    auto& live_def = problem.kill_list[block_index];
+    for (auto instr = curr_bb->head_instruction->next;
+         instr != curr_bb->tail_instruction; instr = instr->next) {
+      for (auto operand_id : instr->use_id_list) {
+        auto it = la_ctx.operand_bit_map.find(operand_id);
+        if (it != la_ctx.operand_bit_map.end() && !live_def.test(it->second)) {
+          live_use.set(it->second);
         }
       }
-
-      // live-in = (live-out - live-def) + live-use
-      for (auto operand_id : live_out) {
-        if (!la_ctx.live_def_map[bb_id].count(operand_id)) {
-          live_in.insert(operand_id);
+      for (auto operand_id : instr->def_id_list) {
+        auto it = la_ctx.operand_bit_map.find(operand_id);
+        if (it != la_ctx.operand_bit_map.end()) {
+          live_def.set(it->second);
         }
       }
-      for (auto operand_id : la_ctx.live_use_map[bb_id]) {
-        live_in.insert(operand_id);
-      }
-
-      // Update live-in and live-out
-      if (!la_ctx.live_in_map.count(bb_id)) {
-        la_ctx.live_in_map[bb_id] = std::set<OperandID>();
-      }
-
-      if (!la_ctx.live_out_map.count(bb_id)) {
-        la_ctx.live_out_map[bb_id] = std::set<OperandID>();
-      }
-
-      if (live_in != la_ctx.live_in_map[bb_id]) {
-        changed = true;
-        la_ctx.live_in_map[bb_id] = live_in;
-      }
-
-      if (live_out != la_ctx.live_out_map[bb_id]) {
-        changed = true;
-        la_ctx.live_out_map[bb_id] = live_out;
-      }
     }
+    curr_bb = curr_bb->next;
   }
 
+  auto result = solve_dataflow(problem);
+  la_ctx.live_in_list = std::move(result.in_list);
+  la_ctx.live_out_list = std::move(result.out_list);
+
   // Compute live ranges
   curr_bb = function->head_basic_block->next;
   while (curr_bb != function->tail_basic_block) {
@@ -169,13 +147,11 @@ void liveness_analysis(
 
     std::unordered_map<OperandID, Range> live_range_buffer;
 
-    for (auto operand_id : la_ctx.live_out_map[curr_bb->id]) {
-      auto operand = builder.context.get_operand(operand_id);
-      if (operand->is_vreg() || operand->is_reg()) {
-        live_range_buffer[operand_id] =
-          Range{entry_instr_num, exit_instr_num, 0, curr_bb->id};
-      }
-    }
+    auto block_index = la_ctx.block_index_map[curr_bb->id];
+    la_ctx.live_out_list[block_index].for_each([&](size_t bit) {
+      live_range_buffer[operand_list[bit]] =
+        Range{entry_instr_num, exit_instr_num, 0, curr_bb->id};
+    });
 
     while (exit_instr != curr_bb->head_instruction) {
       auto curr_instr_num = la_ctx.instr_num_map[exit_instr->id];
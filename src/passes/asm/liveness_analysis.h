@@ -7,6 +7,7 @@
 #include "backend/instruction.h"
 #include "backend/operand.h"
 #include "common.h"
+#include "passes/dataflow.h"
 
 namespace syc {
 namespace backend {
@@ -36,14 +37,18 @@ struct LivenessAnalysisContext {
   /// Visited map
   std::unordered_map<BasicBlockID, bool> visited_map;
 
-  /// Live-def map
-  std::unordered_map<BasicBlockID, std::set<OperandID>> live_def_map;
-  /// Live-use map
-  std::unordered_map<BasicBlockID, std::set<OperandID>> live_use_map;
-  /// Live-in map
-  std::unordered_map<BasicBlockID, std::set<OperandID>> live_in_map;
-  /// Live-out map
-  std::unordered_map<BasicBlockID, std::set<OperandID>> live_out_map;
+  /// Registers and virtual registers of the function in increasing ID order,
+  /// indexed by their bits in the live sets.
+  std::vector<OperandID> operand_list;
+  /// Bit of each register and virtual register in the live sets.
+  std::unordered_map<OperandID, size_t> operand_bit_map;
+  /// Index of each basic block in the live sets, in the layout order.
+  std::unordered_map<BasicBlockID, size_t> block_index_map;
+
+  /// Live-in of each block
+  std::vector<BitSet> live_in_list;
+  /// Live-out of each block
+  std::vector<BitSet> live_out_list;
 
   /// Live ranges
   std::unordered_map<OperandID, std::vector<Range>> live_range_map;
@@ -64,6 +69,8 @@ struct LivenessAnalysisContext {
 /// Depth-first numbering
 void dfn(BasicBlockPtr bb, Builder& builder, LivenessAnalysisContext& la_ctx);
 
+/// Number the instructions, then solve the live sets as a backward dataflow
+/// problem over bit sets of the registers, and build the live ranges.
 void liveness_analysis(
   FunctionPtr function,
   Builder& builder,
@@ -2,12 +2,14 @@
 #include "backend/basic_block.h"
 #include "backend/instruction.h"
 #include "backend/operand.h"
+#include "statistics.h"
 
 namespace syc {
 namespace backend {
 
 void lvn(Builder& builder) {
   for (auto [function_name, function] : builder.context.function_table) {
+    builder.switch_function(function_name);
     lvn_function(function, builder);
   }
 }
@@ -46,6 +48,7 @@ void lvn_basic_block(BasicBlockPtr basic_block, Builder& builder) {
       if (li_rd->use_id_list.size() == 0) {
         curr_instr->remove(builder.context);
         std::cout << "remove unused li" << std::endl;
+        bump_counter("asm.lvn", "unused instructions removed");
       }
 
       if (li_rd->def_id_list.size() > 1) {
@@ -68,12 +71,13 @@ void lvn_basic_block(BasicBlockPtr basic_block, Builder& builder) {
       if (li_expr_map.count(imm) > 0) {
         // redundant li
         auto new_li_rd_id = li_expr_map[imm];
-        for (InstructionID use_id : li_rd->use_id_list) {
+        for (InstructionID use_id : li_rd->use_id_list.to_vector()) {
           auto use_inst = builder.context.get_instruction(use_id);
           use_inst->replace_use_operand(li_rd_id, new_li_rd_id, builder.context);
         }
         curr_instr->remove(builder.context);
         std::cout << "remove redundant li" << std::endl;
+        bump_counter("asm.lvn", "redundant instructions removed");
       } else {
         li_expr_map[imm] = li_rd_id;
       }
@@ -109,12 +113,13 @@ void lvn_basic_block(BasicBlockPtr basic_block, Builder& builder) {
       if (binary_expr_map.count(binary_expr) > 0) {
         // redundant binary
         auto new_binary_rd_id = binary_expr_map[binary_expr];
-        for (InstructionID use_id : binary_rd->use_id_list) {
+        for (InstructionID use_id : binary_rd->use_id_list.to_vector()) {
           auto use_inst = builder.context.get_instruction(use_id);
           use_inst->replace_use_operand(binary_rd_id, new_binary_rd_id, builder.context);
         }
         curr_instr->remove(builder.context);
         std::cout << "remove redundant binary" << std::endl;
+        bump_counter("asm.lvn", "redundant instructions removed");
       } else {
         binary_expr_map[binary_expr] = binary_rd_id;
       }
@@ -144,12 +149,13 @@ void lvn_basic_block(BasicBlockPtr basic_block, Builder& builder) {
       if (binary_imm_expr_map.count(binary_imm_expr) > 0) {
         // redundant binary_imm
         auto new_binary_imm_rd_id = binary_imm_expr_map[binary_imm_expr];
-        for (InstructionID use_id : binary_imm_rd->use_id_list) {
+        for (InstructionID use_id : binary_imm_rd->use_id_list.to_vector()) {
           auto use_inst = builder.context.get_instruction(use_id);
           use_inst->replace_use_operand(binary_imm_rd_id, new_binary_imm_rd_id, builder.context);
         }
         curr_instr->remove(builder.context);
         std::cout << "remove redundant binary_imm" << std::endl;
+        bump_counter("asm.lvn", "redundant instructions removed");
       } else {
         binary_imm_expr_map[binary_imm_expr] = binary_imm_rd_id;
       }
@@ -0,0 +1,139 @@
+#include "passes/asm/pass_manager.h"
+#include "parallel.h"
+#include "statistics.h"
+
+namespace syc {
+namespace backend {
+
+void PassManager::run(const std::string& name, Pass pass) {
+  flush();
+  time_pass(
+    "asm." + name, [&]() { pass(builder); },
+    [&]() { return count_instructions(); }
+  );
+}
+
+void PassManager::run_function_pass(const std::string& name, FunctionPass pass) {
+  pending_function_pass_list.emplace_back(name, pass);
+}
+
+void PassManager::run_fixpoint_group(
+  const std::string& name,
+  FixpointGroup group,
+  size_t max_round_count
+) {
+  auto counter_name = "asm." + name;
+  run_function_pass(name, [=](FunctionPtr function, Builder& builder) {
+    size_t round_count = 0;
+    bool changed = true;
+    while (changed && round_count < max_round_count) {
+      changed = false;
+      round_count++;
+      for (const auto& [pass_name, pass] : group) {
+        if (pass(function, builder)) {
+          bump_counter(counter_name, pass_name + " changes");
+          changed = true;
+        }
+      }
+    }
+    bump_counter(counter_name, "rounds", round_count);
+    if (changed) {
+      bump_counter(counter_name, "functions at round limit");
+    }
+  });
+}
+
+void PassManager::flush() {
+  if (pending_function_pass_list.empty()) {
+    return;
+  }
+
+  auto& context = builder.context;
+  auto& statistics = get_statistics();
+  auto pass_count = pending_function_pass_list.size();
+
+  std::vector<FunctionPtr> function_list;
+  std::vector<size_t> size_list;
+  for (const auto& [function_name, function] : context.function_table) {
+    function_list.push_back(function);
+    size_list.push_back(count_function_instructions(function));
+  }
+  auto order_list = largest_first_order(size_list);
+
+  // Records of each pass on each function, summed up after all the threads.
+  std::vector<std::vector<PassRecord>> record_table(
+    function_list.size(), std::vector<PassRecord>(pass_count)
+  );
+  std::vector<double> seconds_list(function_list.size(), 0);
+  parallel_for(order_list.size(), thread_count, [&](size_t index) {
+    auto function_index = order_list[index];
+    auto function = function_list[function_index];
+    auto worker = Builder(context);
+    worker.switch_function(function->name);
+    auto function_start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < pass_count; i++) {
+      auto& pass = pending_function_pass_list[i].second;
+      if (!statistics.enabled) {
+        pass(function, worker);
+        continue;
+      }
+      auto& record = record_table[function_index][i];
+      record.instruction_count_before = count_function_instructions(function);
+      auto start = std::chrono::steady_clock::now();
+      pass(function, worker);
+      auto end = std::chrono::steady_clock::now();
+      record.seconds = std::chrono::duration<double>(end - start).count();
+      record.instruction_count_after = count_function_instructions(function);
+    }
+    auto function_end = std::chrono::steady_clock::now();
+    seconds_list[function_index] =
+      std::chrono::duration<double>(function_end - function_start).count();
+  });
+
+  for (size_t i = 0; i < function_list.size(); i++) {
+    function_seconds_map[function_list[i]->name] += seconds_list[i];
+  }
+
+  if (statistics.enabled) {
+    // The functions run concurrently, so the memory usage is only read once
+    // all of them are done.
+    auto memory_after = read_memory_usage();
+    for (size_t i = 0; i < pass_count; i++) {
+      PassRecord summary{
+        "asm." + pending_function_pass_list[i].first, 0, 0, 0, memory_after};
+      for (const auto& record_list : record_table) {
+        summary.seconds += record_list[i].seconds;
+        summary.instruction_count_before +=
+          record_list[i].instruction_count_before;
+        summary.instruction_count_after +=
+          record_list[i].instruction_count_after;
+      }
+      statistics.pass_record_list.push_back(summary);
+    }
+  }
+
+  pending_function_pass_list.clear();
+}
+
+size_t PassManager::count_instructions() const {
+  size_t count = 0;
+  for (const auto& [function_name, function] : builder.context.function_table) {
+    count += count_function_instructions(function);
+  }
+  return count;
+}
+
+size_t count_function_instructions(FunctionPtr function) {
+  size_t count = 0;
+  for (auto bb = function->head_basic_block->next;
+       bb != function->tail_basic_block; bb = bb->next) {
+    for (auto instr = bb->head_instruction->next;
+         instr != bb->tail_instruction; instr = instr->next) {
+      count++;
+    }
+  }
+  return count;
+}
+
+}  // namespace backend
+}  // namespace syc
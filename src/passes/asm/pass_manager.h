@@ -0,0 +1,67 @@
+#ifndef SYC_PASSES_ASM_PASS_MANAGER_H_
+#define SYC_PASSES_ASM_PASS_MANAGER_H_
+
+#include "backend/builder.h"
+#include "common.h"
+
+namespace syc {
+namespace backend {
+
+/// Run passes on the assembly and record them in the statistics.
+///
+/// Function passes are queued and run function by function, on up to
+/// `thread_count` threads, when a module pass is reached or on `flush`. Each
+/// function allocates its operands, instructions and blocks in its own ID
+/// space, so the result does not depend on the number of threads.
+struct PassManager {
+  using Pass = std::function<void(Builder&)>;
+  using FunctionPass = std::function<void(FunctionPtr, Builder&)>;
+  /// Function pass that returns if it changed anything.
+  using ChangeFunctionPass = std::function<bool(FunctionPtr, Builder&)>;
+  /// Named passes of a fixpoint group, run in order in each round.
+  using FixpointGroup =
+    std::vector<std::pair<std::string, ChangeFunctionPass>>;
+
+  /// Default number of rounds after which a fixpoint group gives up.
+  static constexpr size_t DEFAULT_MAX_ROUND_COUNT = 8;
+
+  Builder& builder;
+
+  /// Number of threads to run the function passes on.
+  size_t thread_count = 1;
+  /// Function passes waiting for `flush`.
+  std::vector<std::pair<std::string, FunctionPass>> pending_function_pass_list;
+  /// Seconds spent in the function passes on each function.
+  std::map<std::string, double> function_seconds_map;
+
+  PassManager(Builder& builder) : builder(builder) {}
+
+  /// Run a pass.
+  void run(const std::string& name, Pass pass);
+
+  /// Queue a pass on each function.
+  void run_function_pass(const std::string& name, FunctionPass pass);
+
+  /// Queue a group of passes. On each function, the group runs round after
+  /// round until no pass changes anything, or until `max_round_count` rounds
+  /// are run. See `ir::PassManager::run_fixpoint_group`.
+  void run_fixpoint_group(
+    const std::string& name,
+    FixpointGroup group,
+    size_t max_round_count = DEFAULT_MAX_ROUND_COUNT
+  );
+
+  /// Run the queued function passes on all the functions.
+  void flush();
+
+  /// Number of instructions in all the functions, for the statistics.
+  size_t count_instructions() const;
+};
+
+/// Number of instructions in a function.
+size_t count_function_instructions(FunctionPtr function);
+
+}  // namespace backend
+}  // namespace syc
+
+#endif
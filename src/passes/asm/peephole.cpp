@@ -12,23 +12,28 @@ namespace backend {
 
 void peephole(Builder& builder) {
   for (auto [function_name, function] : builder.context.function_table) {
+    builder.switch_function(function_name);
     peephole_function(function, builder);
   }
 }
 
-void peephole_function(FunctionPtr function, Builder& builder) {
+bool peephole_function(FunctionPtr function, Builder& builder) {
+  bool changed = false;
   auto curr_basic_block = function->head_basic_block->next;
   while (curr_basic_block != function->tail_basic_block) {
-    peephole_basic_block(curr_basic_block, builder);
+    changed = peephole_basic_block(curr_basic_block, builder) || changed;
     curr_basic_block = curr_basic_block->next;
   }
+  return changed;
 }
 
-void peephole_basic_block(BasicBlockPtr basic_block, Builder& builder) {
+bool peephole_basic_block(BasicBlockPtr basic_block, Builder& builder) {
   using namespace instruction;
 
   // TODO: reaching definition analysis
 
+  bool changed = false;
+
   auto curr_instruction = basic_block->head_instruction->next;
   while (curr_instruction != basic_block->tail_instruction) {
     auto next_instruction = curr_instruction->next;
@@ -46,7 +51,7 @@ void peephole_basic_block(BasicBlockPtr basic_block, Builder& builder) {
         if (rd->def_id_list.size() == 1 && (rs->def_id_list.size() == 1 || rs->is_sp())) {
           // remove: addi(w) v0, v1, 0
           // make all the uses of v0 use v1 instead
-          auto use_id_list_copy = rd->use_id_list;
+          auto use_id_list_copy = rd->use_id_list.to_vector();
           for (auto use_instruction_id : use_id_list_copy) {
             auto instruction =
               builder.context.get_instruction(use_instruction_id);
@@ -54,6 +59,7 @@ void peephole_basic_block(BasicBlockPtr basic_block, Builder& builder) {
           }
 
           curr_instruction->remove(builder.context);
+          changed = true;
         }
       } else if (rd->is_vreg() && rs->is_sp() && op == BinaryImm::ADDI) {
         // remove unnecessary offset calculation
@@ -71,6 +77,7 @@ void peephole_basic_block(BasicBlockPtr basic_block, Builder& builder) {
             next_instruction->replace_operand(
               load_imm->id, imm->id, builder.context
             );
+            changed = true;
 
             // remove current instruction
             if (rd->use_id_list.size() == 0) {
@@ -92,6 +99,7 @@ void peephole_basic_block(BasicBlockPtr basic_block, Builder& builder) {
             next_instruction->replace_operand(
               store_imm->id, imm->id, builder.context
             );
+            changed = true;
 
             // remove current instruction
             if (rd->use_id_list.size() == 0) {
@@ -112,7 +120,7 @@ void peephole_basic_block(BasicBlockPtr basic_block, Builder& builder) {
       if (rd->is_vreg() && imm->is_zero() && rd->def_id_list.size() == 1) {
         // remove: lui v0, 0
         // make all the uses of v0 use zero instead
-        auto use_id_list_copy = rd->use_id_list;
+        auto use_id_list_copy = rd->use_id_list.to_vector();
         for (auto use_instruction_id : use_id_list_copy) {
           auto instruction =
             builder.context.get_instruction(use_instruction_id);
@@ -122,6 +130,7 @@ void peephole_basic_block(BasicBlockPtr basic_block, Builder& builder) {
           );
         }
         curr_instruction->remove(builder.context);
+        changed = true;
       }
     }
 
@@ -140,7 +149,7 @@ void peephole_basic_block(BasicBlockPtr basic_block, Builder& builder) {
 
       if (rd->is_vreg() && (rs1->is_zero() || rs2->is_zero()) && (op == Binary::MUL || op == Binary::MULW)) {
         if (rd->def_id_list.size() == 1) {
-          auto use_id_list_copy = rd->use_id_list;
+          auto use_id_list_copy = rd->use_id_list.to_vector();
           for (auto use_instruction_id : use_id_list_copy) {
             auto instruction =
               builder.context.get_instruction(use_instruction_id);
@@ -150,26 +159,29 @@ void peephole_basic_block(BasicBlockPtr basic_block, Builder& builder) {
             );
           }
           curr_instruction->remove(builder.context);
+          changed = true;
         }
       } else if (rd->is_vreg() && rs1->is_zero() && (op == Binary::ADD || op == Binary::ADDW)) {
         if (rd->def_id_list.size() == 1 && (rs2->def_id_list.size() == 1 || rs2->is_sp())) {
-          auto use_id_list_copy = rd->use_id_list;
+          auto use_id_list_copy = rd->use_id_list.to_vector();
           for (auto use_instruction_id : use_id_list_copy) {
             auto instruction =
               builder.context.get_instruction(use_instruction_id);
             instruction->replace_operand(rd->id, rs2->id, builder.context);
           }
           curr_instruction->remove(builder.context);
+          changed = true;
         }
       } else if (rd->is_vreg() && rs2->is_zero() && (op == Binary::ADD || op == Binary::ADDW || op == Binary::SUB || op == Binary::SUBW)) {
         if (rd->def_id_list.size() == 1 && (rs1->def_id_list.size() == 1 || rs1->is_sp())) {
-          auto use_id_list_copy = rd->use_id_list;
+          auto use_id_list_copy = rd->use_id_list.to_vector();
           for (auto use_instruction_id : use_id_list_copy) {
             auto instruction =
               builder.context.get_instruction(use_instruction_id);
             instruction->replace_operand(rd->id, rs1->id, builder.context);
           }
           curr_instruction->remove(builder.context);
+          changed = true;
         }
       }
     }
@@ -184,7 +196,7 @@ void peephole_basic_block(BasicBlockPtr basic_block, Builder& builder) {
       if (rd->is_vreg() && imm->is_zero() && rd->def_id_list.size() == 1) {
         // remove: li v0, 0
         // make all the uses of v0 use zero instead
-        auto use_id_list_copy = rd->use_id_list;
+        auto use_id_list_copy = rd->use_id_list.to_vector();
         for (auto use_instruction_id : use_id_list_copy) {
           auto instruction =
             builder.context.get_instruction(use_instruction_id);
@@ -194,6 +206,7 @@ void peephole_basic_block(BasicBlockPtr basic_block, Builder& builder) {
           );
         }
         curr_instruction->remove(builder.context);
+        changed = true;
         // std::cout << "remove li" << std::endl;
       } else {
         auto next1_instr = curr_instruction->next;
@@ -255,6 +268,7 @@ void peephole_basic_block(BasicBlockPtr basic_block, Builder& builder) {
 
             // Remove mul
             next2_instr->remove(builder.context);
+            changed = true;
           }
         } else if (match1) {
           auto add_dst = builder.context.get_operand(maybe_next1_add->rd_id);
@@ -272,6 +286,7 @@ void peephole_basic_block(BasicBlockPtr basic_block, Builder& builder) {
               );
               curr_instruction->insert_next(addi_instr);
               next1_instr->remove(builder.context);
+              changed = true;
               next_instruction = addi_instr;
             }
           }
@@ -293,6 +308,7 @@ void peephole_basic_block(BasicBlockPtr basic_block, Builder& builder) {
               );
               curr_instruction->insert_next(slli_instr);
               next1_instr->remove(builder.context);
+              changed = true;
               next_instruction = slli_instr;
             }
           }
@@ -312,6 +328,7 @@ void peephole_basic_block(BasicBlockPtr basic_block, Builder& builder) {
               );
               curr_instruction->insert_next(addi_instr);
               next1_instr->remove(builder.context);
+              changed = true;
               next_instruction = addi_instr;
             }
           }
@@ -321,6 +338,8 @@ void peephole_basic_block(BasicBlockPtr basic_block, Builder& builder) {
 
     curr_instruction = next_instruction;
   }
+
+  return changed;
 }
 
 }  // namespace backend
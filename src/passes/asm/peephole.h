@@ -8,9 +8,10 @@ namespace backend {
 
 void peephole(Builder& builder);
 
-void peephole_function(FunctionPtr function, Builder& builder);
+/// Simplify the instructions of the function, return if anything changed.
+bool peephole_function(FunctionPtr function, Builder& builder);
 
-void peephole_basic_block(BasicBlockPtr basic_block, Builder& builder);
+bool peephole_basic_block(BasicBlockPtr basic_block, Builder& builder);
 
 }  // namespace backend
 }  // namespace syc
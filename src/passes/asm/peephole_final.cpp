@@ -9,6 +9,7 @@ namespace backend {
 
 void peephole_final(Builder& builder) {
   for (auto [function_name, function] : builder.context.function_table) {
+    builder.switch_function(function_name);
     peephole_final_function(function, builder);
   }
 }
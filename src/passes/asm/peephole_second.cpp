@@ -11,6 +11,7 @@ namespace backend {
 
 void peephole_second(Builder& builder) {
   for (auto [function_name, function] : builder.context.function_table) {
+    builder.switch_function(function_name);
     peephole_second_function(function, builder);
   }
 }
@@ -11,6 +11,7 @@ namespace backend {
 
 void store_fuse(Builder& builder) {
   for (auto [function_name, function] : builder.context.function_table) {
+    builder.switch_function(function_name);
     store_fuse_function(function, builder);
   }
 }
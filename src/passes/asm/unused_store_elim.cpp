@@ -10,6 +10,7 @@ namespace backend {
 
 void unused_store_elim(Builder& builder) {
   for (auto [function_name, function] : builder.context.function_table) {
+    builder.switch_function(function_name);
     unused_store_elim_function(function, builder);
   }
 }
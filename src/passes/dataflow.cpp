@@ -0,0 +1,144 @@
+#include "passes/dataflow.h"
+
+namespace syc {
+
+DataflowProblem::DataflowProblem(
+  DataflowDirection direction,
+  DataflowMeet meet,
+  size_t block_count,
+  size_t bit_count
+)
+  : direction(direction),
+    meet(meet),
+    bit_count(bit_count),
+    succ_list_table(block_count),
+    pred_list_table(block_count),
+    gen_list(block_count, BitSet(bit_count)),
+    kill_list(block_count, BitSet(bit_count)) {}
+
+void DataflowProblem::add_edge(size_t from, size_t to) {
+  succ_list_table[from].push_back(to);
+  pred_list_table[to].push_back(from);
+}
+
+std::vector<size_t> reverse_post_order(
+  const std::vector<std::vector<size_t>>& succ_list_table
+) {
+  auto block_count = succ_list_table.size();
+  std::vector<size_t> order;
+  order.reserve(block_count);
+  if (block_count == 0) {
+    return order;
+  }
+
+  std::vector<bool> visited(block_count, false);
+  // Blocks on the path and the index of the next successor to visit.
+  std::vector<std::pair<size_t, size_t>> stack;
+  stack.emplace_back(0, 0);
+  visited[0] = true;
+  while (!stack.empty()) {
+    auto& [block, next_succ] = stack.back();
+    const auto& succ_list = succ_list_table[block];
+    if (next_succ < succ_list.size()) {
+      auto succ = succ_list[next_succ++];
+      if (!visited[succ]) {
+        visited[succ] = true;
+        stack.emplace_back(succ, 0);
+      }
+      continue;
+    }
+    order.push_back(block);
+    stack.pop_back();
+  }
+  std::reverse(order.begin(), order.end());
+
+  for (size_t block = 0; block < block_count; block++) {
+    if (!visited[block]) {
+      order.push_back(block);
+    }
+  }
+
+  return order;
+}
+
+DataflowResult solve_dataflow(const DataflowProblem& problem) {
+  auto block_count = problem.block_count();
+  auto bit_count = problem.bit_count;
+  bool forward = problem.direction == DataflowDirection::Forward;
+  bool is_union = problem.meet == DataflowMeet::Union;
+
+  // Facts start at the identity of the meet and only move away from it.
+  DataflowResult result;
+  result.in_list.assign(block_count, BitSet(bit_count, !is_union));
+  result.out_list.assign(block_count, BitSet(bit_count, !is_union));
+
+  auto order = reverse_post_order(problem.succ_list_table);
+  if (!forward) {
+    std::reverse(order.begin(), order.end());
+  }
+  std::vector<size_t> position_list(block_count);
+  for (size_t i = 0; i < block_count; i++) {
+    position_list[order[i]] = i;
+  }
+
+  // Where the input of a block comes from and where its output goes to.
+  const auto& source_table =
+    forward ? problem.pred_list_table : problem.succ_list_table;
+  const auto& target_table =
+    forward ? problem.succ_list_table : problem.pred_list_table;
+  auto& input_list = forward ? result.in_list : result.out_list;
+  auto& output_list = forward ? result.out_list : result.in_list;
+
+  // Positions in the order, so the earliest block is taken first.
+  std::priority_queue<size_t, std::vector<size_t>, std::greater<size_t>>
+    worklist;
+  std::vector<bool> queued(block_count, true);
+  for (size_t i = 0; i < block_count; i++) {
+    worklist.push(i);
+  }
+
+  BitSet output(bit_count);
+  while (!worklist.empty()) {
+    auto block = order[worklist.top()];
+    worklist.pop();
+    queued[block] = false;
+    result.evaluation_count++;
+
+    auto& input = input_list[block];
+    const auto& source_list = source_table[block];
+    bool is_boundary =
+      source_list.empty() || (forward && block == 0 && !is_union);
+    if (is_boundary) {
+      // Nothing holds at the boundary, the entry of a forward union problem
+      // just has nothing to add to its predecessors.
+      std::fill(input.word_list.begin(), input.word_list.end(), 0);
+    } else {
+      input = output_list[source_list.front()];
+      for (size_t i = 1; i < source_list.size(); i++) {
+        if (is_union) {
+          input.union_with(output_list[source_list[i]]);
+        } else {
+          input.intersect_with(output_list[source_list[i]]);
+        }
+      }
+    }
+
+    output = input;
+    output.subtract(problem.kill_list[block]);
+    output.union_with(problem.gen_list[block]);
+
+    if (output != output_list[block]) {
+      std::swap(output, output_list[block]);
+      for (auto target : target_table[block]) {
+        if (!queued[target]) {
+          queued[target] = true;
+          worklist.push(position_list[target]);
+        }
+      }
+    }
+  }
+
+  return result;
+}
+
+}  // namespace syc
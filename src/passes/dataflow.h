@@ -0,0 +1,172 @@
+#ifndef SYC_PASSES_DATAFLOW_H_
+#define SYC_PASSES_DATAFLOW_H_
+
+#include "common.h"
+
+namespace syc {
+
+/// Fixed-size set of small integers stored as bits.
+struct BitSet {
+  std::vector<uint64_t> word_list;
+  size_t bit_count = 0;
+
+  BitSet() = default;
+
+  explicit BitSet(size_t bit_count, bool value = false)
+    : word_list((bit_count + 63) / 64, value ? ~uint64_t(0) : 0),
+      bit_count(bit_count) {
+    clear_padding();
+  }
+
+  void set(size_t index) {
+    word_list[index / 64] |= uint64_t(1) << (index % 64);
+  }
+
+  void reset(size_t index) {
+    word_list[index / 64] &= ~(uint64_t(1) << (index % 64));
+  }
+
+  bool test(size_t index) const {
+    return (word_list[index / 64] >> (index % 64)) & 1;
+  }
+
+  /// Add all the bits of `other`, return if any bit is added.
+  bool union_with(const BitSet& other) {
+    uint64_t added = 0;
+    for (size_t i = 0; i < word_list.size(); i++) {
+      added |= other.word_list[i] & ~word_list[i];
+      word_list[i] |= other.word_list[i];
+    }
+    return added != 0;
+  }
+
+  /// Keep only the bits also in `other`, return if any bit is removed.
+  bool intersect_with(const BitSet& other) {
+    uint64_t removed = 0;
+    for (size_t i = 0; i < word_list.size(); i++) {
+      removed |= word_list[i] & ~other.word_list[i];
+      word_list[i] &= other.word_list[i];
+    }
+    return removed != 0;
+  }
+
+  /// Remove all the bits of `other`.
+  void subtract(const BitSet& other) {
+    for (size_t i = 0; i < word_list.size(); i++) {
+      word_list[i] &= ~other.word_list[i];
+    }
+  }
+
+  bool operator==(const BitSet& other) const {
+    return word_list == other.word_list;
+  }
+
+  bool operator!=(const BitSet& other) const { return !(*this == other); }
+
+  /// Call `f(index)` for each set bit in increasing order.
+  template <typename F>
+  void for_each(F&& f) const {
+    for (size_t i = 0; i < word_list.size(); i++) {
+      auto word = word_list[i];
+      while (word != 0) {
+        f(i * 64 + __builtin_ctzll(word));
+        word &= word - 1;
+      }
+    }
+  }
+
+  /// Number of set bits.
+  size_t count() const {
+    size_t result = 0;
+    for (auto word : word_list) {
+      result += __builtin_popcountll(word);
+    }
+    return result;
+  }
+
+  /// Bits past `bit_count` in the last word are kept zero.
+  void clear_padding() {
+    if (bit_count % 64 != 0) {
+      word_list.back() &= (uint64_t(1) << (bit_count % 64)) - 1;
+    }
+  }
+};
+
+enum class DataflowDirection {
+  /// Facts flow from the entry along the edges, e.g. reaching definitions.
+  Forward,
+  /// Facts flow from the exits against the edges, e.g. liveness.
+  Backward,
+};
+
+enum class DataflowMeet {
+  /// A fact holds if it holds on any path, starting from no facts.
+  Union,
+  /// A fact holds if it holds on all paths, starting from all facts.
+  Intersection,
+};
+
+/// A bit-vector dataflow problem over the blocks of a function.
+///
+/// Blocks are numbered from 0, with block 0 being the entry, and facts are
+/// numbered from 0 to `bit_count`, e.g. by a per-function numbering of the
+/// registers. The transfer function of a block is `gen | (input - kill)`,
+/// where the input is the meet over the predecessors for a forward problem and
+/// over the successors for a backward one. The boundary, i.e. the input of the
+/// entry or of the blocks without successors, is empty.
+struct DataflowProblem {
+  DataflowDirection direction = DataflowDirection::Forward;
+  DataflowMeet meet = DataflowMeet::Union;
+
+  size_t bit_count = 0;
+
+  /// Successors of each block.
+  std::vector<std::vector<size_t>> succ_list_table;
+  /// Predecessors of each block.
+  std::vector<std::vector<size_t>> pred_list_table;
+
+  /// Facts generated by each block.
+  std::vector<BitSet> gen_list;
+  /// Facts killed by each block.
+  std::vector<BitSet> kill_list;
+
+  DataflowProblem(
+    DataflowDirection direction,
+    DataflowMeet meet,
+    size_t block_count,
+    size_t bit_count
+  );
+
+  size_t block_count() const { return succ_list_table.size(); }
+
+  /// Add an edge, the predecessor lists are kept in sync.
+  void add_edge(size_t from, size_t to);
+};
+
+/// Facts at the start and the end of each block.
+struct DataflowResult {
+  /// Facts at the start of each block.
+  std::vector<BitSet> in_list;
+  /// Facts at the end of each block.
+  std::vector<BitSet> out_list;
+
+  /// Number of times a block is evaluated.
+  size_t evaluation_count = 0;
+};
+
+/// Blocks in reverse post-order from the entry, the unreachable blocks last.
+std::vector<size_t> reverse_post_order(
+  const std::vector<std::vector<size_t>>& succ_list_table
+);
+
+/// Solve the problem to the fixpoint.
+///
+/// Blocks are taken from a worklist in reverse post-order for a forward
+/// problem and in post-order for a backward one, so that most blocks are
+/// evaluated after the blocks they depend on, and a block is only evaluated
+/// again when one of its inputs changes.
+DataflowResult solve_dataflow(const DataflowProblem& problem);
+
+}  // namespace syc
+
+#endif
@@ -1,9 +1,14 @@
 #include "passes/ir/auto_inline.h"
+#include "passes/ir/pass_manager.h"
+#include "statistics.h"
 
 namespace syc {
 namespace ir {
 
-void auto_inline(Builder& builder) {
+void auto_inline(Builder& builder, const InlineBudget& budget) {
+  auto start = std::chrono::steady_clock::now();
+  size_t growth = 0;
+
   std::vector<std::string> to_be_removed;
   for (auto [function_name, function] : builder.context.function_table) {
     if (function->is_declare) {
@@ -15,7 +20,7 @@ void auto_inline(Builder& builder) {
       auto call_instruction = builder.context.get_instruction(call_id);
       auto parent_basic_block =
         builder.context.get_basic_block(call_instruction->parent_block_id);
-      if (function_name == parent_basic_block->parent_function_name) {
+      if (function.get() == parent_basic_block->parent_function) {
         is_rec = true;
         break;
       }
@@ -23,10 +28,24 @@ void auto_inline(Builder& builder) {
     if (is_rec) {
       continue;
     }
+    // The calls over the budget are kept, and so is the callee.
+    auto function_size = count_function_instructions(function);
     auto caller_id_list_copy = function->caller_id_list;
     for (auto call_id : caller_id_list_copy) {
+      std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+      if ((budget.max_callee_size.has_value() &&
+           function_size > budget.max_callee_size.value()) ||
+          (budget.max_growth.has_value() &&
+           growth + function_size > budget.max_growth.value()) ||
+          (budget.max_seconds.has_value() &&
+           elapsed.count() > budget.max_seconds.value())) {
+        bump_counter("ir.auto_inline", "calls over budget");
+        continue;
+      }
       auto call_instruction = builder.context.get_instruction(call_id);
       auto_inline_instruction(call_instruction, builder);
+      growth += function_size;
     }
     if (function->caller_id_list.size() == 0 && function->name != "main") {
       to_be_removed.push_back(function_name);
@@ -55,12 +74,12 @@ void auto_inline_instruction(InstructionPtr instruction, Builder& builder) {
 
   auto call = instruction->as<Call>().value();
 
-  auto function = builder.context.get_function(call.function_name);
+  auto function = builder.context.get_function(call.callee->name);
 
   auto parent_basic_block =
     builder.context.get_basic_block(instruction->parent_block_id);
 
-  auto parent_function_name = parent_basic_block->parent_function_name;
+  auto parent_function_name = parent_basic_block->parent_function->name;
 
   builder.switch_function(parent_function_name);
 
@@ -128,8 +147,8 @@ void auto_inline_instruction(InstructionPtr instruction, Builder& builder) {
   }
 
   // Map return value
-  auto exit_basic_block = function->tail_basic_block->prev.lock();
-  auto ret_instruction = exit_basic_block->tail_instruction->prev.lock();
+  auto exit_basic_block = function->tail_basic_block->prev;
+  auto ret_instruction = exit_basic_block->tail_instruction->prev;
 
   if (!ret_instruction->is_ret()) {
     std::cerr << "Error: Return instruction not found in the end of function "
@@ -142,20 +161,14 @@ void auto_inline_instruction(InstructionPtr instruction, Builder& builder) {
       ret_value_id = context.operand_id_map.at(ret_value_id);
     }
     auto dst = builder.context.get_operand(call.maybe_dst_id.value());
-    auto use_id_list_copy = dst->use_id_list;
-    for (auto use_id : use_id_list_copy) {
-      auto use_instruction = builder.context.get_instruction(use_id);
-
-      use_instruction->replace_operand(
-        call.maybe_dst_id.value(), ret_value_id, builder.context
-      );
-    }
+    dst->replace_all_uses_with(ret_value_id, builder.context);
   }
 
   // Add terminators
   builder.context.get_function(parent_function_name)->add_terminators(builder);
 
   instruction->remove(builder.context);
+  bump_counter("ir.auto_inline", "calls inlined");
 }
 
 OperandID clone_operand(
@@ -295,7 +308,7 @@ InstructionPtr clone_instruction(
         }
 
         auto new_instruction = builder.fetch_call_instruction(
-          maybe_dst_id, call.function_name, arg_id_list
+          maybe_dst_id, call.callee->name, arg_id_list
         );
 
         new_instruction->parent_block_id =
@@ -305,25 +318,14 @@ InstructionPtr clone_instruction(
       },
       [&](const Alloca& alloca) -> InstructionPtr {
         auto dst_id = clone_operand(alloca.dst_id, builder, context);
-        std::optional<OperandID> maybe_size_id = std::nullopt;
         std::optional<OperandID> maybe_align_id = std::nullopt;
-        std::optional<OperandID> maybe_addrspace_id = std::nullopt;
-        if (alloca.maybe_size_id.has_value()) {
-          maybe_size_id =
-            clone_operand(alloca.maybe_size_id.value(), builder, context);
-        }
         if (alloca.maybe_align_id.has_value()) {
           maybe_align_id =
             clone_operand(alloca.maybe_align_id.value(), builder, context);
         }
-        if (alloca.maybe_addrspace_id.has_value()) {
-          maybe_addrspace_id =
-            clone_operand(alloca.maybe_addrspace_id.value(), builder, context);
-        }
 
         auto new_instruction = builder.fetch_alloca_instruction(
-          dst_id, alloca.allocated_type, maybe_size_id, maybe_align_id,
-          maybe_addrspace_id, false
+          dst_id, alloca.allocated_type, maybe_align_id, false
         );
 
         // This should be updated after append and prepend.
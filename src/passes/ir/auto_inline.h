@@ -18,7 +18,22 @@ struct AutoInlineContext {
   AutoInlineContext() = default;
 };
 
-void auto_inline(Builder& builder);
+/// Limits of the growth of the module by inlining, none for no limit.
+struct InlineBudget {
+  /// Largest callee that is inlined, in instructions.
+  std::optional<size_t> max_callee_size = std::nullopt;
+  /// Most instructions added to the module.
+  std::optional<size_t> max_growth = std::nullopt;
+  /// Seconds after which no more calls are inlined.
+  std::optional<double> max_seconds = std::nullopt;
+};
+
+/// Inline the calls to non-recursive functions within the budget, and remove
+/// the functions that are no longer called.
+void auto_inline(
+  Builder& builder,
+  const InlineBudget& budget = InlineBudget()
+);
 
 void auto_inline_instruction(InstructionPtr instruction, Builder& builder);
 
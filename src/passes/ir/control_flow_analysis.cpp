@@ -1,4 +1,6 @@
 #include "passes/ir/control_flow_analysis.h"
+#include "ir/basic_block.h"
+#include "statistics.h"
 
 namespace syc {
 namespace ir {
@@ -8,142 +10,450 @@ void control_flow_analysis(
   Context& context,
   ControlFlowAnalysisContext& cfa_ctx
 ) {
-  cfa_ctx.idom_map.clear();
-  cfa_ctx.dominance_frontier_map.clear();
+  cfa_ctx.dom_tree.build(function, context);
+}
 
-  // Compute idom
-  auto entry_bb = function->head_basic_block->next;
+void DominatorTree::build(FunctionPtr function, Context& context) {
+  block_id_list.clear();
+  block_index_map.clear();
 
-  auto bb_id_set = std::set<BasicBlockID>();
-  auto bb_id_postorder = std::vector<BasicBlockID>();
-  auto bb_id_visited = std::map<BasicBlockID, bool>();
+  for (auto bb = function->head_basic_block->next;
+       bb != function->tail_basic_block; bb = bb->next) {
+    block_index_map[bb->id] = block_id_list.size();
+    block_id_list.push_back(bb->id);
+  }
 
-  size_t postorder_number = 0;
-  auto postorder_number_map = std::map<BasicBlockID, size_t>();
+  auto count = block_count();
+  entry_index = 0;
+  removed_list.assign(count, false);
+  succ_list_table.assign(count, {});
+  pred_list_table.assign(count, {});
 
-  auto curr_bb = function->head_basic_block->next;
-  while (curr_bb != function->tail_basic_block) {
-    bb_id_set.insert(curr_bb->id);
-    bb_id_visited[curr_bb->id] = false;
-    curr_bb = curr_bb->next;
+  for (size_t index = 0; index < count; index++) {
+    auto bb = context.get_basic_block(block_id_list[index]);
+    for (auto succ_id : bb->succ_list) {
+      link(index, index_of(succ_id));
+    }
   }
 
-  // Get postorder
-  std::function<void(BasicBlockID)> dfs = [&](BasicBlockID bb_id) {
-    bb_id_visited[bb_id] = true;
+  rebuild();
+}
 
-    auto bb = context.get_basic_block(bb_id);
+void DominatorTree::rebuild() {
+  idom_list.assign(block_count(), NONE);
+  std::vector<bool> member_list(block_count());
+  for (size_t index = 0; index < block_count(); index++) {
+    member_list[index] = !removed_list[index];
+  }
+  solve(entry_index, member_list);
+  refresh();
+}
 
-    for (auto succ_id : bb->succ_list) {
-      if (!bb_id_visited[succ_id]) {
-        dfs(succ_id);
+void DominatorTree::solve(size_t root, const std::vector<bool>& member_list) {
+  auto count = block_count();
+
+  // Postorder by an explicit stack of blocks and the next successor to visit.
+  std::vector<size_t> postorder_number_list(count, NONE);
+  std::vector<size_t> postorder;
+  std::vector<bool> visited_list(count, false);
+  std::vector<std::pair<size_t, size_t>> stack;
+
+  visited_list[root] = true;
+  stack.emplace_back(root, 0);
+  while (!stack.empty()) {
+    auto index = stack.back().first;
+    auto succ_pos = stack.back().second;
+    if (succ_pos < succ_list_table[index].size()) {
+      stack.back().second++;
+      auto succ = succ_list_table[index][succ_pos];
+      if (member_list[succ] && !visited_list[succ]) {
+        visited_list[succ] = true;
+        stack.emplace_back(succ, 0);
       }
+    } else {
+      postorder_number_list[index] = postorder.size();
+      postorder.push_back(index);
+      stack.pop_back();
     }
+  }
+
+  // Cooper, Harvey and Kennedy's iterative algorithm in reverse postorder.
+  std::vector<size_t> new_idom_list(count, NONE);
+  new_idom_list[root] = root;
 
-    bb_id_postorder.push_back(bb_id);
-    postorder_number_map[bb_id] = postorder_number;
-    postorder_number++;
+  auto intersect = [&](size_t lhs, size_t rhs) {
+    while (lhs != rhs) {
+      while (postorder_number_list[lhs] < postorder_number_list[rhs]) {
+        lhs = new_idom_list[lhs];
+      }
+      while (postorder_number_list[rhs] < postorder_number_list[lhs]) {
+        rhs = new_idom_list[rhs];
+      }
+    }
+    return lhs;
   };
 
-  dfs(entry_bb->id);
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (auto it = postorder.rbegin(); it != postorder.rend(); it++) {
+      auto index = *it;
+      if (index == root) {
+        continue;
+      }
 
-  // Reverse postorder
-  auto bb_id_rev_postorder = bb_id_postorder;
-  std::reverse(bb_id_rev_postorder.begin(), bb_id_rev_postorder.end());
+      auto new_idom = NONE;
+      for (auto pred : pred_list_table[index]) {
+        if (postorder_number_list[pred] == NONE ||
+            new_idom_list[pred] == NONE) {
+          continue;
+        }
+        new_idom = new_idom == NONE ? pred : intersect(pred, new_idom);
+      }
 
-  // Initialize idom_map
-  for (auto bb_id : bb_id_set) {
-    cfa_ctx.idom_map[bb_id] = std::nullopt;
+      if (new_idom_list[index] != new_idom) {
+        new_idom_list[index] = new_idom;
+        changed = true;
+      }
+    }
   }
 
-  // Initialize entry block
-  cfa_ctx.idom_map[entry_bb->id] = entry_bb->id;
+  for (size_t index = 0; index < count; index++) {
+    if (member_list[index] && index != root) {
+      idom_list[index] = new_idom_list[index];
+    }
+  }
+}
 
-  std::function<BasicBlockID(BasicBlockID, BasicBlockID)> intersect =
-    [&](BasicBlockID bb_lhs, BasicBlockID bb_rhs) {
-      auto finger1 = bb_lhs;
-      auto finger2 = bb_rhs;
+void DominatorTree::refresh() {
+  auto count = block_count();
 
-      while (finger1 != finger2) {
-        while (postorder_number_map[finger1] < postorder_number_map[finger2]) {
-          finger1 = cfa_ctx.idom_map[finger1].value();
-        }
-        while (postorder_number_map[finger2] < postorder_number_map[finger1]) {
-          finger2 = cfa_ctx.idom_map[finger2].value();
-        }
+  child_list_table.assign(count, {});
+  for (size_t index = 0; index < count; index++) {
+    if (!removed_list[index] && idom_list[index] != NONE) {
+      child_list_table[idom_list[index]].push_back(index);
+    }
+  }
+  for (auto& child_list : child_list_table) {
+    std::sort(
+      child_list.begin(), child_list.end(),
+      [&](size_t lhs, size_t rhs) {
+        return block_id_list[lhs] < block_id_list[rhs];
       }
+    );
+  }
 
-      return finger1;
-    };
+  // Number the intervals by an explicit stack of blocks and the next child.
+  enter_list.assign(count, NONE);
+  leave_list.assign(count, NONE);
 
-  bool changed = true;
-  while (changed) {
-    changed = false;
-    for (auto bb_id : bb_id_rev_postorder) {
-      if (bb_id == entry_bb->id) {
+  size_t number = 0;
+  std::vector<std::pair<size_t, size_t>> stack;
+  enter_list[entry_index] = number++;
+  stack.emplace_back(entry_index, 0);
+  while (!stack.empty()) {
+    auto index = stack.back().first;
+    auto child_pos = stack.back().second;
+    if (child_pos < child_list_table[index].size()) {
+      stack.back().second++;
+      auto child = child_list_table[index][child_pos];
+      enter_list[child] = number++;
+      stack.emplace_back(child, 0);
+    } else {
+      leave_list[index] = number++;
+      stack.pop_back();
+    }
+  }
+}
+
+std::optional<BasicBlockID> DominatorTree::get_idom(
+  BasicBlockID block_id
+) const {
+  auto idom = idom_list[index_of(block_id)];
+  if (idom == NONE) {
+    return std::nullopt;
+  }
+  return block_id_list[idom];
+}
+
+std::vector<BasicBlockID> DominatorTree::get_children(
+  BasicBlockID block_id
+) const {
+  std::vector<BasicBlockID> child_id_list;
+  for (auto child : child_list_table[index_of(block_id)]) {
+    child_id_list.push_back(block_id_list[child]);
+  }
+  return child_id_list;
+}
+
+std::vector<std::vector<size_t>> DominatorTree::dominance_frontier() const {
+  auto count = block_count();
+  std::vector<std::vector<size_t>> frontier_table(count);
+
+  for (size_t index = 0; index < count; index++) {
+    if (idom_list[index] == NONE || pred_list_table[index].size() <= 1) {
+      continue;
+    }
+    for (auto pred : pred_list_table[index]) {
+      if (enter_list[pred] == NONE) {
         continue;
       }
+      auto runner = pred;
+      while (runner != idom_list[index]) {
+        frontier_table[runner].push_back(index);
+        runner = idom_list[runner];
+      }
+    }
+  }
 
-      auto bb = context.get_basic_block(bb_id);
-
-      // Get first processed as new_idom (not nullopt)
-      std::optional<BasicBlockID> new_idom = std::nullopt;
-      for (auto pred_id : bb->pred_list) {
-        if (cfa_ctx.idom_map[pred_id].has_value()) {
-          new_idom = pred_id;
-          break;
-        }
+  for (auto& frontier : frontier_table) {
+    std::sort(
+      frontier.begin(), frontier.end(),
+      [&](size_t lhs, size_t rhs) {
+        return block_id_list[lhs] < block_id_list[rhs];
       }
+    );
+    frontier.erase(
+      std::unique(frontier.begin(), frontier.end()), frontier.end()
+    );
+  }
 
-      if (!new_idom.has_value()) {
-        continue;
+  return frontier_table;
+}
+
+size_t DominatorTree::nearest_common_dominator(size_t lhs, size_t rhs) const {
+  while (!dominates_index(lhs, rhs)) {
+    lhs = idom_list[lhs];
+  }
+  return lhs;
+}
+
+void DominatorTree::unlink(size_t from, size_t to) {
+  auto& succ_list = succ_list_table[from];
+  succ_list.erase(
+    std::remove(succ_list.begin(), succ_list.end(), to), succ_list.end()
+  );
+  auto& pred_list = pred_list_table[to];
+  pred_list.erase(
+    std::remove(pred_list.begin(), pred_list.end(), from), pred_list.end()
+  );
+}
+
+bool DominatorTree::link(size_t from, size_t to) {
+  auto& succ_list = succ_list_table[from];
+  if (std::find(succ_list.begin(), succ_list.end(), to) != succ_list.end()) {
+    return false;
+  }
+  succ_list.push_back(to);
+  pred_list_table[to].push_back(from);
+  return true;
+}
+
+void DominatorTree::splice_out(size_t index) {
+  auto parent = idom_list[index];
+  if (parent != NONE) {
+    auto& sibling_list = child_list_table[parent];
+    sibling_list.erase(
+      std::remove(sibling_list.begin(), sibling_list.end(), index),
+      sibling_list.end()
+    );
+    for (auto child : child_list_table[index]) {
+      idom_list[child] = parent;
+      sibling_list.push_back(child);
+    }
+    std::sort(
+      sibling_list.begin(), sibling_list.end(),
+      [&](size_t lhs, size_t rhs) {
+        return block_id_list[lhs] < block_id_list[rhs];
       }
+    );
+  }
+
+  // The intervals of the other blocks still nest the same way.
+  child_list_table[index].clear();
+  idom_list[index] = NONE;
+  enter_list[index] = NONE;
+  leave_list[index] = NONE;
+  removed_list[index] = true;
+  block_index_map.erase(block_id_list[index]);
+}
+
+void DominatorTree::add_block(BasicBlockID block_id) {
+  block_index_map[block_id] = block_id_list.size();
+  block_id_list.push_back(block_id);
+  removed_list.push_back(false);
+  succ_list_table.emplace_back();
+  pred_list_table.emplace_back();
+  idom_list.push_back(NONE);
+  child_list_table.emplace_back();
+  enter_list.push_back(NONE);
+  leave_list.push_back(NONE);
+}
+
+void DominatorTree::remove_block(BasicBlockID block_id) {
+  auto index = index_of(block_id);
+  bool is_reachable = enter_list[index] != NONE;
 
-      for (auto pred_id : bb->pred_list) {
-        if (cfa_ctx.idom_map[pred_id].has_value()) {
-          new_idom = intersect(new_idom.value(), pred_id);
+  auto succ_list = succ_list_table[index];
+  for (auto succ : succ_list) {
+    unlink(index, succ);
+  }
+  auto pred_list = pred_list_table[index];
+  for (auto pred : pred_list) {
+    unlink(pred, index);
+  }
+
+  if (!is_reachable) {
+    splice_out(index);
+    return;
+  }
+
+  removed_list[index] = true;
+  block_index_map.erase(block_id);
+  bump_counter("ir.dominator_tree", "full solves");
+  rebuild();
+}
+
+void DominatorTree::insert_edge(BasicBlockID from_id, BasicBlockID to_id) {
+  auto from = index_of(from_id);
+  auto to = index_of(to_id);
+
+  if (!link(from, to) || enter_list[from] == NONE) {
+    return;
+  }
+
+  std::vector<bool> member_list(block_count(), false);
+  auto root = from;
+
+  if (enter_list[to] != NONE) {
+    if (to == entry_index || dominates_index(idom_list[to], from)) {
+      bump_counter("ir.dominator_tree", "edge updates kept");
+      return;
+    }
+    root = nearest_common_dominator(from, to);
+  } else {
+    // Blocks reached for the first time. The new paths into the blocks that
+    // were reachable all pass `from`, just like new edges from `from`.
+    std::vector<size_t> stack = {to};
+    member_list[to] = true;
+    while (!stack.empty()) {
+      auto index = stack.back();
+      stack.pop_back();
+      for (auto succ : succ_list_table[index]) {
+        if (enter_list[succ] != NONE) {
+          root = nearest_common_dominator(root, succ);
+        } else if (!member_list[succ]) {
+          member_list[succ] = true;
+          stack.push_back(succ);
         }
       }
+    }
+  }
 
-      if (cfa_ctx.idom_map[bb_id] != new_idom) {
-        cfa_ctx.idom_map[bb_id] = new_idom;
-        changed = true;
-      }
+  // Only the subtree of the nearest common dominator may change.
+  std::vector<size_t> stack = {root};
+  while (!stack.empty()) {
+    auto index = stack.back();
+    stack.pop_back();
+    member_list[index] = true;
+    for (auto child : child_list_table[index]) {
+      stack.push_back(child);
     }
   }
 
-  // Reset entry block
-  cfa_ctx.idom_map[entry_bb->id] = std::nullopt;
+  bump_counter("ir.dominator_tree", "subtree solves");
+  solve(root, member_list);
+  refresh();
+}
 
-  // Construct the dom tree
-  for (const auto& [bb_id, idom_id] : cfa_ctx.idom_map) {
-    if (idom_id.has_value()) {
-      cfa_ctx.dom_tree[idom_id.value()].push_back(bb_id);
-    }
+void DominatorTree::delete_edge(BasicBlockID from_id, BasicBlockID to_id) {
+  auto from = index_of(from_id);
+  auto to = index_of(to_id);
+
+  auto& succ_list = succ_list_table[from];
+  if (std::find(succ_list.begin(), succ_list.end(), to) == succ_list.end()) {
+    return;
   }
+  unlink(from, to);
 
-  // Compute dominance frontier
-  for (auto bb_id : bb_id_set) {
-    cfa_ctx.dominance_frontier_map[bb_id] = {};
+  // Unreachable blocks and back edges do not take part in dominance.
+  if (enter_list[from] == NONE || dominates_index(to, from)) {
+    bump_counter("ir.dominator_tree", "edge updates kept");
+    return;
   }
 
-  for (auto bb_id : bb_id_set) {
-    auto bb = context.get_basic_block(bb_id);
-    if (bb->pred_list.size() <= 1) {
-      continue;
+  bump_counter("ir.dominator_tree", "full solves");
+  rebuild();
+}
+
+void DominatorTree::merge_block(BasicBlockID into_id, BasicBlockID from_id) {
+  auto into = index_of(into_id);
+  auto from = index_of(from_id);
+
+  unlink(into, from);
+  auto succ_list = succ_list_table[from];
+  for (auto succ : succ_list) {
+    unlink(from, succ);
+    link(into, succ);
+  }
+
+  // Every path through one of the blocks passes the other one.
+  splice_out(from);
+}
+
+void DominatorTree::bypass_block(BasicBlockID block_id) {
+  auto index = index_of(block_id);
+  auto pred = pred_list_table[index].front();
+  auto succ = succ_list_table[index].front();
+
+  unlink(pred, index);
+  unlink(index, succ);
+  link(pred, succ);
+
+  // Paths through the block map to the paths through the new edge.
+  splice_out(index);
+}
+
+void DominatorTree::sync(FunctionPtr function) {
+  for (auto bb = function->head_basic_block->next;
+       bb != function->tail_basic_block; bb = bb->next) {
+    if (block_index_map.count(bb->id) == 0) {
+      add_block(bb->id);
     }
-    if (!cfa_ctx.idom_map[bb_id].has_value()) {
-      continue;
+  }
+
+  std::vector<bool> present_list(block_count(), false);
+  for (auto bb = function->head_basic_block->next;
+       bb != function->tail_basic_block; bb = bb->next) {
+    present_list[index_of(bb->id)] = true;
+  }
+
+  // Insertions first, so that fewer deletions disconnect blocks.
+  for (auto bb = function->head_basic_block->next;
+       bb != function->tail_basic_block; bb = bb->next) {
+    for (auto succ_id : bb->succ_list) {
+      insert_edge(bb->id, succ_id);
     }
-    for (auto pred_id : bb->pred_list) {
-      auto runner_id = pred_id;
-      while (runner_id != cfa_ctx.idom_map[bb_id].value()) {
-        cfa_ctx.dominance_frontier_map[runner_id].insert(bb_id);
-        runner_id = cfa_ctx.idom_map[runner_id].value();
+  }
+
+  for (auto bb = function->head_basic_block->next;
+       bb != function->tail_basic_block; bb = bb->next) {
+    auto succ_list = succ_list_table[index_of(bb->id)];
+    for (auto succ : succ_list) {
+      auto succ_id = block_id_list[succ];
+      if (std::find(bb->succ_list.begin(), bb->succ_list.end(), succ_id) ==
+          bb->succ_list.end()) {
+        delete_edge(bb->id, succ_id);
       }
     }
   }
+
+  for (size_t index = 0; index < block_count(); index++) {
+    if (!removed_list[index] && !present_list[index]) {
+      remove_block(block_id_list[index]);
+    }
+  }
 }
 
 }  // namespace ir
-}  // namespace syc
\ No newline at end of file
+}  // namespace syc
@@ -10,13 +10,147 @@
 namespace syc {
 namespace ir {
 
+/// Dominator tree of a function over dense block indices.
+///
+/// Blocks are numbered in layout order when the tree is built, and blocks
+/// added later get the next indices. A removed block keeps its index as a dead
+/// slot, so the indices held by the passes stay valid. The tree keeps its own
+/// copy of the edges, which the updates below keep in sync with the function.
+///
+/// Each reachable block gets an interval from a DFS of the tree, and a block
+/// dominates another iff its interval contains the other one, so dominance
+/// queries take constant time. The children of a block are ordered by
+/// increasing block ID.
+///
+/// The tree can be updated by the passes that change the CFG instead of being
+/// recomputed from scratch:
+///
+/// - Inserting an edge `x -> y` only changes the blocks dominated by the
+///   nearest common dominator of `x` and `y`, so only that subtree is solved
+///   again. Nothing changes if the immediate dominator of `y` dominates `x`.
+/// - Deleting an edge from an unreachable block or a back edge changes
+///   nothing, other deletions solve the whole tree again.
+/// - Merging a block into its only predecessor and bypassing a block with
+///   one predecessor and one successor just move the children of the block to
+///   its parent.
+struct DominatorTree {
+  static constexpr size_t NONE = std::numeric_limits<size_t>::max();
+
+  /// ID of the block of each index.
+  std::vector<BasicBlockID> block_id_list;
+  /// Index of each block.
+  std::unordered_map<BasicBlockID, size_t> block_index_map;
+  /// If the slot of each index is removed.
+  std::vector<bool> removed_list;
+  /// Index of the entry block.
+  size_t entry_index = 0;
+
+  /// Successors of each block.
+  std::vector<std::vector<size_t>> succ_list_table;
+  /// Predecessors of each block.
+  std::vector<std::vector<size_t>> pred_list_table;
+
+  /// Immediate dominator of each block, `NONE` for the entry and the
+  /// unreachable blocks.
+  std::vector<size_t> idom_list;
+  /// Children of each block in the tree, by increasing block ID.
+  std::vector<std::vector<size_t>> child_list_table;
+  /// Start of the DFS interval of each block, `NONE` if unreachable.
+  std::vector<size_t> enter_list;
+  /// End of the DFS interval of each block.
+  std::vector<size_t> leave_list;
+
+  /// Build the tree of the function from scratch.
+  void build(FunctionPtr function, Context& context);
+
+  size_t block_count() const { return block_id_list.size(); }
+
+  /// Get the index of a block.
+  size_t index_of(BasicBlockID block_id) const {
+    return block_index_map.at(block_id);
+  }
+
+  /// If the block is reachable from the entry.
+  bool is_reachable(BasicBlockID block_id) const {
+    return enter_list[index_of(block_id)] != NONE;
+  }
+
+  /// Get the immediate dominator, none for the entry and unreachable blocks.
+  std::optional<BasicBlockID> get_idom(BasicBlockID block_id) const;
+
+  /// Get the children of a block in the tree, by increasing block ID.
+  std::vector<BasicBlockID> get_children(BasicBlockID block_id) const;
+
+  /// If `lhs` dominates `rhs`. A block dominates itself, and unreachable
+  /// blocks neither dominate nor are dominated.
+  bool dominates(BasicBlockID lhs, BasicBlockID rhs) const {
+    return dominates_index(index_of(lhs), index_of(rhs));
+  }
+
+  bool dominates_index(size_t lhs, size_t rhs) const {
+    return enter_list[lhs] != NONE && enter_list[rhs] != NONE &&
+           enter_list[lhs] <= enter_list[rhs] &&
+           leave_list[rhs] <= leave_list[lhs];
+  }
+
+  /// Dominance frontier of each block, by increasing block ID.
+  std::vector<std::vector<size_t>> dominance_frontier() const;
+
+  /// Add a new block without edges.
+  void add_block(BasicBlockID block_id);
+
+  /// Remove an unreachable block and its edges.
+  void remove_block(BasicBlockID block_id);
+
+  /// Insert an edge, nothing is done if the edge exists.
+  void insert_edge(BasicBlockID from_id, BasicBlockID to_id);
+
+  /// Delete an edge, nothing is done if there is no such edge.
+  void delete_edge(BasicBlockID from_id, BasicBlockID to_id);
+
+  /// Merge `from` into `into`, where `from` is the only successor of `into`
+  /// and `into` is the only predecessor of `from`. The successors of `from`
+  /// become the successors of `into` and `from` is removed.
+  void merge_block(BasicBlockID into_id, BasicBlockID from_id);
+
+  /// Remove a block with one predecessor and one successor, and connect the
+  /// predecessor to the successor instead.
+  void bypass_block(BasicBlockID block_id);
+
+  /// Bring the tree in sync with the function after arbitrary CFG changes.
+  /// New blocks are added, then the edges that differ are inserted and
+  /// deleted one by one, and the blocks no longer in the function are
+  /// removed.
+  void sync(FunctionPtr function);
+
+  /// Nearest common dominator of two reachable blocks.
+  size_t nearest_common_dominator(size_t lhs, size_t rhs) const;
+
+  /// Solve the immediate dominators of the blocks in `member_list` reachable
+  /// from `root`, using only the edges between the members. The immediate
+  /// dominator of `root` is left as is.
+  void solve(size_t root, const std::vector<bool>& member_list);
+
+  /// Solve the whole tree again from its own edges.
+  void rebuild();
+
+  /// Rebuild the children and the intervals from the immediate dominators.
+  void refresh();
+
+  /// Remove `to` from the successors of `from` and vice versa.
+  void unlink(size_t from, size_t to);
+
+  /// Add `to` to the successors of `from` and vice versa, return if the edge
+  /// is new.
+  bool link(size_t from, size_t to);
+
+  /// Replace the tree node of a removed block by its children.
+  void splice_out(size_t index);
+};
+
 struct ControlFlowAnalysisContext {
-  /// Immediate dominator of basic blocks
-  std::map<BasicBlockID, std::optional<BasicBlockID>> idom_map;
-  /// Dominance frontier of basic blocks
-  std::map<BasicBlockID, std::set<BasicBlockID>> dominance_frontier_map;
   /// Dominator tree
-  std::map<BasicBlockID, std::vector<BasicBlockID>> dom_tree;
+  DominatorTree dom_tree;
 
   ControlFlowAnalysisContext() = default;
 };
@@ -30,4 +164,4 @@ void control_flow_analysis(
 }  // namespace ir
 }  // namespace syc
 
-#endif
\ No newline at end of file
+#endif
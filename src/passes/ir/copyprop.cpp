@@ -8,6 +8,7 @@ void copyprop(Builder& builder) {
     if (function->is_declare) {
       continue;
     }
+    builder.switch_function(function_name);
     copyprop_function(function, builder);
   }
 }
@@ -126,11 +127,7 @@ void copyprop_function(FunctionPtr function, Builder& builder) {
 
           if (new_dst_id != dst->id) {
             // Replace all uses of dst with new_dst_id
-            auto use_id_list_copy = dst->use_id_list;
-            for (auto use_id : use_id_list_copy) {
-              auto use_instr = builder.context.get_instruction(use_id);
-              use_instr->replace_operand(dst->id, new_dst_id, builder.context);
-            }
+            dst->replace_all_uses_with(new_dst_id, builder.context);
 
             // Remove the instruction
             curr_instr->remove(builder.context);
@@ -187,11 +184,7 @@ void copyprop_function(FunctionPtr function, Builder& builder) {
 
           if (new_dst_id != dst->id) {
             // Replace all uses of dst with new_dst_id
-            auto use_id_list_copy = dst->use_id_list;
-            for (auto use_id : use_id_list_copy) {
-              auto use_instr = builder.context.get_instruction(use_id);
-              use_instr->replace_operand(dst->id, new_dst_id, builder.context);
-            }
+            dst->replace_all_uses_with(new_dst_id, builder.context);
 
             // Remove the instruction
             curr_instr->remove(builder.context);
@@ -222,11 +215,7 @@ void copyprop_function(FunctionPtr function, Builder& builder) {
 
           if (new_dst_id != dst->id) {
             // Replace all uses of dst with new_dst_id
-            auto use_id_list_copy = dst->use_id_list;
-            for (auto use_id : use_id_list_copy) {
-              auto use_instr = builder.context.get_instruction(use_id);
-              use_instr->replace_operand(dst->id, new_dst_id, builder.context);
-            }
+            dst->replace_all_uses_with(new_dst_id, builder.context);
 
             // Remove the instruction
             curr_instr->remove(builder.context);
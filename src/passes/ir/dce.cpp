@@ -4,27 +4,31 @@
 #include "ir/function.h"
 #include "ir/instruction.h"
 #include "ir/operand.h"
+#include "statistics.h"
 
 namespace syc {
 namespace ir {
 
 void dce(Builder& builder) {
   for (auto [function_name, function] : builder.context.function_table) {
-    bool changed = true;
-    while (changed) {
-      changed = dce_function(function, builder);
-    }
+    builder.switch_function(function_name);
+    dce_function(function, builder);
   }
 }
 
 bool dce_function(FunctionPtr function, Builder& builder) {
-  bool changed = false;
-  auto curr_basic_block = function->head_basic_block->next;
-  while (curr_basic_block != function->tail_basic_block) {
-    changed = dce_basic_block(curr_basic_block, builder) || changed;
-    curr_basic_block = curr_basic_block->next;
+  bool changed = true;
+  bool any_changed = false;
+  while (changed) {
+    changed = false;
+    auto curr_basic_block = function->head_basic_block->next;
+    while (curr_basic_block != function->tail_basic_block) {
+      changed = dce_basic_block(curr_basic_block, builder) || changed;
+      curr_basic_block = curr_basic_block->next;
+    }
+    any_changed = any_changed || changed;
   }
-  return changed;
+  return any_changed;
 }
 
 bool dce_basic_block(BasicBlockPtr basic_block, Builder& builder) {
@@ -40,6 +44,7 @@ bool dce_basic_block(BasicBlockPtr basic_block, Builder& builder) {
       if (dst_operand->use_id_list.size() == 0 
           && !curr_instruction->is_call()) {
         curr_instruction->remove(builder.context);
+        bump_counter("ir.dce", "instructions removed");
         changed = true;
       } else if (dst_operand->use_id_list.size() == 1 && curr_instruction->is_phi()) {
         auto use_id = dst_operand->use_id_list.front();
@@ -51,6 +56,7 @@ bool dce_basic_block(BasicBlockPtr basic_block, Builder& builder) {
             if (curr_instruction->id == phi_dst->use_id_list.front()) {
               use_instruction->remove(builder.context);
               curr_instruction->remove(builder.context);
+              bump_counter("ir.dce", "instructions removed", 2);
               changed = true;
             }
           }
@@ -10,6 +10,8 @@ namespace ir {
 
 void dce(Builder& builder);
 
+/// Remove dead instructions of the function until nothing changes, return if
+/// anything is removed.
 bool dce_function(FunctionPtr function, Builder& builder);
 
 bool dce_basic_block(BasicBlockPtr basic_block, Builder& builder);
@@ -42,7 +42,7 @@ void func_ret_opt(Builder& builder) {
 
     // Make return type void
     function->return_type = builder.fetch_void_type();
-    auto exit_bb = function->tail_basic_block->prev.lock();
+    auto exit_bb = function->tail_basic_block->prev;
 
     // Modify related instructions
     for (auto instr_id : function->caller_id_list) {
@@ -53,12 +53,13 @@ void func_ret_opt(Builder& builder) {
     }
 
     // Modify return instruction
+    builder.switch_function(function_name);
     builder.set_curr_basic_block(exit_bb);
     auto ret_instr = builder.fetch_ret_instruction();
 
     function->maybe_return_operand_id = std::nullopt;
 
-    auto old_ret_instr = exit_bb->tail_instruction->prev.lock();
+    auto old_ret_instr = exit_bb->tail_instruction->prev;
 
     old_ret_instr->insert_next(ret_instr);
     old_ret_instr->remove(builder.context);
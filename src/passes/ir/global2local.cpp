@@ -21,7 +21,7 @@ void global2local(Builder& builder) {
     for (auto use_id : operand->use_id_list) {
       auto instr = builder.context.get_instruction(use_id);
       auto bb = builder.context.get_basic_block(instr->parent_block_id);
-      used_function_set.insert(bb->parent_function_name);
+      used_function_set.insert(bb->parent_function->name);
     }
 
     if (used_function_set.size() > 1) {
@@ -51,7 +51,7 @@ void global2local(Builder& builder) {
     auto ptr_id = builder.fetch_arbitrary_operand(operand->get_type());
 
     auto alloca_instr = builder.fetch_alloca_instruction(
-      ptr_id, operand->type, std::nullopt, std::nullopt, std::nullopt, false
+      ptr_id, operand->type, std::nullopt, false
     );
 
     builder.prepend_instruction_to_curr_function(alloca_instr);
@@ -74,11 +74,7 @@ void global2local(Builder& builder) {
     curr_instr->insert_prev(store_instr);
 
     // Replace all uses of the global variable with the local variable
-    auto use_id_list_copy = operand->use_id_list;
-    for (auto use_id : use_id_list_copy) {
-      auto instr = builder.context.get_instruction(use_id);
-      instr->replace_operand(operand->id, ptr_id, builder.context);
-    }
+    operand->replace_all_uses_with(ptr_id, builder.context);
 
     builder.context.global_list.erase(
       std::remove(
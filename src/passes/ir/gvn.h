@@ -8,15 +8,57 @@
 #include "ir/instruction.h"
 #include "ir/operand.h"
 #include "passes/ir/control_flow_analysis.h"
+#include "passes/ir/pass_manager.h"
 
 namespace syc {
 namespace ir {
 
-void gvn(Builder& builder, bool is_aggressive);
+using ValueNumMap = std::map<OperandID, OperandID>;
+using BinaryExprMap = std::map<
+  std::tuple<instruction::BinaryOp, OperandID, OperandID>,
+  OperandID>;
+using InvGetElementPtrExprMap = std::map<OperandID,
+  std::tuple<TypePtr, OperandID, std::vector<OperandID>>>;
+using GetElementPtrExprMap = std::map<std::tuple<TypePtr, OperandID, std::vector<OperandID>>,
+  OperandID>;
+using PhiExprMap = std::map<
+  std::vector<std::tuple<OperandID, BasicBlockID>>,
+  OperandID>;
+using LoadExprMap = std::map<
+  std::tuple<TypePtr, OperandID, std::vector<OperandID>>,
+  OperandID>;
+using StoreExprMap = std::map<
+  std::tuple<TypePtr, OperandID, std::vector<OperandID>>,
+  OperandID>;
+using ICmpExprMap = std::map<
+  std::tuple<syc::ir::instruction::ICmpCond, OperandID, OperandID>,
+  OperandID>;
+using FCmpExprMap = std::map<
+  std::tuple<syc::ir::instruction::FCmpCond, OperandID, OperandID>,
+  OperandID>;
+using CastExprMap = std::map<
+  std::tuple<syc::ir::instruction::CastOp, OperandID>,
+  OperandID>;
 
-void gvn_function(FunctionPtr function, Builder& builder, bool is_aggressive);
+/// Value numbers and available expressions along the dominator tree walk.
+struct GvnContext {
+  ValueNumMap value_number_map;
+  PhiExprMap phi_expr_map;
+  BinaryExprMap binary_expr_map;
+  InvGetElementPtrExprMap inv_getelementptr_expr_map;
+  LoadExprMap load_expr_map;
+  StoreExprMap store_expr_map;
+  GetElementPtrExprMap getelementptr_expr_map;
+  ICmpExprMap icmp_expr_map;
+  FCmpExprMap fcmp_expr_map;
+  CastExprMap cast_expr_map;
+};
 
-void gvn_basic_block(FunctionPtr function, BasicBlockPtr basic_block, Builder& builder, ControlFlowAnalysisContext cfa_ctx, bool is_aggressive, size_t depth = 0);
+void gvn(Builder& builder, AnalysisManager& analysis_manager, bool is_aggressive);
+
+void gvn_function(FunctionPtr function, Builder& builder, AnalysisManager& analysis_manager, bool is_aggressive);
+
+void gvn_basic_block(FunctionPtr function, BasicBlockPtr basic_block, Builder& builder, ControlFlowAnalysisContext& cfa_ctx, GvnContext& gvn_ctx, bool is_aggressive, size_t depth = 0);
 
 }  // namespace ir
 }  // namespace syc
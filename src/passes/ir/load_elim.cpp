@@ -1,10 +1,12 @@
 #include "passes/ir/load_elim.h"
+#include "statistics.h"
 
 namespace syc {
 namespace ir {
 
 void load_elim(Builder& builder) {
   for (auto& [function_name, function] : builder.context.function_table) {
+    builder.switch_function(function_name);
     load_elim_function(function, builder);
   }
 }
@@ -36,14 +38,9 @@ void load_elim_basic_block(BasicBlockPtr basic_block, Builder& builder) {
 
       if (loaded_id_map.count(ptr->id)) {
         auto loaded_dst = builder.context.get_operand(loaded_id_map[ptr->id]);
-        auto use_id_list_copy = dst->use_id_list;
-        for (auto use_id : use_id_list_copy) {
-          auto use_instruction = builder.context.get_instruction(use_id);
-          use_instruction->replace_operand(
-            dst->id, loaded_dst->id, builder.context
-          );
-        }
+        dst->replace_all_uses_with(loaded_dst->id, builder.context);
         curr_instruction->remove(builder.context);
+        bump_counter("ir.load_elim", "loads eliminated");
       } else {
         loaded_id_map[ptr->id] = dst->id;
       }
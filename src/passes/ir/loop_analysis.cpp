@@ -2,6 +2,7 @@
 #include "ir/basic_block.h"
 #include "ir/instruction.h"
 #include "ir/operand.h"
+#include "passes/ir/pass_manager.h"
 
 namespace syc {
 namespace ir {
@@ -9,58 +10,22 @@ namespace ir {
 void detect_natural_loop(
   FunctionPtr function,
   Builder& builder,
+  ControlFlowAnalysisContext& cfa_ctx,
   LoopOptContext& loop_opt_ctx
 ) {
-  auto cfa_ctx = ControlFlowAnalysisContext();
-  control_flow_analysis(function, builder.context, cfa_ctx);
+  const auto& dom_tree = cfa_ctx.dom_tree;
 
-  auto func_entry_bb = function->head_basic_block->next;
-
-  // Get doms from idom and dom_tree
-  auto dom_map = std::map<BasicBlockID, std::set<BasicBlockID>>();
-  // Layer traversal
-  auto queue = std::queue<BasicBlockID>();
-  queue.push(func_entry_bb->id);
-  while (!queue.empty()) {
-    auto bb_id = queue.front();
-    queue.pop();
-
-    auto dom_set = std::set<BasicBlockID>();
-
-    if (cfa_ctx.idom_map[bb_id].has_value()) {
-      dom_set.insert(cfa_ctx.idom_map[bb_id].value());
-    }
-
-    if (cfa_ctx.dom_tree.count(bb_id) != 0) {
-      for (auto child_id : cfa_ctx.dom_tree[bb_id]) {
-        queue.push(child_id);
-      }
-    }
-
-    // Union idom's doms
-    if (cfa_ctx.idom_map[bb_id].has_value()) {
-      for (auto idom_dom_id : dom_map[cfa_ctx.idom_map[bb_id].value()]) {
-        dom_set.insert(idom_dom_id);
-      }
-    }
-
-    dom_map[bb_id] = std::move(dom_set);
-  }
-
-  // Find back edges
+  // Find back edges, i.e. edges to a strict dominator
   auto back_edge_set = std::set<std::pair<BasicBlockID, BasicBlockID>>();
 
-  for (const auto& [bb_id, dom_set] : dom_map) {
-    for (auto dom_id : dom_set) {
-      auto bb = builder.context.get_basic_block(bb_id);
-      auto dom_bb = builder.context.get_basic_block(dom_id);
-
-      bool is_dom_succ =
-        std::find(bb->succ_list.begin(), bb->succ_list.end(), dom_id) !=
-        bb->succ_list.end();
-
-      if (is_dom_succ) {
-        back_edge_set.insert(std::make_pair(bb_id, dom_id));
+  for (auto bb = function->head_basic_block->next;
+       bb != function->tail_basic_block; bb = bb->next) {
+    if (!dom_tree.is_reachable(bb->id)) {
+      continue;
+    }
+    for (auto succ_id : bb->succ_list) {
+      if (succ_id != bb->id && dom_tree.dominates(succ_id, bb->id)) {
+        back_edge_set.insert(std::make_pair(bb->id, succ_id));
       }
     }
   }
@@ -123,15 +88,16 @@ void detect_natural_loop(
       }
     }
   }
-
-  loop_opt_ctx.dom_map = std::move(dom_map);
 }
 
-void lcssa_transform(FunctionPtr function, Builder& builder) {
+void lcssa_transform(
+  FunctionPtr function,
+  Builder& builder,
+  AnalysisManager& analysis_manager
+) {
   using namespace instruction;
 
-  auto loop_opt_ctx = LoopOptContext();
-  detect_natural_loop(function, builder, loop_opt_ctx);
+  auto& loop_opt_ctx = analysis_manager.get_loop_analysis(function, builder);
 
   // Sort loop by body size
   std::vector<LoopInfo> loop_info_list;
@@ -190,7 +156,7 @@ void lcssa_transform(FunctionPtr function, Builder& builder) {
       );
       builder.append_instruction(phi_instr);
 
-      auto use_id_list_copy = operand->use_id_list;
+      auto use_id_list_copy = operand->use_id_list.to_vector();
       for (auto use_id : use_id_list_copy) {
         auto use_instr = builder.context.get_instruction(use_id);
         if (!loop_info.body_id_set.count(use_instr->parent_block_id) && 
@@ -203,7 +169,7 @@ void lcssa_transform(FunctionPtr function, Builder& builder) {
     auto br_instr = builder.fetch_br_instruction(exit_bb->id);
     builder.append_instruction(br_instr);
 
-    auto exiting_instr = exiting_bb->tail_instruction->prev.lock();
+    auto exiting_instr = exiting_bb->tail_instruction->prev;
 
     auto maybe_condbr = exiting_instr->as<CondBr>();
     auto maybe_br = exiting_instr->as<Br>();
@@ -237,6 +203,10 @@ void lcssa_transform(FunctionPtr function, Builder& builder) {
     );
     new_exit_bb_set.insert(new_exit_bb->id);
   }
+
+  if (!new_exit_bb_set.empty()) {
+    analysis_manager.invalidate(function);
+  }
 }
 
 }  // namespace ir
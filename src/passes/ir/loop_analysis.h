@@ -18,22 +18,26 @@ struct LoopInfo {
   }
 };
 
+struct AnalysisManager;
+
 struct LoopOptContext {
   std::map<BasicBlockID, LoopInfo> loop_info_map;
-  std::map<BasicBlockID, std::set<BasicBlockID>> dom_map;
 
   LoopOptContext() = default;
 };
 
+/// Detect natural loops with the given control flow analysis.
 void detect_natural_loop(
   FunctionPtr function,
   Builder& builder,
+  ControlFlowAnalysisContext& cfa_ctx,
   LoopOptContext& loop_opt_ctx
 );
 
 void lcssa_transform(
   FunctionPtr function,
-  Builder& builder
+  Builder& builder,
+  AnalysisManager& analysis_manager
 );
 
 }  // namespace ir
@@ -5,23 +5,29 @@
 #include "ir/instruction.h"
 #include "ir/operand.h"
 #include "passes/adt.h"
+#include "passes/ir/pass_manager.h"
 
 namespace syc {
 namespace ir {
 
-void loop_indvar_simplify(Builder& builder) {
+void loop_indvar_simplify(Builder& builder, AnalysisManager& analysis_manager) {
   for (auto [function_name, function] : builder.context.function_table) {
     if (function->is_declare) {
       continue;
     }
-    lcssa_transform(function, builder);
-    loop_indvar_simplify_function(function, builder);
+    builder.switch_function(function_name);
+    loop_indvar_simplify_function(function, builder, analysis_manager);
   }
 }
 
-void loop_indvar_simplify_function(FunctionPtr function, Builder& builder) {
-  auto loop_opt_ctx = LoopOptContext();
-  detect_natural_loop(function, builder, loop_opt_ctx);
+void loop_indvar_simplify_function(
+  FunctionPtr function,
+  Builder& builder,
+  AnalysisManager& analysis_manager
+) {
+  lcssa_transform(function, builder, analysis_manager);
+
+  auto& loop_opt_ctx = analysis_manager.get_loop_analysis(function, builder);
 
   std::set<BasicBlockID> to_be_removed_bb_id_list = {};
 
@@ -29,6 +35,11 @@ void loop_indvar_simplify_function(FunctionPtr function, Builder& builder) {
     loop_indvar_simplify_helper(loop_info, builder, to_be_removed_bb_id_list);
   }
 
+  // Simplified loops may be bypassed or lose their branches.
+  if (!loop_opt_ctx.loop_info_map.empty()) {
+    analysis_manager.invalidate(function);
+  }
+
   for (auto bb_id : to_be_removed_bb_id_list) {
     auto bb = builder.context.get_basic_block(bb_id);
     bb->remove(builder.context);
@@ -283,10 +294,10 @@ void loop_indvar_simplify_helper(
           auto preheader =
             builder.context.get_basic_block(maybe_preheader_id.value());
           builder.set_curr_basic_block(preheader);
-          auto insert_pos = preheader->tail_instruction->prev.lock();
+          auto insert_pos = preheader->tail_instruction->prev;
           while (insert_pos->is_terminator() &&
                  insert_pos != preheader->head_instruction) {
-            insert_pos = insert_pos->prev.lock();
+            insert_pos = insert_pos->prev;
           }
           auto new_ptr_id =
             builder.fetch_arbitrary_operand(builder.fetch_pointer_type());
@@ -326,7 +337,7 @@ void loop_indvar_simplify_helper(
         instr->insert_next(new_gep_instr);
 
         // Replace use of dst
-        auto use_id_list_copy = dst->use_id_list;
+        auto use_id_list_copy = dst->use_id_list.to_vector();
         for (auto use_id : use_id_list_copy) {
           auto use_instr = builder.context.get_instruction(use_id);
           if (using_updated_iv) {
@@ -437,7 +448,7 @@ void loop_indvar_simplify_helper(
           insert_pos = insert_pos->next;
         }
 
-        insert_pos = insert_pos->prev.lock();
+        insert_pos = insert_pos->prev;
 
         builder.set_curr_basic_block(exit_bb);
 
@@ -467,13 +478,7 @@ void loop_indvar_simplify_helper(
           new_dst_id = srem_dst_id;
         }
 
-        auto use_id_list_copy = lcssa_phi_dst->use_id_list;
-        for (auto use_id : use_id_list_copy) {
-          auto use_instr = builder.context.get_instruction(use_id);
-          use_instr->replace_operand(
-            lcssa_phi_dst->id, new_dst_id, builder.context
-          );
-        }
+        lcssa_phi_dst->replace_all_uses_with(new_dst_id, builder.context);
 
         bool can_remove_instr = true;
 
@@ -524,7 +529,7 @@ void loop_indvar_simplify_helper(
       if (instr->is_phi()) {
         auto phi = instr->as<Phi>().value();
         auto dst = builder.context.get_operand(phi.dst_id);
-        auto use_id_list_copy = dst->use_id_list;
+        auto use_id_list_copy = dst->use_id_list.to_vector();
         for (auto use_id : use_id_list_copy) {
           auto use_instr = builder.context.get_instruction(use_id);
           if (use_instr->is_icmp()) {
@@ -538,7 +543,7 @@ void loop_indvar_simplify_helper(
                   builder.context.get_instruction(rhs->maybe_def_id.value());
                 if (!loop_info.body_id_set.count(rhs_def_instr->parent_block_id
                     )) {
-                  auto use_id_list_copy = dst->use_id_list;
+                  auto use_id_list_copy = dst->use_id_list.to_vector();
                   for (auto use_id : use_id_list_copy) {
                     auto use_instr = builder.context.get_instruction(use_id);
                     if (use_instr->parent_block_id == exit_bb->id) {
@@ -600,7 +605,7 @@ void loop_indvar_simplify_helper(
       if (maybe_preheader_id.has_value() && header_bb->pred_list.size() == 2) {
         auto preheader_bb =
           builder.context.get_basic_block(maybe_preheader_id.value());
-        auto branch_instr = preheader_bb->tail_instruction->prev.lock();
+        auto branch_instr = preheader_bb->tail_instruction->prev;
         std::cout << branch_instr->to_string(builder.context) << std::endl;
         if (branch_instr->is_br()) {
           auto& br = branch_instr->as_ref<Br>().value().get();
@@ -19,9 +19,13 @@ struct IvRecord {
   std::vector<InstructionID> iv_instr_id_list = {};
 };
 
-void loop_indvar_simplify(Builder& builder);
+void loop_indvar_simplify(Builder& builder, AnalysisManager& analysis_manager);
 
-void loop_indvar_simplify_function(FunctionPtr function, Builder& builder);
+void loop_indvar_simplify_function(
+  FunctionPtr function,
+  Builder& builder,
+  AnalysisManager& analysis_manager
+);
 
 void loop_indvar_simplify_helper(
   LoopInfo& loop_info,
@@ -2,26 +2,39 @@
 #include "ir/basic_block.h"
 #include "ir/instruction.h"
 #include "ir/operand.h"
+#include "passes/ir/pass_manager.h"
+#include "statistics.h"
 
 namespace syc {
 namespace ir {
 
-void loop_invariant_motion(Builder& builder) {
+void loop_invariant_motion(
+  Builder& builder,
+  AnalysisManager& analysis_manager
+) {
   for (auto [function_name, function] : builder.context.function_table) {
     if (function->is_declare) {
       continue;
     }
     builder.switch_function(function_name);
-    auto loop_opt_ctx = LoopOptContext();
-    detect_natural_loop(function, builder, loop_opt_ctx);
-    loop_invariant_motion_function(builder, loop_opt_ctx);
+    loop_invariant_motion_function(function, builder, analysis_manager);
   }
 }
 
 void loop_invariant_motion_function(
+  FunctionPtr function,
   Builder& builder,
-  LoopOptContext& loop_opt_ctx
+  AnalysisManager& analysis_manager
 ) {
+  auto& loop_opt_ctx = analysis_manager.get_loop_analysis(function, builder);
+  hoist_loop_invariants(builder, loop_opt_ctx);
+  // Preheaders are inserted for all the loops.
+  if (!loop_opt_ctx.loop_info_map.empty()) {
+    analysis_manager.invalidate(function);
+  }
+}
+
+void hoist_loop_invariants(Builder& builder, LoopOptContext& loop_opt_ctx) {
   std::map<BasicBlockID, BasicBlockID> preheader_map;
 
   // Code motion
@@ -66,8 +79,8 @@ void loop_invariant_motion_function(
         if (maybe_motion) {
           bool is_invariant = true;
 
-          for (auto operand_id : curr_instr->use_id_list) {
-            auto operand = builder.context.get_operand(operand_id);
+          for (auto use : curr_instr->use_list) {
+            auto operand = builder.context.get_operand(use->operand_id);
 
             if (operand->maybe_def_id.has_value()) {
               auto def_instr =
@@ -84,6 +97,7 @@ void loop_invariant_motion_function(
           if (is_invariant) {
             curr_instr->raw_remove();
             builder.append_instruction(curr_instr);
+            bump_counter("ir.loop_invariant_motion", "instructions hoisted");
           }
         }
 
@@ -190,7 +204,7 @@ void loop_invariant_motion_function(
       }
 
       // Modify branches
-      auto terminator = pred_bb->tail_instruction->prev.lock();
+      auto terminator = pred_bb->tail_instruction->prev;
 
       auto maybe_br = terminator->as_ref<instruction::Br>();
       auto maybe_condbr = terminator->as_ref<instruction::CondBr>();
@@ -8,9 +8,19 @@
 namespace syc {
 namespace ir {
 
-void loop_invariant_motion(Builder& builder);
+void loop_invariant_motion(
+  Builder& builder,
+  AnalysisManager& analysis_manager
+);
 
-void loop_invariant_motion_function(Builder& builder, LoopOptContext& loop_opt_ctx);
+void loop_invariant_motion_function(
+  FunctionPtr function,
+  Builder& builder,
+  AnalysisManager& analysis_manager
+);
+
+/// Insert preheaders and hoist the invariants of all the loops.
+void hoist_loop_invariants(Builder& builder, LoopOptContext& loop_opt_ctx);
 
 }  // namespace ir
 }  // namespace syc
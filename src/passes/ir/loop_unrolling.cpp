@@ -4,29 +4,49 @@
 #include "ir/function.h"
 #include "ir/instruction.h"
 #include "ir/operand.h"
+#include "passes/ir/pass_manager.h"
+#include "statistics.h"
 
 namespace syc {
 namespace ir {
 
-void loop_unrolling(Builder& builder) {
+void loop_unrolling(
+  Builder& builder,
+  AnalysisManager& analysis_manager,
+  const LoopUnrollingBudget& budget
+) {
   for (auto [function_name, function] : builder.context.function_table) {
     if (function->is_declare) {
       continue;
     }
-    lcssa_transform(function, builder);
-    loop_unrolling_function(function, builder);
+    builder.switch_function(function_name);
+    loop_unrolling_function(function, builder, analysis_manager, budget);
   }
 }
 
-void loop_unrolling_function(FunctionPtr function, Builder& builder) {
-  builder.switch_function(function->name);
+void loop_unrolling_function(
+  FunctionPtr function,
+  Builder& builder,
+  AnalysisManager& analysis_manager,
+  const LoopUnrollingBudget& budget
+) {
+  lcssa_transform(function, builder, analysis_manager);
 
+  auto start = std::chrono::steady_clock::now();
+  size_t growth = 0;
   bool unroll = true;
 
   while (unroll) {
     unroll = false;
-    auto loop_opt_ctx = LoopOptContext();
-    detect_natural_loop(function, builder, loop_opt_ctx);
+
+    std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+    if (budget.max_seconds.has_value() &&
+        elapsed.count() > budget.max_seconds.value()) {
+      bump_counter("ir.loop_unrolling", "functions over time budget");
+      break;
+    }
+    auto& loop_opt_ctx = analysis_manager.get_loop_analysis(function, builder);
 
     if (loop_opt_ctx.loop_info_map.size() > 50) {
       break;
@@ -46,8 +66,18 @@ void loop_unrolling_function(FunctionPtr function, Builder& builder) {
     );
 
     for (auto loop_info : loop_info_list) {
-      unroll |= loop_unrolling_helper(loop_info, builder, loop_opt_ctx);
+      unroll |= loop_unrolling_helper(
+        loop_info, builder, loop_opt_ctx, budget, growth
+      );
       if (unroll) {
+        bump_counter("ir.loop_unrolling", "loops unrolled");
+        // The loops are changed, detect them again. The dominator tree is
+        // brought up to date with the new blocks and edges instead.
+        auto cfa_ctx = analysis_manager.find_control_flow_analysis(function);
+        if (cfa_ctx != nullptr) {
+          cfa_ctx->dom_tree.sync(function);
+        }
+        analysis_manager.invalidate_loops(function);
         break;
       }
     }
@@ -57,7 +87,9 @@ void loop_unrolling_function(FunctionPtr function, Builder& builder) {
 bool loop_unrolling_helper(
   LoopInfo& loop_info,
   Builder& builder,
-  LoopOptContext& loop_opt_ctx
+  LoopOptContext& loop_opt_ctx,
+  const LoopUnrollingBudget& budget,
+  size_t& growth
 ) {
   using namespace instruction;
 
@@ -222,7 +254,8 @@ bool loop_unrolling_helper(
   bool use_coefficient = false;
   std::optional<size_t> maybe_coefficient = std::nullopt;
 
-  if ((iv_ed - iv_st) / iv_stride > 300 || iv_ed - iv_st <= 0) {
+  if ((iv_ed - iv_st) / iv_stride > (int)budget.max_trip_count ||
+      iv_ed - iv_st <= 0) {
     // Round up
     // size_t trip_count = (iv_ed - iv_st) / iv_stride + 1;
 
@@ -243,6 +276,24 @@ bool loop_unrolling_helper(
     // }
   }
 
+  // Every iteration gets a copy of the body.
+  size_t body_size = 0;
+  for (auto block_id : loop_info.body_id_set) {
+    auto block = builder.context.get_basic_block(block_id);
+    for (auto instr = block->head_instruction->next;
+         instr != block->tail_instruction; instr = instr->next) {
+      body_size++;
+    }
+  }
+  size_t trip_count = std::max((iv_ed - iv_st) / iv_stride + 1, 1);
+  size_t added_size = trip_count * body_size;
+  if (budget.max_growth.has_value() &&
+      growth + added_size > budget.max_growth.value()) {
+    bump_counter("ir.loop_unrolling", "loops over budget");
+    return false;
+  }
+  growth += added_size;
+
   if (do_loop_unrolling && !use_coefficient) {
     // remove phi, icmp, br instructions
     auto loop_iv_operand = builder.context.get_operand(loop_iv_id);
@@ -254,7 +305,7 @@ bool loop_unrolling_helper(
 
     builder.set_curr_basic_block(header_bb);
 
-    auto br_instr = header_bb->tail_instruction->prev.lock();
+    auto br_instr = header_bb->tail_instruction->prev;
     auto then_bb_id = br_instr->as<CondBr>()->then_block_id;
     auto else_bb_id = br_instr->as<CondBr>()->else_block_id;
 
@@ -464,7 +515,7 @@ bool loop_unrolling_helper(
       for (auto [operand_id, block_id] : phi.incoming_list) {
         if (!loop_info.body_id_set.count(block_id)) {
           auto phi_dst = builder.context.get_operand(phi.dst_id);
-          auto use_id_list_copy = phi_dst->use_id_list;
+          auto use_id_list_copy = phi_dst->use_id_list.to_vector();
           for (auto use_id : use_id_list_copy) {
             auto use_instr = builder.context.get_instruction(use_id);
             if (loop_info.body_id_set.count(use_instr->parent_block_id)) {
@@ -534,7 +585,7 @@ bool loop_unrolling_helper(
 
     builder.set_curr_basic_block(header_bb);
 
-    auto br_instr = header_bb->tail_instruction->prev.lock();
+    auto br_instr = header_bb->tail_instruction->prev;
     auto then_bb_id = br_instr->as<CondBr>()->then_block_id;
     auto else_bb_id = br_instr->as<CondBr>()->else_block_id;
 
@@ -952,7 +1003,7 @@ InstructionPtr clone_instruction(
         }
 
         auto new_instruction = builder.fetch_call_instruction(
-          maybe_dst_id, call.function_name, arg_id_list
+          maybe_dst_id, call.callee->name, arg_id_list
         );
 
         new_instruction->parent_block_id =
@@ -962,25 +1013,14 @@ InstructionPtr clone_instruction(
       },
       [&](const Alloca& alloca) -> InstructionPtr {
         auto dst_id = clone_operand(alloca.dst_id, builder, context);
-        std::optional<OperandID> maybe_size_id = std::nullopt;
         std::optional<OperandID> maybe_align_id = std::nullopt;
-        std::optional<OperandID> maybe_addrspace_id = std::nullopt;
-        if (alloca.maybe_size_id.has_value()) {
-          maybe_size_id =
-            clone_operand(alloca.maybe_size_id.value(), builder, context);
-        }
         if (alloca.maybe_align_id.has_value()) {
           maybe_align_id =
             clone_operand(alloca.maybe_align_id.value(), builder, context);
         }
-        if (alloca.maybe_addrspace_id.has_value()) {
-          maybe_addrspace_id =
-            clone_operand(alloca.maybe_addrspace_id.value(), builder, context);
-        }
 
         auto new_instruction = builder.fetch_alloca_instruction(
-          dst_id, alloca.allocated_type, maybe_size_id, maybe_align_id,
-          maybe_addrspace_id, false
+          dst_id, alloca.allocated_type, maybe_align_id, false
         );
 
         // This should be updated after append and prepend.
@@ -15,14 +15,38 @@ struct LoopUnrollingContext {
   LoopUnrollingContext() = default;
 };
 
-void loop_unrolling(Builder& builder);
+/// Limits of the growth of each function by unrolling.
+struct LoopUnrollingBudget {
+  /// Largest trip count of a loop that is fully unrolled.
+  size_t max_trip_count = 300;
+  /// Most instructions added to a function, none for no limit.
+  std::optional<size_t> max_growth = std::nullopt;
+  /// Seconds after which no more loops of a function are unrolled, none for
+  /// no limit.
+  std::optional<double> max_seconds = std::nullopt;
+};
+
+void loop_unrolling(
+  Builder& builder,
+  AnalysisManager& analysis_manager,
+  const LoopUnrollingBudget& budget = LoopUnrollingBudget()
+);
 
-void loop_unrolling_function(FunctionPtr function, Builder& builder);
+void loop_unrolling_function(
+  FunctionPtr function,
+  Builder& builder,
+  AnalysisManager& analysis_manager,
+  const LoopUnrollingBudget& budget = LoopUnrollingBudget()
+);
 
+/// Fully unroll a loop if it fits in the budget, `growth` is the number of
+/// instructions already added to the function and is updated.
 bool loop_unrolling_helper(
   LoopInfo& loop_info,
   Builder& builder,
-  LoopOptContext& loop_opt_ctx
+  LoopOptContext& loop_opt_ctx,
+  const LoopUnrollingBudget& budget,
+  size_t& growth
 );
 
 OperandID clone_operand(
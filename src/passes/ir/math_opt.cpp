@@ -13,6 +13,7 @@ void math_opt(Builder& builder) {
     if (function->is_declare) {
       continue;
     }
+    builder.switch_function(function_name);
     math_opt_function(function, builder);
   }
 }
@@ -563,14 +564,10 @@ bool simplify(Builder& builder, MathOptContext& math_opt_ctx) {
       }
     } else if (op == BinaryOp::Sub) {
       if (lhs_id == rhs_id) {
-        auto use_id_list_copy = dst->use_id_list;
-        for (auto instr_id : use_id_list_copy) {
-          auto instr = builder.context.get_instruction(instr_id);
-          auto constant_id = builder.fetch_constant_operand(
-            builder.context.get_operand(lhs_id)->get_type(), 0
-          );
-          instr->replace_operand(dst_id, constant_id, builder.context);
-        }
+        auto constant_id = builder.fetch_constant_operand(
+          builder.context.get_operand(lhs_id)->get_type(), 0
+        );
+        dst->replace_all_uses_with(constant_id, builder.context);
         changed = true;
       } else if (lhs->is_arbitrary() && rhs->is_arbitrary()) {
         // Cases:
@@ -678,19 +675,11 @@ bool simplify(Builder& builder, MathOptContext& math_opt_ctx) {
           } else if (lhs_op == BinaryOp::Add) {
             if (rhs_id == lhs_lhs_id) {
               // (x + y) - x -> y
-              auto use_id_list_copy = dst->use_id_list;
-              for (auto instr_id : use_id_list_copy) {
-                auto instr = builder.context.get_instruction(instr_id);
-                instr->replace_operand(dst_id, lhs_rhs_id, builder.context);
-              }
+              dst->replace_all_uses_with(lhs_rhs_id, builder.context);
               changed = true;
             } else if (rhs_id == lhs_rhs_id) {
               // (y + x) - x -> y
-              auto use_id_list_copy = dst->use_id_list;
-              for (auto instr_id : use_id_list_copy) {
-                auto instr = builder.context.get_instruction(instr_id);
-                instr->replace_operand(dst_id, lhs_lhs_id, builder.context);
-              }
+              dst->replace_all_uses_with(lhs_lhs_id, builder.context);
               changed = true;
             }
           } else if (rhs_op == BinaryOp::Add) {
@@ -744,19 +733,11 @@ bool simplify(Builder& builder, MathOptContext& math_opt_ctx) {
           if (lhs_op == BinaryOp::Add) {
             if (rhs_id == lhs_lhs_id) {
               // (x + y) - x -> y
-              auto use_id_list_copy = dst->use_id_list;
-              for (auto instr_id : use_id_list_copy) {
-                auto instr = builder.context.get_instruction(instr_id);
-                instr->replace_operand(dst_id, lhs_rhs_id, builder.context);
-              }
+              dst->replace_all_uses_with(lhs_rhs_id, builder.context);
               changed = true;
             } else if (rhs_id == lhs_rhs_id) {
               // (y + x) - x -> y
-              auto use_id_list_copy = dst->use_id_list;
-              for (auto instr_id : use_id_list_copy) {
-                auto instr = builder.context.get_instruction(instr_id);
-                instr->replace_operand(dst_id, lhs_lhs_id, builder.context);
-              }
+              dst->replace_all_uses_with(lhs_lhs_id, builder.context);
               changed = true;
             }
           }
@@ -820,17 +801,16 @@ bool simplify(Builder& builder, MathOptContext& math_opt_ctx) {
         auto lhs_lhs = builder.context.get_operand(lhs_lhs_id);
         auto lhs_rhs = builder.context.get_operand(lhs_rhs_id);
         if (lhs_op == BinaryOp::Mul) {
-          if (lhs_rhs->is_constant() && lhs_rhs->is_int() && lhs->use_id_list.size() == 1) {
+          // The use list of a constant is shared with other functions, check
+          // that `lhs` is not one before reading it.
+          if (lhs_rhs->is_constant() && lhs_rhs->is_int() &&
+              !lhs->is_constant() && lhs->use_id_list.size() == 1) {
             auto rhs_constant = std::get<operand::ConstantPtr>(rhs->kind);
             auto rhs_constant_value = std::get<int>(rhs_constant->kind);
             auto lhs_rhs_constant = std::get<operand::ConstantPtr>(lhs_rhs->kind);
             auto lhs_rhs_constant_value = std::get<int>(lhs_rhs_constant->kind);
             if (rhs_constant_value == lhs_rhs_constant_value) {
-              auto use_id_list_copy = dst->use_id_list;
-              for (auto instr_id : use_id_list_copy) {
-                auto instr = builder.context.get_instruction(instr_id);
-                instr->replace_operand(dst_id, lhs_lhs_id, builder.context);
-              }
+              dst->replace_all_uses_with(lhs_lhs_id, builder.context);
               changed = true;
             }
           }
@@ -3,56 +3,66 @@
 #include "ir/context.h"
 #include "ir/instruction.h"
 #include "ir/operand.h"
+#include "statistics.h"
 
 namespace syc {
 namespace ir {
 
-void mem2reg(Builder& builder) {
+void mem2reg(Builder& builder, AnalysisManager& analysis_manager) {
   for (auto [function_name, function] : builder.context.function_table) {
     if (function->is_declare) {
       continue;
     }
-    auto cfa_ctx = ControlFlowAnalysisContext();
-    auto mem2reg_ctx = Mem2regContext();
-    control_flow_analysis(function, builder.context, cfa_ctx);
-
-    // Prepare variable set
-    auto entry_bb = function->head_basic_block->next;
-    auto curr_instr = entry_bb->head_instruction->next;
-    while (curr_instr != entry_bb->tail_instruction && curr_instr->is_alloca()
-    ) {
-      auto next_instr = curr_instr->next;
-
-      auto alloca = std::get<instruction::Alloca>(curr_instr->kind);
-
-      auto allocated_type = alloca.allocated_type;
-
-      bool convert = allocated_type->as<type::Integer>().has_value() ||
-                     allocated_type->as<type::Float>().has_value() ||
-                     allocated_type->as<type::Pointer>().has_value();
-
-      // Only convert integer and float
-      if (convert) {
-        // Add the memory operand to variable set
-        mem2reg_ctx.variable_set.insert(alloca.dst_id);
-        // Initialize the maps
-        mem2reg_ctx.def_map[alloca.dst_id] = {};
-        mem2reg_ctx.inserted_map[alloca.dst_id] = {};
-        mem2reg_ctx.worklist_map[alloca.dst_id] = {};
-        mem2reg_ctx.rename_stack_map[alloca.dst_id] = {};
-
-        mem2reg_ctx.type_map[alloca.dst_id] = allocated_type;
-        // Remove alloca instruction
-        curr_instr->remove(builder.context);
-      }
+    builder.switch_function(function_name);
+    mem2reg_function(function, builder, analysis_manager);
+  }
+}
+
+void mem2reg_function(
+  FunctionPtr function,
+  Builder& builder,
+  AnalysisManager& analysis_manager
+) {
+  auto& cfa_ctx = analysis_manager.get_control_flow_analysis(function, builder);
+  auto mem2reg_ctx = Mem2regContext();
+
+  // Prepare variable set
+  auto entry_bb = function->head_basic_block->next;
+  auto curr_instr = entry_bb->head_instruction->next;
+  while (curr_instr != entry_bb->tail_instruction && curr_instr->is_alloca()
+  ) {
+    auto next_instr = curr_instr->next;
 
-      curr_instr = next_instr;
+    auto alloca = std::get<instruction::Alloca>(curr_instr->kind);
+
+    auto allocated_type = alloca.allocated_type;
+
+    bool convert = allocated_type->as<type::Integer>().has_value() ||
+                   allocated_type->as<type::Float>().has_value() ||
+                   allocated_type->as<type::Pointer>().has_value();
+
+    // Only convert integer and float
+    if (convert) {
+      // Add the memory operand to variable set
+      mem2reg_ctx.variable_set.insert(alloca.dst_id);
+      // Initialize the maps
+      mem2reg_ctx.def_map[alloca.dst_id] = {};
+      mem2reg_ctx.inserted_map[alloca.dst_id] = {};
+      mem2reg_ctx.worklist_map[alloca.dst_id] = {};
+      mem2reg_ctx.rename_stack_map[alloca.dst_id] = {};
+
+      mem2reg_ctx.type_map[alloca.dst_id] = allocated_type;
+      // Remove alloca instruction
+      curr_instr->remove(builder.context);
+      bump_counter("ir.mem2reg", "allocas promoted");
     }
-    // Insert phi instruction
-    insert_phi(function, builder, cfa_ctx, mem2reg_ctx);
-    // Rename variables
-    rename(entry_bb, builder, cfa_ctx, mem2reg_ctx);
+
+    curr_instr = next_instr;
   }
+  // Insert phi instruction
+  insert_phi(function, builder, cfa_ctx, mem2reg_ctx);
+  // Rename variables
+  rename(entry_bb, builder, cfa_ctx, mem2reg_ctx);
 }
 
 void insert_phi(
@@ -87,6 +97,9 @@ void insert_phi(
 
   mem2reg_ctx.phi_map = {};
 
+  const auto& dom_tree = cfa_ctx.dom_tree;
+  auto frontier_table = dom_tree.dominance_frontier();
+
   for (auto& [operand_id, worklist] : mem2reg_ctx.worklist_map) {
     // Memory operand. The type is pointer.
     auto operand = builder.context.get_operand(operand_id);
@@ -95,7 +108,8 @@ void insert_phi(
       auto bb_id = worklist.front();
       worklist.pop();
 
-      for (auto df_id : cfa_ctx.dominance_frontier_map[bb_id]) {
+      for (auto df_index : frontier_table[dom_tree.index_of(bb_id)]) {
+        auto df_id = dom_tree.block_id_list[df_index];
         if (mem2reg_ctx.inserted_map[operand_id].count(df_id)) {
           // if block is already inserted, just skip
           continue;
@@ -161,12 +175,7 @@ void rename(
 
         auto load_dst = builder.context.get_operand(load.dst_id);
 
-        auto use_id_list_copy = load_dst->use_id_list;
-
-        for (auto instr_id : use_id_list_copy) {
-          auto instr = builder.context.get_instruction(instr_id);
-          instr->replace_operand(load.dst_id, operand_id, builder.context);
-        }
+        load_dst->replace_all_uses_with(operand_id, builder.context);
 
         curr_instr->remove(builder.context);
       }
@@ -230,7 +239,7 @@ void rename(
   }
 
   // DFS
-  for (auto child_id : cfa_ctx.dom_tree[basic_block->id]) {
+  for (auto child_id : cfa_ctx.dom_tree.get_children(basic_block->id)) {
     rename(
       builder.context.get_basic_block(child_id), builder, cfa_ctx, mem2reg_ctx
     );
@@ -5,6 +5,7 @@
 #include "ir/builder.h"
 #include "ir/function.h"
 #include "passes/ir/control_flow_analysis.h"
+#include "passes/ir/pass_manager.h"
 
 namespace syc {
 namespace ir {
@@ -28,7 +29,13 @@ struct Mem2regContext {
   Mem2regContext() = default;
 };
 
-void mem2reg(Builder& builder);
+void mem2reg(Builder& builder, AnalysisManager& analysis_manager);
+
+void mem2reg_function(
+  FunctionPtr function,
+  Builder& builder,
+  AnalysisManager& analysis_manager
+);
 
 void insert_phi(
   FunctionPtr function,
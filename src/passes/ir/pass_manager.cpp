@@ -0,0 +1,281 @@
+#include "passes/ir/pass_manager.h"
+#include "ir/basic_block.h"
+#include "ir/function.h"
+#include "ir/instruction.h"
+#include "ir/use.h"
+#include "parallel.h"
+#include "statistics.h"
+
+namespace syc {
+namespace ir {
+
+FunctionAnalysis& AnalysisManager::get_function_analysis(FunctionPtr function) {
+  auto it = function_analysis_map.find(function->name);
+  if (it != function_analysis_map.end()) {
+    return it->second;
+  }
+  return function_analysis_map[function->name];
+}
+
+void AnalysisManager::prepare(Context& context) {
+  for (const auto& [function_name, function] : context.function_table) {
+    function_analysis_map[function_name];
+  }
+}
+
+ControlFlowAnalysisContext& AnalysisManager::get_control_flow_analysis(
+  FunctionPtr function,
+  Builder& builder
+) {
+  auto& function_analysis = get_function_analysis(function);
+  if (function_analysis.maybe_cfa_ctx.has_value()) {
+    hit_count++;
+    return function_analysis.maybe_cfa_ctx.value();
+  }
+  compute_count++;
+  auto& cfa_ctx = function_analysis.maybe_cfa_ctx.emplace();
+  control_flow_analysis(function, builder.context, cfa_ctx);
+  return cfa_ctx;
+}
+
+ControlFlowAnalysisContext* AnalysisManager::find_control_flow_analysis(
+  FunctionPtr function
+) {
+  auto& function_analysis = get_function_analysis(function);
+  if (!function_analysis.maybe_cfa_ctx.has_value()) {
+    return nullptr;
+  }
+  return &function_analysis.maybe_cfa_ctx.value();
+}
+
+LoopOptContext&
+AnalysisManager::get_loop_analysis(FunctionPtr function, Builder& builder) {
+  auto& function_analysis = get_function_analysis(function);
+  if (function_analysis.maybe_loop_opt_ctx.has_value()) {
+    hit_count++;
+    return function_analysis.maybe_loop_opt_ctx.value();
+  }
+  auto& cfa_ctx = get_control_flow_analysis(function, builder);
+  compute_count++;
+  auto& loop_opt_ctx = function_analysis.maybe_loop_opt_ctx.emplace();
+  detect_natural_loop(function, builder, cfa_ctx, loop_opt_ctx);
+  return loop_opt_ctx;
+}
+
+void AnalysisManager::invalidate(FunctionPtr function) {
+  auto& function_analysis = get_function_analysis(function);
+  function_analysis.maybe_cfa_ctx.reset();
+  function_analysis.maybe_loop_opt_ctx.reset();
+}
+
+void AnalysisManager::invalidate_loops(FunctionPtr function) {
+  get_function_analysis(function).maybe_loop_opt_ctx.reset();
+}
+
+void AnalysisManager::invalidate_all() {
+  for (auto& [function_name, function_analysis] : function_analysis_map) {
+    function_analysis.maybe_cfa_ctx.reset();
+    function_analysis.maybe_loop_opt_ctx.reset();
+  }
+}
+
+void PassManager::run(
+  const std::string& name,
+  Pass pass,
+  CfgEffect cfg_effect
+) {
+  flush();
+  time_pass(
+    "ir." + name, [&]() { pass(builder); },
+    [&]() { return count_instructions(); }
+  );
+  if (cfg_effect == CfgEffect::Change) {
+    analysis_manager.invalidate_all();
+  }
+}
+
+void PassManager::run(const std::string& name, AnalysisPass pass) {
+  flush();
+  time_pass(
+    "ir." + name, [&]() { pass(builder, analysis_manager); },
+    [&]() { return count_instructions(); }
+  );
+}
+
+void PassManager::run_function_pass(const std::string& name, FunctionPass pass) {
+  pending_function_pass_list.emplace_back(
+    name,
+    [pass](FunctionPtr function, Builder& builder, AnalysisManager&) {
+      pass(function, builder);
+    }
+  );
+}
+
+void PassManager::run_function_pass(
+  const std::string& name,
+  FunctionAnalysisPass pass
+) {
+  pending_function_pass_list.emplace_back(name, pass);
+}
+
+void PassManager::run_fixpoint_group(
+  const std::string& name,
+  FixpointGroup group,
+  size_t max_round_count
+) {
+  auto counter_name = "ir." + name;
+  pending_function_pass_list.emplace_back(
+    name,
+    [=](FunctionPtr function, Builder& builder, AnalysisManager&) {
+      size_t round_count = 0;
+      bool changed = true;
+      while (changed && round_count < max_round_count) {
+        changed = false;
+        round_count++;
+        for (const auto& [pass_name, pass] : group) {
+          builder.switch_function(function->name);
+          if (pass(function, builder)) {
+            bump_counter(counter_name, pass_name + " changes");
+            changed = true;
+          }
+        }
+      }
+      bump_counter(counter_name, "rounds", round_count);
+      if (changed) {
+        bump_counter(counter_name, "functions at round limit");
+      }
+    }
+  );
+}
+
+void PassManager::flush() {
+  if (pending_function_pass_list.empty()) {
+    return;
+  }
+
+  auto& context = builder.context;
+  auto& statistics = get_statistics();
+  auto pass_count = pending_function_pass_list.size();
+
+  // The largest functions are started first to balance the threads.
+  std::vector<FunctionPtr> function_list;
+  for (const auto& [function_name, function] : context.function_table) {
+    if (!function->is_declare) {
+      function_list.push_back(function);
+    }
+  }
+  std::vector<size_t> size_list;
+  for (auto function : function_list) {
+    size_list.push_back(count_function_instructions(function));
+  }
+  auto order_list = largest_first_order(size_list);
+
+  std::vector<size_t> snapshot_list;
+  for (const auto& id_space : context.id_space_list) {
+    snapshot_list.push_back(id_space->next_instruction_local);
+  }
+
+  analysis_manager.prepare(context);
+
+  // Records of each pass on each function, summed up after all the threads.
+  std::vector<std::vector<PassRecord>> record_table(
+    function_list.size(), std::vector<PassRecord>(pass_count)
+  );
+  parallel_for(order_list.size(), thread_count, [&](size_t index) {
+    auto function_index = order_list[index];
+    auto function = function_list[function_index];
+    auto worker = Builder(context);
+    auto worker_id_space_scope = WorkerIdSpaceScope(function->id_space);
+    for (size_t i = 0; i < pass_count; i++) {
+      worker.switch_function(function->name);
+      auto& pass = pending_function_pass_list[i].second;
+      if (!statistics.enabled) {
+        pass(function, worker, analysis_manager);
+        continue;
+      }
+      auto& record = record_table[function_index][i];
+      record.instruction_count_before = count_function_instructions(function);
+      auto start = std::chrono::steady_clock::now();
+      pass(function, worker, analysis_manager);
+      auto end = std::chrono::steady_clock::now();
+      record.seconds = std::chrono::duration<double>(end - start).count();
+      record.instruction_count_after = count_function_instructions(function);
+    }
+  });
+
+  sort_callers(snapshot_list);
+
+  if (statistics.enabled) {
+    // Instructions of the functions that are not run on, e.g. declarations.
+    size_t untouched_count = count_instructions();
+    for (auto function : function_list) {
+      untouched_count -= count_function_instructions(function);
+    }
+    // The functions run concurrently, so the memory usage is only read once
+    // all of them are done.
+    auto memory_after = read_memory_usage();
+    for (size_t i = 0; i < pass_count; i++) {
+      PassRecord summary{
+        "ir." + pending_function_pass_list[i].first, 0, untouched_count,
+        untouched_count, memory_after};
+      for (const auto& record_list : record_table) {
+        summary.seconds += record_list[i].seconds;
+        summary.instruction_count_before +=
+          record_list[i].instruction_count_before;
+        summary.instruction_count_after +=
+          record_list[i].instruction_count_after;
+      }
+      statistics.pass_record_list.push_back(summary);
+    }
+  }
+
+  pending_function_pass_list.clear();
+}
+
+void PassManager::sort_callers(const std::vector<size_t>& snapshot_list) {
+  auto& context = builder.context;
+
+  std::map<size_t, size_t> rank_map;
+  size_t rank = 0;
+  for (const auto& [function_name, function] : context.function_table) {
+    rank_map[function->id_space] = rank++;
+  }
+
+  auto key = [&](InstructionID id) -> size_t {
+    auto space = id_space_of(id);
+    if (space < snapshot_list.size() && id_local_of(id) < snapshot_list[space]) {
+      return 0;
+    }
+    return rank_map[space] + 1;
+  };
+
+  for (const auto& [function_name, function] : context.function_table) {
+    std::stable_sort(
+      function->caller_id_list.begin(), function->caller_id_list.end(),
+      [&](InstructionID lhs, InstructionID rhs) { return key(lhs) < key(rhs); }
+    );
+  }
+}
+
+size_t PassManager::count_instructions() const {
+  size_t count = 0;
+  for (const auto& [function_name, function] : builder.context.function_table) {
+    count += count_function_instructions(function);
+  }
+  return count;
+}
+
+size_t count_function_instructions(FunctionPtr function) {
+  size_t count = 0;
+  for (auto bb = function->head_basic_block->next;
+       bb != function->tail_basic_block; bb = bb->next) {
+    for (auto instr = bb->head_instruction->next;
+         instr != bb->tail_instruction; instr = instr->next) {
+      count++;
+    }
+  }
+  return count;
+}
+
+}  // namespace ir
+}  // namespace syc
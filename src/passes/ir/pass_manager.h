@@ -0,0 +1,155 @@
+#ifndef SYC_PASSES_IR_PASS_MANAGER_H_
+#define SYC_PASSES_IR_PASS_MANAGER_H_
+
+#include <atomic>
+
+#include "common.h"
+#include "ir/builder.h"
+#include "passes/ir/control_flow_analysis.h"
+#include "passes/ir/loop_analysis.h"
+
+namespace syc {
+namespace ir {
+
+/// Cached analyses of a function.
+struct FunctionAnalysis {
+  std::optional<ControlFlowAnalysisContext> maybe_cfa_ctx;
+  std::optional<LoopOptContext> maybe_loop_opt_ctx;
+};
+
+/// Analyses shared by the passes.
+///
+/// Dominators, dominance frontiers and loops only depend on the CFG, so they
+/// are computed on the first query and reused until a pass reports that it
+/// changed the CFG of the function by `invalidate`. Passes may change the
+/// instructions freely without invalidating anything. Passes that update the
+/// dominator tree along with their CFG changes only drop the loops by
+/// `invalidate_loops`.
+///
+/// Entries are never erased, so once `prepare` has created the entries of all
+/// the functions, passes on different functions may query concurrently.
+struct AnalysisManager {
+  std::map<std::string, FunctionAnalysis> function_analysis_map;
+
+  /// Number of analyses computed from scratch.
+  std::atomic<size_t> compute_count = 0;
+  /// Number of queries answered by the cache.
+  std::atomic<size_t> hit_count = 0;
+
+  /// Get the cache entry of a function, create it if there is none.
+  FunctionAnalysis& get_function_analysis(FunctionPtr function);
+
+  /// Create the entries of all the functions in the context.
+  void prepare(Context& context);
+
+  /// Get the dominators and dominance frontiers of the function.
+  ControlFlowAnalysisContext&
+  get_control_flow_analysis(FunctionPtr function, Builder& builder);
+
+  /// Get the dominators of the function if they are cached, or null.
+  ControlFlowAnalysisContext* find_control_flow_analysis(FunctionPtr function);
+
+  /// Get the natural loops of the function.
+  LoopOptContext& get_loop_analysis(FunctionPtr function, Builder& builder);
+
+  /// Drop the analyses of a function whose CFG is changed.
+  void invalidate(FunctionPtr function);
+
+  /// Drop the loops of a function whose CFG is changed, while the dominator
+  /// tree is kept up to date by the pass.
+  void invalidate_loops(FunctionPtr function);
+
+  /// Drop the analyses of all the functions.
+  void invalidate_all();
+};
+
+/// How a plain pass affects the CFG.
+enum class CfgEffect {
+  /// Only instructions are changed, the analyses stay valid.
+  Preserve,
+  /// Blocks or edges of any function may be changed.
+  Change,
+};
+
+/// Run passes on the IR and keep the cached analyses consistent.
+///
+/// A pass either takes the `AnalysisManager` and reports its own CFG changes,
+/// or is a plain pass that tells the manager if it may change the CFG.
+///
+/// Function passes only touch the function they are given, so consecutive
+/// function passes are queued and run function by function, on up to
+/// `thread_count` threads, when a module pass or the end of the pipeline is
+/// reached. Each function allocates IDs in its own space, so the result does
+/// not depend on the number of threads.
+struct PassManager {
+  using Pass = std::function<void(Builder&)>;
+  using AnalysisPass = std::function<void(Builder&, AnalysisManager&)>;
+  using FunctionPass = std::function<void(FunctionPtr, Builder&)>;
+  using FunctionAnalysisPass =
+    std::function<void(FunctionPtr, Builder&, AnalysisManager&)>;
+  /// Function pass that returns if it changed anything.
+  using ChangeFunctionPass = std::function<bool(FunctionPtr, Builder&)>;
+  /// Named passes of a fixpoint group, run in order in each round.
+  using FixpointGroup =
+    std::vector<std::pair<std::string, ChangeFunctionPass>>;
+
+  /// Default number of rounds after which a fixpoint group gives up.
+  static constexpr size_t DEFAULT_MAX_ROUND_COUNT = 8;
+
+  Builder& builder;
+  AnalysisManager analysis_manager;
+
+  /// Number of threads to run the function passes on.
+  size_t thread_count = 1;
+  /// Function passes waiting for `flush`.
+  std::vector<std::pair<std::string, FunctionAnalysisPass>>
+    pending_function_pass_list;
+
+  PassManager(Builder& builder) : builder(builder) {}
+
+  /// Run a plain pass, drop all the analyses if it may change the CFG.
+  void run(
+    const std::string& name,
+    Pass pass,
+    CfgEffect cfg_effect = CfgEffect::Preserve
+  );
+
+  /// Run a pass that invalidates the analyses itself.
+  void run(const std::string& name, AnalysisPass pass);
+
+  /// Queue a pass on each function that does not change the CFG.
+  void run_function_pass(const std::string& name, FunctionPass pass);
+
+  /// Queue a pass on each function that invalidates the analyses itself.
+  void run_function_pass(const std::string& name, FunctionAnalysisPass pass);
+
+  /// Queue a group of passes that do not change the CFG. On each function,
+  /// the group runs round after round until no pass changes anything, or
+  /// until `max_round_count` rounds are run. The rounds, the changes of each
+  /// pass and the functions that reach the limit are counted under the name
+  /// of the group.
+  void run_fixpoint_group(
+    const std::string& name,
+    FixpointGroup group,
+    size_t max_round_count = DEFAULT_MAX_ROUND_COUNT
+  );
+
+  /// Run the queued function passes on all the defined functions.
+  void flush();
+
+  /// Canonicalize the caller lists changed by concurrent function passes.
+  /// Calls created since `snapshot_list` (the next instruction index of each
+  /// space) are ordered by the position of the calling function.
+  void sort_callers(const std::vector<size_t>& snapshot_list);
+
+  /// Number of instructions in all the functions, for the statistics.
+  size_t count_instructions() const;
+};
+
+/// Number of instructions in a function.
+size_t count_function_instructions(FunctionPtr function);
+
+}  // namespace ir
+}  // namespace syc
+
+#endif
@@ -10,22 +10,27 @@ namespace ir {
 
 void peephole(Builder& builder) {
   for (auto [function_name, function] : builder.context.function_table) {
+    builder.switch_function(function_name);
     peephole_function(function, builder);
   }
 }
 
-void peephole_function(FunctionPtr function, Builder& builder) {
+bool peephole_function(FunctionPtr function, Builder& builder) {
+  bool changed = false;
   auto curr_basic_block = function->head_basic_block->next;
   while (curr_basic_block != function->tail_basic_block) {
-    peephole_basic_block(curr_basic_block, builder);
+    changed = peephole_basic_block(curr_basic_block, builder) || changed;
     curr_basic_block = curr_basic_block->next;
   }
+  return changed;
 }
 
-void peephole_basic_block(BasicBlockPtr basic_block, Builder& builder) {
+bool peephole_basic_block(BasicBlockPtr basic_block, Builder& builder) {
   using namespace instruction;
   builder.set_curr_basic_block(basic_block);
 
+  bool changed = false;
+
   auto curr_instruction = basic_block->head_instruction->next;
   while (curr_instruction != basic_block->tail_instruction) {
     auto next_instruction = curr_instruction->next;
@@ -60,6 +65,7 @@ void peephole_basic_block(BasicBlockPtr basic_block, Builder& builder) {
         ));
         next_instruction = curr_instruction->next;
         curr_instruction->remove(builder.context);
+        changed = true;
       } else if (curr_op == BinaryOp::Add
         && curr_lhs->is_int()
         && curr_rhs->is_int()
@@ -70,26 +76,14 @@ void peephole_basic_block(BasicBlockPtr basic_block, Builder& builder) {
         auto constant = std::get<operand::ConstantPtr>(curr_rhs->kind);
         auto constant_value = std::get<int>(constant->kind);
         if (constant_value == 0) {
-          auto use_id_list_copy = curr_dst->use_id_list;
-          for (auto use_instruction_id : use_id_list_copy) {
-            auto instruction =
-              builder.context.get_instruction(use_instruction_id);
-            instruction->replace_operand(
-              curr_dst->id, curr_lhs->id, builder.context
-            );
-          }
+          curr_dst->replace_all_uses_with(curr_lhs->id, builder.context);
           curr_instruction->remove(builder.context);
+          changed = true;
         }
       } else if (curr_op == BinaryOp::Add && curr_lhs->is_zero() && curr_rhs->is_int()) {
-        auto use_id_list_copy = curr_dst->use_id_list;
-        for (auto use_instruction_id : use_id_list_copy) {
-          auto instruction =
-            builder.context.get_instruction(use_instruction_id);
-          instruction->replace_operand(
-            curr_dst->id, curr_rhs->id, builder.context
-          );
-        }
+        curr_dst->replace_all_uses_with(curr_rhs->id, builder.context);
         curr_instruction->remove(builder.context);
+        changed = true;
       } else if (curr_op == BinaryOp::SDiv && curr_rhs->is_constant() && curr_rhs->is_int()) {
         // dest = sdiv lhs, 1
         // ->
@@ -97,15 +91,9 @@ void peephole_basic_block(BasicBlockPtr basic_block, Builder& builder) {
         auto constant = std::get<operand::ConstantPtr>(curr_rhs->kind);
         auto constant_value = std::get<int>(constant->kind);
         if (constant_value == 1) {
-          auto use_id_list_copy = curr_dst->use_id_list;
-          for (auto use_instruction_id : use_id_list_copy) {
-            auto instruction =
-              builder.context.get_instruction(use_instruction_id);
-            instruction->replace_operand(
-              curr_dst->id, curr_lhs->id, builder.context
-            );
-          }
+          curr_dst->replace_all_uses_with(curr_lhs->id, builder.context);
           curr_instruction->remove(builder.context);
+          changed = true;
         } else if (constant_value == -1) {
           auto neg_instruction = builder.fetch_binary_instruction(
             BinaryOp::Sub, curr_dst->id, builder.fetch_constant_operand(
@@ -115,48 +103,25 @@ void peephole_basic_block(BasicBlockPtr basic_block, Builder& builder) {
           curr_instruction->insert_next(neg_instruction);
           next_instruction = curr_instruction->next;
           curr_instruction->remove(builder.context);
+          changed = true;
         }
       } else if (curr_op == BinaryOp::FMul && (curr_rhs->is_zero() || curr_lhs->is_zero())) {
         auto zero_id = builder.fetch_constant_operand(
           builder.fetch_float_type(), 0.0f
         );
-        auto use_id_list_copy = curr_dst->use_id_list;
-        for (auto use_instruction_id : use_id_list_copy) {
-          auto instruction =
-            builder.context.get_instruction(use_instruction_id);
-          instruction->replace_operand(
-            curr_dst->id, zero_id, builder.context
-          );
-        }
+        changed = changed || !curr_dst->use_id_list.empty();
+        curr_dst->replace_all_uses_with(zero_id, builder.context);
       } else if (curr_op == BinaryOp::FAdd && (curr_rhs->is_zero() || curr_lhs->is_zero())) {
         if (curr_rhs->is_zero()) {
-          auto use_id_list_copy = curr_dst->use_id_list;
-          for (auto use_instruction_id : use_id_list_copy) {
-            auto instruction =
-              builder.context.get_instruction(use_instruction_id);
-            instruction->replace_operand(
-              curr_dst->id, curr_lhs->id, builder.context
-            );
-          }
+          changed = changed || !curr_dst->use_id_list.empty();
+          curr_dst->replace_all_uses_with(curr_lhs->id, builder.context);
         } else {
-          auto use_id_list_copy = curr_dst->use_id_list;
-          for (auto use_instruction_id : use_id_list_copy) {
-            auto instruction =
-              builder.context.get_instruction(use_instruction_id);
-            instruction->replace_operand(
-              curr_dst->id, curr_rhs->id, builder.context
-            );
-          }
+          changed = changed || !curr_dst->use_id_list.empty();
+          curr_dst->replace_all_uses_with(curr_rhs->id, builder.context);
         }
       } else if (curr_op == BinaryOp::FSub && curr_rhs->is_zero()) {
-        auto use_id_list_copy = curr_dst->use_id_list;
-        for (auto use_instruction_id : use_id_list_copy) {
-          auto instruction =
-            builder.context.get_instruction(use_instruction_id);
-          instruction->replace_operand(
-            curr_dst->id, curr_lhs->id, builder.context
-          );
-        }
+        changed = changed || !curr_dst->use_id_list.empty();
+        curr_dst->replace_all_uses_with(curr_lhs->id, builder.context);
       }
     } else if (maybe_getelementptr.has_value()) {
       auto curr_kind = maybe_getelementptr.value();
@@ -182,6 +147,7 @@ void peephole_basic_block(BasicBlockPtr basic_block, Builder& builder) {
         curr_instruction->insert_next(bitcast_instruction);
         next_instruction = curr_instruction->next;
         curr_instruction->remove(builder.context);
+        changed = true;
       }
     } else if (maybe_cast.has_value()) {
       auto curr_kind = maybe_cast.value();
@@ -191,15 +157,9 @@ void peephole_basic_block(BasicBlockPtr basic_block, Builder& builder) {
       if (curr_op == CastOp::BitCast && *curr_dst->get_type() == *curr_src->get_type()) {
         // bitcast dst, src are same type
         // -> make all dst to src
-        auto use_id_list_copy = curr_dst->use_id_list;
-        for (auto use_instruction_id : use_id_list_copy) {
-          auto instruction =
-            builder.context.get_instruction(use_instruction_id);
-          instruction->replace_operand(
-            curr_dst->id, curr_src->id, builder.context
-          );
-        }
+        curr_dst->replace_all_uses_with(curr_src->id, builder.context);
         curr_instruction->remove(builder.context);
+        changed = true;
       }
     } else if (maybe_phi.has_value()) {
       auto phi = maybe_phi.value();
@@ -207,12 +167,9 @@ void peephole_basic_block(BasicBlockPtr basic_block, Builder& builder) {
       if (phi.incoming_list.size() == 1) {
         auto [operand_id, block_id] = phi.incoming_list[0];
         auto dst = builder.context.get_operand(phi.dst_id);
-        auto use_id_list_copy = dst->use_id_list;
-        for (auto instruction_id : use_id_list_copy) {
-          auto instruction = builder.context.get_instruction(instruction_id);
-          instruction->replace_operand(dst->id, operand_id, builder.context);
-        }
+        dst->replace_all_uses_with(operand_id, builder.context);
         curr_instruction->remove(builder.context);
+        changed = true;
       }
     } else if (maybe_store.has_value()) {
       // Adjacent load and store from/to the same address
@@ -230,15 +187,10 @@ void peephole_basic_block(BasicBlockPtr basic_block, Builder& builder) {
 
           if (store_ptr_id == load_ptr_id) {
             auto load_dst = builder.context.get_operand(load_dst_id);
-            auto use_id_list_copy = load_dst->use_id_list;
-            for (auto instr_id : use_id_list_copy) {
-              auto instr = builder.context.get_instruction(instr_id);
-              instr->replace_operand(
-                load_dst_id, store_src_id, builder.context
-              );
-            }
+            load_dst->replace_all_uses_with(store_src_id, builder.context);
             // Remove the load instruction
             next_instruction->remove(builder.context);
+            changed = true;
             next_instruction = curr_instruction->next;
           }
         }
@@ -247,6 +199,8 @@ void peephole_basic_block(BasicBlockPtr basic_block, Builder& builder) {
 
     curr_instruction = next_instruction;
   }
+
+  return changed;
 }
 
 }  // namespace ir
@@ -48,7 +48,7 @@ bool is_pure(
       auto maybe_store = instr->as<Store>();
 
       if (maybe_call.has_value()) {
-        auto callee = builder.context.get_function(maybe_call->function_name);
+        auto callee = builder.context.get_function(maybe_call->callee->name);
         if (callee->is_declare) {
           return false;
         }
@@ -84,7 +84,7 @@ void purity_opt_function(
          instr = instr->next) {
       auto maybe_call = instr->as<Call>();
       if (maybe_call.has_value()) {
-        auto callee = builder.context.get_function(maybe_call->function_name);
+        auto callee = builder.context.get_function(maybe_call->callee->name);
         if (!is_pure(callee, builder, purity_ctx)) {
           continue;
         }
@@ -96,7 +96,7 @@ void purity_opt_function(
 
           if (dst->use_id_list.size() == 0) {
             // Remove the call instruction
-            auto prev = instr->prev.lock();
+            auto prev = instr->prev;
             instr->remove(builder.context);
             instr = prev;
 
@@ -104,8 +104,9 @@ void purity_opt_function(
           }
         }
 
-        auto key =
-          std::make_tuple(maybe_call->function_name, maybe_call->arg_id_list);
+        auto key = std::make_tuple(
+          maybe_call->callee->name, maybe_call->arg_id_list.to_vector()
+        );
         if (call_cache.count(key)) {
           if (maybe_call->maybe_dst_id.has_value()) {
             auto dst =
@@ -113,17 +114,10 @@ void purity_opt_function(
 
             auto cached_dst = builder.context.get_operand(call_cache[key]);
 
-            auto use_id_list_copy = dst->use_id_list;
-
-            for (auto use_id : use_id_list_copy) {
-              auto use_instr = builder.context.get_instruction(use_id);
-              use_instr->replace_operand(
-                dst->id, cached_dst->id, builder.context
-              );
-            }
+            dst->replace_all_uses_with(cached_dst->id, builder.context);
           }
 
-          auto prev = instr->prev.lock();
+          auto prev = instr->prev;
           instr->remove(builder.context);
           instr = prev;
         } else {
@@ -131,7 +125,7 @@ void purity_opt_function(
             call_cache[key] = maybe_call->maybe_dst_id.value();
           } else {
             // Remove
-            auto prev = instr->prev.lock();
+            auto prev = instr->prev;
             instr->remove(builder.context);
             instr = prev;
           }
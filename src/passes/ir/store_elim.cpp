@@ -2,13 +2,15 @@
 #include "ir/function.h"
 #include "ir/basic_block.h"
 #include "ir/instruction.h"
+#include "ir/operand.h"
+#include "statistics.h"
 
 namespace syc {
 namespace ir {
 
 void store_elim(Builder& builder) {
-  bool has_load = false;
   for (auto& [function_name, function] : builder.context.function_table) {
+    bool has_load = false;
     if (function->is_declare) {
       continue;
     }
@@ -26,16 +28,82 @@ void store_elim(Builder& builder) {
         auto instr = bb->head_instruction->next;
         while (instr != bb->tail_instruction) {
           auto next = instr->next;
-          if (instr->is_store()) {
+          if (instr->is_store() &&
+              is_function_local_memory(
+                instr->as<instruction::Store>()->ptr_id, function_name,
+                builder
+              )) {
             instr->remove(builder.context);
+            bump_counter("ir.store_elim", "stores eliminated");
           }
           instr = next;
         }
       }
     }
+  }
+}
 
+bool is_function_local_memory(
+  OperandID ptr_id,
+  const std::string& function_name,
+  Builder& builder
+) {
+  auto operand = builder.context.get_operand(ptr_id);
+  while (operand->maybe_def_id.has_value()) {
+    auto def_instr =
+      builder.context.get_instruction(operand->maybe_def_id.value());
+    if (def_instr->is_getelementptr()) {
+      operand = builder.context.get_operand(
+        def_instr->as<instruction::GetElementPtr>()->ptr_id
+      );
+    } else if (def_instr->is_alloca()) {
+      return !is_address_escaped(operand->id, function_name, builder);
+    } else {
+      return false;
+    }
+  }
+  if (operand->is_global()) {
+    return !is_address_escaped(operand->id, function_name, builder);
+  }
+  // Parameters.
+  return false;
+}
 
+bool is_address_escaped(
+  OperandID ptr_id,
+  const std::string& function_name,
+  Builder& builder
+) {
+  auto operand = builder.context.get_operand(ptr_id);
+  for (auto use_id : operand->use_id_list) {
+    auto instr = builder.context.get_instruction(use_id);
+    auto bb = builder.context.get_basic_block(instr->parent_block_id);
+    if (bb->parent_function->name != function_name) {
+      return true;
+    }
+    if (instr->is_load()) {
+      continue;
+    }
+    if (instr->is_store() &&
+        instr->as<instruction::Store>()->value_id != ptr_id) {
+      continue;
+    }
+    // Zero filling only writes the memory.
+    if (instr->is_call() &&
+        instr->as<instruction::Call>()->callee->name == "__builtin_fill_zero") {
+      continue;
+    }
+    if (instr->is_getelementptr()) {
+      auto gep = instr->as<instruction::GetElementPtr>().value();
+      if (gep.ptr_id == ptr_id &&
+          !is_address_escaped(gep.dst_id, function_name, builder)) {
+        continue;
+      }
+    }
+    return true;
   }
+  return false;
 }
+
 }
 }
\ No newline at end of file
@@ -7,8 +7,28 @@
 namespace syc {
 namespace ir {
 
+/// Remove the stores of the functions without loads. Only the stores to the
+/// memory no other function can see are removed, i.e. to the allocas of the
+/// function and to the globals only used by the function.
 void store_elim(Builder& builder);
 
+/// If a pointer points into an alloca or a global that is only used by the
+/// function, and whose address does not escape.
+bool is_function_local_memory(
+  OperandID ptr_id,
+  const std::string& function_name,
+  Builder& builder
+);
+
+/// If an address is used outside the function, or by anything but loads,
+/// stores to it, zero filling and getelementptr whose result does not escape
+/// either.
+bool is_address_escaped(
+  OperandID ptr_id,
+  const std::string& function_name,
+  Builder& builder
+);
+
 }
 }
 
@@ -1,19 +1,40 @@
 #include "passes/ir/straighten.h"
 #include "ir/operand.h"
+#include "statistics.h"
 
 namespace syc {
 namespace ir {
 
-void straighten(Builder& builder) {
+void straighten(Builder& builder, AnalysisManager& analysis_manager) {
   for (auto [function_name, function] : builder.context.function_table) {
     if (function->is_declare) {
       continue;
     }
-    straighten_function(function, builder);
+    builder.switch_function(function_name);
+    straighten_function(function, builder, analysis_manager);
   }
 }
 
-void straighten_function(FunctionPtr function, Builder& builder) {
+void straighten_function(
+  FunctionPtr function,
+  Builder& builder,
+  AnalysisManager& analysis_manager
+) {
+  auto cfa_ctx = analysis_manager.find_control_flow_analysis(function);
+  auto dom_tree = cfa_ctx != nullptr ? &cfa_ctx->dom_tree : nullptr;
+
+  if (straighten_blocks(function, builder, dom_tree)) {
+    analysis_manager.invalidate_loops(function);
+  }
+}
+
+bool straighten_blocks(
+  FunctionPtr function,
+  Builder& builder,
+  DominatorTree* dom_tree
+) {
+  bool changed = false;
+
   // Policy: fuse blocks that has one succ and the succ has one pred
   auto curr_bb = function->head_basic_block->next;
   while (curr_bb != function->tail_basic_block &&
@@ -45,7 +66,7 @@ void straighten_function(FunctionPtr function, Builder& builder) {
     }
 
     // Remove branch in curr_bb
-    auto branch_instr = curr_bb->tail_instruction->prev.lock();
+    auto branch_instr = curr_bb->tail_instruction->prev;
     branch_instr->remove(builder.context);
 
     // Append succ_bb's instructions to curr_bb
@@ -86,7 +107,12 @@ void straighten_function(FunctionPtr function, Builder& builder) {
     }
 
     // Remove succ_bb
+    if (dom_tree != nullptr) {
+      dom_tree->merge_block(curr_bb->id, succ_bb->id);
+    }
     succ_bb->remove(builder.context);
+    bump_counter("ir.straighten", "blocks merged");
+    changed = true;
   }
 
   // Policy:
@@ -164,7 +190,7 @@ void straighten_function(FunctionPtr function, Builder& builder) {
     // Modify curr_bb's branch
     curr_bb->remove_succ(succ0_bb->id);
     merge_bb->remove_pred(succ0_bb->id);
-    auto condbr_instr = curr_bb->tail_instruction->prev.lock();
+    auto condbr_instr = curr_bb->tail_instruction->prev;
     auto& condbr = condbr_instr->as_ref<instruction::CondBr>().value().get();
     if (condbr.then_block_id == succ0_bb->id) {
       condbr.then_block_id = merge_bb->id;
@@ -190,11 +216,17 @@ void straighten_function(FunctionPtr function, Builder& builder) {
     }
 
     // Remove succ0_bb
+    if (dom_tree != nullptr) {
+      dom_tree->bypass_block(succ0_bb->id);
+    }
     succ0_bb->remove(builder.context);
+    bump_counter("ir.straighten", "empty blocks bypassed");
+    changed = true;
 
     curr_bb = curr_bb->next;
   }
 
+  return changed;
 }
 }  // namespace ir
 }  // namespace syc
\ No newline at end of file
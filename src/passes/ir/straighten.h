@@ -6,13 +6,26 @@
 #include "ir/function.h"
 #include "ir/instruction.h"
 #include "ir/basic_block.h"
+#include "passes/ir/pass_manager.h"
 
 namespace syc {
 namespace ir {
 
-void straighten(Builder& builder);
+void straighten(Builder& builder, AnalysisManager& analysis_manager);
 
-void straighten_function(FunctionPtr function, Builder& builder);
+void straighten_function(
+  FunctionPtr function,
+  Builder& builder,
+  AnalysisManager& analysis_manager
+);
+
+/// Fuse and bypass blocks, return if the CFG is changed.
+/// The dominator tree is updated if given.
+bool straighten_blocks(
+  FunctionPtr function,
+  Builder& builder,
+  DominatorTree* dom_tree = nullptr
+);
 
 }
 }
@@ -10,6 +10,7 @@ namespace ir {
 
 void strength_reduce(Builder& builder) {
   for (auto [function_name, function] : builder.context.function_table) {
+    builder.switch_function(function_name);
     strength_reduce_function(function, builder);
   }
 }
@@ -47,14 +48,9 @@ void strength_reduce_basic_block(BasicBlockPtr basic_block, Builder& builder) {
         auto constant_value = std::get<int>(constant->kind);
         if (constant_value == 0) {
           // mul lhs, 0 -> make all uses of dst to 0
-          auto use_id_list_copy = curr_dst->use_id_list;
           auto zero =
             builder.fetch_constant_operand(builder.fetch_i32_type(), (int)0);
-          for (auto use_instruction_id : use_id_list_copy) {
-            auto instruction =
-              builder.context.get_instruction(use_instruction_id);
-            instruction->replace_operand(curr_dst->id, zero, builder.context);
-          }
+          curr_dst->replace_all_uses_with(zero, builder.context);
           curr_instruction->remove(builder.context);
         } else if (constant_value > 1 && (constant_value & (constant_value - 1)) == 0) {
           // dest = mul lhs, 2^k -> dest = shl lhs, k
@@ -76,14 +72,7 @@ void strength_reduce_basic_block(BasicBlockPtr basic_block, Builder& builder) {
         auto constant_value = std::get<int>(constant->kind);
         if (constant_value == 1) {
           // div lhs 1, make all uses of dst to lhs
-          auto use_id_list_copy = curr_dst->use_id_list;
-          for (auto use_instruction_id : use_id_list_copy) {
-            auto instruction =
-              builder.context.get_instruction(use_instruction_id);
-            instruction->replace_operand(
-              curr_dst->id, curr_lhs->id, builder.context
-            );
-          }
+          curr_dst->replace_all_uses_with(curr_lhs->id, builder.context);
           curr_instruction->remove(builder.context);
         } else if (constant_value == -1) {
           // div lhs, -1 -> dest = sub 0, lhs
@@ -1,4 +1,5 @@
 #include "passes/ir/tco.h"
+#include "statistics.h"
 
 namespace syc {
 
@@ -32,7 +33,7 @@ void tail_call_elim_func(
     {
       if (auto call_inst = std::get_if<instruction::Call>(&now_inst->kind))
       {
-        auto call_target = call_inst->function_name;
+        auto call_target = call_inst->callee->name;
         if (call_target == function->name && is_inst_tail_call(now_inst, function, builder))
         {
           tail_calls.push_back(now_inst);
@@ -44,6 +45,9 @@ void tail_call_elim_func(
   if (tail_calls.empty())
     return;
 
+  // New nodes go into the space of the function, see `IdSpace`.
+  builder.switch_function(function->name);
+
   // Create a new entry basic block
   auto old_entry_block = function->head_basic_block->next;
   auto entry_block = builder.fetch_basic_block();
@@ -99,9 +103,10 @@ void tail_call_elim_func(
   {
     auto tail_call_prev = tail_call->prev;
     auto parent_block = builder.context.basic_block_table[tail_call->parent_block_id];
-    while(tail_call_prev.lock()->next != parent_block->tail_instruction)
-      tail_call_prev.lock()->next->remove(builder.context);
+    while(tail_call_prev->next != parent_block->tail_instruction)
+      tail_call_prev->next->remove(builder.context);
     // tail_call->remove(builder.context);
+    bump_counter("ir.tco", "tail calls eliminated");
   }
 }
 
@@ -110,29 +115,52 @@ bool is_inst_tail_call(
     FunctionPtr function,
     Builder& builder
 ) {
-  // Refactor: judge tail call based 
+  auto call_inst = std::get_if<instruction::Call>(&inst->kind);
+  if (call_inst == nullptr ||
+      function.get() != call_inst->callee ||
+      function->parameter_id_list.size() >= 30)
+    return false;
+  return is_inst_returning(
+    inst->next, inst->parent_block_id, call_inst->maybe_dst_id, builder
+  );
+}
+
+bool is_inst_returning(
+    InstructionPtr inst,
+    BasicBlockID from_block_id,
+    std::optional<OperandID> maybe_value_id,
+    Builder& builder
+) {
   return std::visit(overloaded {
-    [&](instruction::Call& call_inst) {
-      return is_inst_tail_call(inst->next, function, builder) &&
-        function->name == call_inst.function_name &&
-        function->parameter_id_list.size() < 30;
-    },
     [&](instruction::Br& br_inst) {
       auto next_block = builder.context.basic_block_table[br_inst.block_id];
-      return is_inst_tail_call(next_block->head_instruction->next, function, builder);
+      return is_inst_returning(next_block->head_instruction->next,
+        inst->parent_block_id, maybe_value_id, builder);
     },
     [&](instruction::CondBr& cond_br_inst) {
       auto then_block = builder.context.basic_block_table[cond_br_inst.then_block_id];
       auto else_block = builder.context.basic_block_table[cond_br_inst.else_block_id];
-      return is_inst_tail_call(then_block->head_instruction->next, function, builder) &&
-           is_inst_tail_call(else_block->head_instruction->next, function, builder);
+      return is_inst_returning(then_block->head_instruction->next,
+          inst->parent_block_id, maybe_value_id, builder) &&
+        is_inst_returning(else_block->head_instruction->next,
+          inst->parent_block_id, maybe_value_id, builder);
     },
     [&](instruction::Ret& ret_inst) {
-      return true;
+      // The returned value must be the result of the call
+      return !ret_inst.maybe_value_id.has_value() ||
+        ret_inst.maybe_value_id == maybe_value_id;
     },
     [&](instruction::Phi& phi_inst) {
-      return is_inst_tail_call(inst->next, function, builder);
+      // Follow the result of the call through the phi
+      auto next_value_id = maybe_value_id;
+      for (auto [incoming_id, block_id] : phi_inst.incoming_list) {
+        if (block_id == from_block_id && maybe_value_id.has_value() &&
+            incoming_id == maybe_value_id.value())
+          next_value_id = phi_inst.dst_id;
+      }
+      return is_inst_returning(inst->next, from_block_id, next_value_id, builder);
     },
+    // Anything else, including another call, runs after the call
     [&](auto& inst) {
       return false;
     }
@@ -30,6 +30,16 @@ bool is_inst_tail_call(
     Builder& builder
 );
 
+// Check if the function returns right after the instruction, with the value
+// `maybe_value_id` if it returns a value. `from_block_id` is the block the
+// control comes from, to follow the value through the phis.
+bool is_inst_returning(
+    InstructionPtr inst,
+    BasicBlockID from_block_id,
+    std::optional<OperandID> maybe_value_id,
+    Builder& builder
+);
+
 }   // namespace ir
 
 }  // namespace syc
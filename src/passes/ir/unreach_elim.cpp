@@ -1,24 +1,45 @@
 #include "passes/ir/unreach_elim.h"
+#include "statistics.h"
 
 namespace syc {
 
 namespace ir {
 
-void unreach_elim(Builder& builder) {
+void unreach_elim(Builder& builder, AnalysisManager& analysis_manager) {
   for (auto& it : builder.context.function_table) {
     auto function = it.second;
     if (function->is_declare)
       continue;
-    elim_const_branch(function, builder);
-    remove_unreach_block(function, builder);
+    builder.switch_function(function->name);
+    unreach_elim_function(function, builder, analysis_manager);
   }
 }
 
-void elim_const_branch(FunctionPtr function, Builder& builder) {
+void unreach_elim_function(
+  FunctionPtr function,
+  Builder& builder,
+  AnalysisManager& analysis_manager
+) {
+  auto cfa_ctx = analysis_manager.find_control_flow_analysis(function);
+  auto dom_tree = cfa_ctx != nullptr ? &cfa_ctx->dom_tree : nullptr;
+
+  bool changed = elim_const_branch(function, builder, dom_tree);
+  changed = remove_unreach_block(function, builder, dom_tree) || changed;
+  if (changed) {
+    analysis_manager.invalidate_loops(function);
+  }
+}
+
+bool elim_const_branch(
+  FunctionPtr function,
+  Builder& builder,
+  DominatorTree* dom_tree
+) {
+  bool changed = false;
   for (auto now_bb =
          function->head_basic_block->next;  // skip dummy basic block
        now_bb != function->tail_basic_block; now_bb = now_bb->next) {
-    InstructionPtr tail_inst = now_bb->tail_instruction->prev.lock();
+    InstructionPtr tail_inst = now_bb->tail_instruction->prev;
 
     if (auto cond_br_inst = std::get_if<instruction::CondBr>(&tail_inst->kind)) {
       auto cond_op_id = cond_br_inst->cond_id;
@@ -29,6 +50,9 @@ void elim_const_branch(FunctionPtr function, Builder& builder) {
         auto target_block_id = (*const_op)->get_bool_value()
                                  ? cond_br_inst->then_block_id
                                  : cond_br_inst->else_block_id;
+        auto dropped_block_id = (*const_op)->get_bool_value()
+                                  ? cond_br_inst->else_block_id
+                                  : cond_br_inst->then_block_id;
         builder.set_curr_basic_block(
           builder.context.basic_block_table[target_block_id]
         );
@@ -36,18 +60,34 @@ void elim_const_branch(FunctionPtr function, Builder& builder) {
         tail_inst->remove(builder.context);
         builder.set_curr_basic_block(now_bb);
         builder.append_instruction(br_inst);
+        if (dom_tree != nullptr && dropped_block_id != target_block_id) {
+          dom_tree->delete_edge(now_bb->id, dropped_block_id);
+        }
+        bump_counter("ir.unreach_elim", "constant branches folded");
+        changed = true;
       }
     }
   }
+  return changed;
 }
 
-void remove_unreach_block(FunctionPtr function, Builder& builder) {
+bool remove_unreach_block(
+  FunctionPtr function,
+  Builder& builder,
+  DominatorTree* dom_tree
+) {
+  bool changed = false;
   auto reached_blocks = get_reachable_blocks(function, builder);
   for (auto now_bb =
          function->head_basic_block->next;  // skip dummy basic block
        now_bb != function->tail_basic_block; now_bb = now_bb->next) {
     if (reached_blocks.count(now_bb->id) == 0) {
+      if (dom_tree != nullptr) {
+        dom_tree->remove_block(now_bb->id);
+      }
       now_bb->remove(builder.context);
+      bump_counter("ir.unreach_elim", "unreachable blocks removed");
+      changed = true;
     }
   }
 
@@ -71,12 +111,13 @@ void remove_unreach_block(FunctionPtr function, Builder& builder) {
       }
     }
   }
+  return changed;
 }
 
 std::set<BasicBlockID>
 get_reachable_blocks(FunctionPtr function, Builder& builder) {
   // std::cout << function->name << std::endl;
-  auto basic_block_table = builder.context.basic_block_table;
+  auto& basic_block_table = builder.context.basic_block_table;
   std::set<BasicBlockID> reached_blocks;
   std::stack<BasicBlockID> block_stack;
   BasicBlockID visiting_block;
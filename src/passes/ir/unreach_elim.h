@@ -7,26 +7,40 @@
 #include "ir/basic_block.h"
 #include "ir/operand.h"
 #include "common.h"
+#include "passes/ir/pass_manager.h"
 
 namespace syc {
 
 namespace ir {
 
 void unreach_elim(
-    Builder& builder
+    Builder& builder,
+    AnalysisManager& analysis_manager
+);
+
+void unreach_elim_function(
+    FunctionPtr function,
+    Builder& builder,
+    AnalysisManager& analysis_manager
 );
 
 /// Traverse branch instructions with constant condition 
 /// and transform them into uncond branch instructions
-void elim_const_branch(
+/// Return if any branch is transformed.
+/// The dominator tree is updated if given.
+bool elim_const_branch(
     FunctionPtr function, 
-    Builder& builder
+    Builder& builder,
+    DominatorTree* dom_tree = nullptr
 );
 
 /// Remove unreachable basic blocks
-void remove_unreach_block(
+/// Return if any block is removed.
+/// The dominator tree is updated if given.
+bool remove_unreach_block(
     FunctionPtr function, 
-    Builder& builder
+    Builder& builder,
+    DominatorTree* dom_tree = nullptr
 );
 
 /// Traverse the function and return all reachable blocks
@@ -0,0 +1,185 @@
+#ifndef SYC_SMALL_LIST_H_
+#define SYC_SMALL_LIST_H_
+
+#include "common.h"
+
+namespace syc {
+
+/// List with inline storage for the first few elements.
+///
+/// Up to `InlineCapacity` elements are stored in the list itself and only
+/// longer lists spill to the heap. Most operand lists of the IR are short
+/// (e.g. the two incoming values of a phi or the indices of a GEP), so neither
+/// building an instruction nor copying its kind allocates.
+///
+/// The inline storage shares its bytes with the pointer to the heap storage,
+/// so with an inline capacity of two IDs the list is as large as a
+/// `std::vector`. Elements must be trivially destructible.
+template <typename T, size_t InlineCapacity>
+struct SmallList {
+  static_assert(std::is_trivially_destructible_v<T>);
+  static_assert(InlineCapacity > 0);
+
+  /// Number of elements.
+  uint32_t length = 0;
+  /// Number of elements the current storage can hold, the storage is inline
+  /// iff this is `InlineCapacity`.
+  uint32_t capacity = InlineCapacity;
+
+  union {
+    alignas(T) unsigned char inline_storage[sizeof(T) * InlineCapacity];
+    T* heap_storage;
+  };
+
+  SmallList() {}
+
+  SmallList(std::initializer_list<T> init) {
+    append(init.begin(), init.end());
+  }
+
+  SmallList(const std::vector<T>& other) {
+    append(other.begin(), other.end());
+  }
+
+  template <typename Iterator>
+  SmallList(Iterator first, Iterator last) {
+    append(first, last);
+  }
+
+  SmallList(const SmallList& other) { append(other.begin(), other.end()); }
+
+  SmallList(SmallList&& other) noexcept { take(other); }
+
+  SmallList& operator=(const SmallList& other) {
+    if (this != &other) {
+      clear();
+      append(other.begin(), other.end());
+    }
+    return *this;
+  }
+
+  SmallList& operator=(SmallList&& other) noexcept {
+    if (this != &other) {
+      release();
+      take(other);
+    }
+    return *this;
+  }
+
+  ~SmallList() { release(); }
+
+  bool is_inline() const { return capacity == InlineCapacity; }
+
+  T* data() {
+    return is_inline() ? reinterpret_cast<T*>(inline_storage) : heap_storage;
+  }
+  const T* data() const {
+    return is_inline() ? reinterpret_cast<const T*>(inline_storage)
+                       : heap_storage;
+  }
+
+  T* begin() { return data(); }
+  T* end() { return data() + length; }
+  const T* begin() const { return data(); }
+  const T* end() const { return data() + length; }
+
+  size_t size() const { return length; }
+
+  bool empty() const { return length == 0; }
+
+  T& operator[](size_t index) { return data()[index]; }
+  const T& operator[](size_t index) const { return data()[index]; }
+
+  T& front() { return data()[0]; }
+  const T& front() const { return data()[0]; }
+
+  T& back() { return data()[length - 1]; }
+  const T& back() const { return data()[length - 1]; }
+
+  /// Grow the storage to hold at least `new_capacity` elements.
+  void reserve(size_t new_capacity) {
+    if (new_capacity <= capacity) {
+      return;
+    }
+    new_capacity = std::max<size_t>(new_capacity, capacity * 2);
+    auto new_storage =
+      static_cast<T*>(::operator new(sizeof(T) * new_capacity));
+    std::uninitialized_move(begin(), end(), new_storage);
+    if (!is_inline()) {
+      ::operator delete(heap_storage);
+    }
+    heap_storage = new_storage;
+    capacity = new_capacity;
+  }
+
+  void push_back(const T& value) { emplace_back(value); }
+
+  template <typename... Args>
+  T& emplace_back(Args&&... args) {
+    if (length == capacity) {
+      reserve(length + 1);
+    }
+    auto element = new (data() + length) T(std::forward<Args>(args)...);
+    length++;
+    return *element;
+  }
+
+  void pop_back() { length--; }
+
+  void clear() { length = 0; }
+
+  /// Erase the elements in `[first, last)` and shift the rest to the front.
+  T* erase(T* first, T* last) {
+    auto new_end = std::move(last, end(), first);
+    length = new_end - begin();
+    return first;
+  }
+
+  T* erase(T* position) { return erase(position, position + 1); }
+
+  /// Copy the elements to a `std::vector`.
+  std::vector<T> to_vector() const { return std::vector<T>(begin(), end()); }
+
+  bool operator==(const SmallList& other) const {
+    return std::equal(begin(), end(), other.begin(), other.end());
+  }
+  bool operator!=(const SmallList& other) const { return !(*this == other); }
+
+  /// Append the elements of a range.
+  template <typename Iterator>
+  void append(Iterator first, Iterator last) {
+    reserve(length + std::distance(first, last));
+    for (; first != last; ++first) {
+      emplace_back(*first);
+    }
+  }
+
+  /// Take the storage of another list and leave it empty.
+  void take(SmallList& other) {
+    if (other.is_inline()) {
+      length = 0;
+      capacity = InlineCapacity;
+      std::uninitialized_move(other.begin(), other.end(), data());
+      length = other.length;
+    } else {
+      heap_storage = other.heap_storage;
+      length = other.length;
+      capacity = other.capacity;
+    }
+    other.length = 0;
+    other.capacity = InlineCapacity;
+  }
+
+  /// Free the heap storage, if any, and go back to the inline storage.
+  void release() {
+    if (!is_inline()) {
+      ::operator delete(heap_storage);
+    }
+    length = 0;
+    capacity = InlineCapacity;
+  }
+};
+
+}  // namespace syc
+
+#endif
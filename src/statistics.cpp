@@ -0,0 +1,249 @@
+#include "statistics.h"
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <fstream>
+
+namespace syc {
+
+MemoryUsage read_memory_usage() {
+  MemoryUsage usage = {0, 0};
+
+  // The second field is the number of resident pages.
+  std::ifstream statm("/proc/self/statm");
+  size_t size_pages = 0;
+  size_t resident_pages = 0;
+  if (statm >> size_pages >> resident_pages) {
+    usage.rss_bytes = resident_pages * sysconf(_SC_PAGESIZE);
+  }
+
+  // `ru_maxrss` is in KiB on Linux.
+  struct rusage rusage;
+  if (getrusage(RUSAGE_SELF, &rusage) == 0) {
+    usage.peak_rss_bytes = static_cast<size_t>(rusage.ru_maxrss) * 1024;
+  }
+  // The two are sampled differently, keep the peak no less than the current.
+  usage.peak_rss_bytes = std::max(usage.peak_rss_bytes, usage.rss_bytes);
+
+  return usage;
+}
+
+/// Format bytes in MiB.
+double to_mib(size_t bytes) {
+  return static_cast<double>(bytes) / (1024 * 1024);
+}
+
+std::string json_str(const std::string& str) {
+  std::string result = "\"";
+  for (auto c : str) {
+    if (c == '"' || c == '\\') {
+      result += '\\';
+    }
+    result += c;
+  }
+  result += "\"";
+  return result;
+}
+
+void Statistics::add_counter(
+  const std::string& pass_name,
+  const std::string& counter_name,
+  size_t delta
+) {
+  std::lock_guard<std::mutex> lock(counter_mutex);
+  counter_map[{pass_name, counter_name}] += delta;
+}
+
+void Statistics::add_memory_snapshot(
+  const std::string& phase,
+  CountList count_list
+) {
+  memory_snapshot_list.push_back(
+    MemorySnapshot{phase, read_memory_usage(), std::move(count_list)}
+  );
+}
+
+std::string Statistics::pass_table() const {
+  std::stringstream ss;
+
+  double total_seconds = 0;
+  for (const auto& record : pass_record_list) {
+    total_seconds += record.seconds;
+  }
+
+  ss << "===== Pass execution timing report =====" << std::endl;
+  ss << std::left << std::setw(6) << "#" << std::setw(32) << "pass"
+     << std::right << std::setw(12) << "time (s)" << std::setw(8) << "%"
+     << std::setw(12) << "instr" << std::setw(12) << "delta" << std::setw(12)
+     << "rss (MiB)" << std::endl;
+
+  auto percent = [&](double seconds) {
+    return total_seconds > 0 ? seconds / total_seconds * 100 : 0;
+  };
+
+  size_t index = 0;
+  for (const auto& record : pass_record_list) {
+    auto delta = static_cast<long long>(record.instruction_count_after) -
+                 static_cast<long long>(record.instruction_count_before);
+    ss << std::left << std::setw(6) << index++ << std::setw(32) << record.name
+       << std::right << std::fixed << std::setprecision(4) << std::setw(12)
+       << record.seconds << std::setprecision(1) << std::setw(8)
+       << percent(record.seconds) << std::setw(12)
+       << record.instruction_count_after << std::setw(12) << std::showpos
+       << delta << std::noshowpos << std::setw(12)
+       << to_mib(record.memory_after.rss_bytes) << std::endl;
+  }
+
+  // Summary by pass name, the most expensive first.
+  std::map<std::string, std::pair<double, size_t>> summary_map;
+  for (const auto& record : pass_record_list) {
+    summary_map[record.name].first += record.seconds;
+    summary_map[record.name].second++;
+  }
+  std::vector<std::pair<std::string, std::pair<double, size_t>>> summary_list(
+    summary_map.begin(), summary_map.end()
+  );
+  std::stable_sort(
+    summary_list.begin(), summary_list.end(),
+    [](const auto& lhs, const auto& rhs) {
+      return lhs.second.first > rhs.second.first;
+    }
+  );
+
+  ss << std::endl;
+  ss << std::left << std::setw(38) << "pass" << std::right << std::setw(12)
+     << "time (s)" << std::setw(8) << "%" << std::setw(8) << "runs"
+     << std::endl;
+  for (const auto& [name, summary] : summary_list) {
+    ss << std::left << std::setw(38) << name << std::right << std::fixed
+       << std::setprecision(4) << std::setw(12) << summary.first
+       << std::setprecision(1) << std::setw(8) << percent(summary.first)
+       << std::setw(8) << summary.second << std::endl;
+  }
+  ss << std::left << std::setw(38) << "total" << std::right << std::fixed
+     << std::setprecision(4) << std::setw(12) << total_seconds << std::endl;
+
+  return ss.str();
+}
+
+std::string Statistics::counter_table() const {
+  std::stringstream ss;
+  ss << "===== Statistics =====" << std::endl;
+  for (const auto& [key, value] : counter_map) {
+    ss << std::right << std::setw(12) << value << " " << std::left
+       << std::setw(28) << key.first << " - " << key.second << std::endl;
+  }
+  return ss.str();
+}
+
+std::string Statistics::memory_table() const {
+  std::stringstream ss;
+  ss << "===== Memory report =====" << std::endl;
+  for (const auto& snapshot : memory_snapshot_list) {
+    ss << "after " << snapshot.phase << ": rss " << std::fixed
+       << std::setprecision(1) << to_mib(snapshot.memory.rss_bytes)
+       << " MiB, peak " << to_mib(snapshot.memory.peak_rss_bytes) << " MiB"
+       << std::endl;
+    for (const auto& [name, value] : snapshot.count_list) {
+      ss << std::right << std::setw(12) << value << " " << std::left << name
+         << std::endl;
+    }
+    ss << std::endl;
+  }
+
+  // Growth of the peak by pass name, the largest first. The peak only grows,
+  // so this attributes the peak to the passes that raised it.
+  std::map<std::string, size_t> growth_map;
+  size_t last_peak = memory_snapshot_list.empty()
+                     ? 0
+                     : memory_snapshot_list.front().memory.peak_rss_bytes;
+  for (const auto& record : pass_record_list) {
+    auto peak = record.memory_after.peak_rss_bytes;
+    if (peak > last_peak) {
+      growth_map[record.name] += peak - last_peak;
+      last_peak = peak;
+    }
+  }
+  std::vector<std::pair<std::string, size_t>> growth_list(
+    growth_map.begin(), growth_map.end()
+  );
+  std::stable_sort(
+    growth_list.begin(), growth_list.end(),
+    [](const auto& lhs, const auto& rhs) { return lhs.second > rhs.second; }
+  );
+
+  ss << std::left << std::setw(38) << "pass" << std::right << std::setw(16)
+     << "peak +(MiB)" << std::endl;
+  for (const auto& [name, growth] : growth_list) {
+    ss << std::left << std::setw(38) << name << std::right << std::fixed
+       << std::setprecision(1) << std::setw(16) << to_mib(growth) << std::endl;
+  }
+
+  return ss.str();
+}
+
+std::string Statistics::to_json() const {
+  std::stringstream ss;
+  ss << "{" << std::endl;
+  ss << "  \"passes\": [";
+  for (size_t i = 0; i < pass_record_list.size(); i++) {
+    const auto& record = pass_record_list[i];
+    ss << (i == 0 ? "" : ",") << std::endl;
+    ss << "    {\"name\": " << json_str(record.name)
+       << ", \"seconds\": " << std::fixed << std::setprecision(6)
+       << record.seconds
+       << ", \"instructions_before\": " << record.instruction_count_before
+       << ", \"instructions_after\": " << record.instruction_count_after
+       << ", \"rss_bytes\": " << record.memory_after.rss_bytes
+       << ", \"peak_rss_bytes\": " << record.memory_after.peak_rss_bytes
+       << "}";
+  }
+  ss << std::endl << "  ]," << std::endl;
+  ss << "  \"counters\": [";
+  bool first = true;
+  for (const auto& [key, value] : counter_map) {
+    ss << (first ? "" : ",") << std::endl;
+    ss << "    {\"pass\": " << json_str(key.first)
+       << ", \"name\": " << json_str(key.second) << ", \"value\": " << value
+       << "}";
+    first = false;
+  }
+  ss << std::endl << "  ]," << std::endl;
+  ss << "  \"memory\": [";
+  for (size_t i = 0; i < memory_snapshot_list.size(); i++) {
+    const auto& snapshot = memory_snapshot_list[i];
+    ss << (i == 0 ? "" : ",") << std::endl;
+    ss << "    {\"phase\": " << json_str(snapshot.phase)
+       << ", \"rss_bytes\": " << snapshot.memory.rss_bytes
+       << ", \"peak_rss_bytes\": " << snapshot.memory.peak_rss_bytes
+       << ", \"counts\": {";
+    for (size_t j = 0; j < snapshot.count_list.size(); j++) {
+      const auto& [name, value] = snapshot.count_list[j];
+      ss << (j == 0 ? "" : ", ") << json_str(name) << ": " << value;
+    }
+    ss << "}}";
+  }
+  ss << std::endl << "  ]" << std::endl;
+  ss << "}" << std::endl;
+  return ss.str();
+}
+
+Statistics& get_statistics() {
+  static Statistics statistics;
+  return statistics;
+}
+
+void bump_counter(
+  const std::string& pass_name,
+  const std::string& counter_name,
+  size_t delta
+) {
+  auto& statistics = get_statistics();
+  if (!statistics.enabled) {
+    return;
+  }
+  statistics.add_counter(pass_name, counter_name, delta);
+}
+
+}  // namespace syc
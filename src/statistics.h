@@ -0,0 +1,130 @@
+#ifndef SYC_STATISTICS_H_
+#define SYC_STATISTICS_H_
+
+#include <chrono>
+#include <mutex>
+
+#include "common.h"
+
+namespace syc {
+
+/// Memory used by the process.
+struct MemoryUsage {
+  /// Resident set size.
+  size_t rss_bytes;
+  /// Largest resident set size so far.
+  size_t peak_rss_bytes;
+};
+
+/// Read the memory usage of the process, zero where it cannot be read.
+MemoryUsage read_memory_usage();
+
+/// Record of one pass invocation.
+struct PassRecord {
+  /// Name of the pass, prefixed by the level, e.g. `ir.gvn`.
+  std::string name;
+  /// Wall time of the invocation.
+  double seconds;
+  /// Number of instructions before and after the invocation.
+  size_t instruction_count_before;
+  size_t instruction_count_after;
+  /// Memory usage after the invocation.
+  MemoryUsage memory_after;
+};
+
+/// Sizes of the data structures and the memory usage after a phase.
+struct MemorySnapshot {
+  /// Phase the snapshot is taken after, e.g. `frontend`.
+  std::string phase;
+  MemoryUsage memory;
+  /// Sizes of the tables and numbers of live nodes by kind.
+  CountList count_list;
+};
+
+/// Compile-time statistics.
+///
+/// Pass managers record the time, the instruction counts and the memory usage
+/// of each pass invocation, and passes bump named counters of what they have
+/// done. After each phase the sizes of its data structures are recorded as a
+/// memory snapshot. Nothing is recorded unless the statistics are enabled by
+/// `-time-passes`, `-stats` or `-mem-report`, so the counters cost a branch
+/// in a normal compilation.
+struct Statistics {
+  /// If recording is enabled.
+  bool enabled = false;
+
+  /// Pass invocations in order.
+  std::vector<PassRecord> pass_record_list;
+  /// Counters keyed by the pass name and the counter name.
+  std::map<std::pair<std::string, std::string>, size_t> counter_map;
+  /// Memory snapshots in order.
+  std::vector<MemorySnapshot> memory_snapshot_list;
+
+  /// Counters may be bumped by passes running on multiple threads.
+  std::mutex counter_mutex;
+
+  /// Add to a counter.
+  void add_counter(
+    const std::string& pass_name,
+    const std::string& counter_name,
+    size_t delta
+  );
+
+  /// Record the sizes of the data structures of a phase and the current
+  /// memory usage.
+  void add_memory_snapshot(const std::string& phase, CountList count_list);
+
+  /// Format the pass invocations and a summary by pass name as tables.
+  std::string pass_table() const;
+
+  /// Format the counters as a table.
+  std::string counter_table() const;
+
+  /// Format the memory snapshots and the peak of each pass as tables.
+  std::string memory_table() const;
+
+  /// Format everything as a JSON object.
+  std::string to_json() const;
+};
+
+/// Quote and escape a string for JSON.
+std::string json_str(const std::string& str);
+
+/// Statistics of the current compilation.
+Statistics& get_statistics();
+
+/// Bump a named counter of a pass if statistics are enabled.
+void bump_counter(
+  const std::string& pass_name,
+  const std::string& counter_name,
+  size_t delta = 1
+);
+
+/// Time a pass invocation and record it if statistics are enabled.
+/// `count_instructions` is called before and after the pass.
+template <typename Pass, typename Counter>
+void time_pass(
+  const std::string& name,
+  Pass&& pass,
+  Counter&& count_instructions
+) {
+  auto& statistics = get_statistics();
+  if (!statistics.enabled) {
+    pass();
+    return;
+  }
+
+  auto instruction_count_before = count_instructions();
+  auto start = std::chrono::steady_clock::now();
+  pass();
+  auto end = std::chrono::steady_clock::now();
+  auto instruction_count_after = count_instructions();
+
+  statistics.pass_record_list.push_back(PassRecord{
+    name, std::chrono::duration<double>(end - start).count(),
+    instruction_count_before, instruction_count_after, read_memory_usage()});
+}
+
+}  // namespace syc
+
+#endif
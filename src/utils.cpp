@@ -22,6 +22,14 @@ bool starts_with(const std::string& str, const std::string& prefix) {
   return str.compare(0, prefix.length(), prefix) == 0;
 }
 
+std::optional<size_t> parse_size(const std::string& str) {
+  if (str.empty() || str.size() > 9 ||
+      str.find_first_not_of("0123456789") != std::string::npos) {
+    return std::nullopt;
+  }
+  return std::stoul(str);
+}
+
 Options parse_args(int argc, char** argv) {
   Options options;
   options.optimization_level = 0;
@@ -29,6 +37,19 @@ Options parse_args(int argc, char** argv) {
   options.token_file = std::nullopt;
   options.ast_file = std::nullopt;
   options.ir_file = std::nullopt;
+  options.stats_file = std::nullopt;
+  options.inline_budget = std::nullopt;
+  options.unroll_budget = std::nullopt;
+  options.opt_time_budget_ms = std::nullopt;
+  options.thread_count = 1;
+  options.cache_dir = std::nullopt;
+  options.batch = false;
+
+  // Options that never take a value, so `-stats input.sy` works.
+  std::set<std::string> flag_set = {
+    "S",          "O0",          "O1",    "O2",         "O3",
+    "aggressive", "time-passes", "stats", "mem-report", "cache-report",
+    "batch"};
 
   std::map<std::string, std::string> arguments;
   std::vector<std::string> positional_arguments;
@@ -38,7 +59,7 @@ Options parse_args(int argc, char** argv) {
       std::string key = arg.substr(1);
       if (key[0] == '-')
         key = key.substr(1);
-      if (i + 1 < argc && argv[i + 1][0] != '-') {
+      if (!flag_set.count(key) && i + 1 < argc && argv[i + 1][0] != '-') {
         arguments[key] = argv[++i];
       } else {
         arguments[key] = "";
@@ -48,8 +69,22 @@ Options parse_args(int argc, char** argv) {
     }
   }
 
+  options.batch = arguments.find("batch") != arguments.end();
+
   // input file
-  if (positional_arguments.size() > 1) {
+  if (options.batch) {
+    if (positional_arguments.empty()) {
+      std::cerr << "error: no input file specified" << std::endl;
+      exit(1);
+    }
+    for (const auto& input : positional_arguments) {
+      if (!std::filesystem::exists(input)) {
+        std::cerr << "error: input file not exists: " << input << std::endl;
+        exit(1);
+      }
+    }
+    options.batch_input_list = positional_arguments;
+  } else if (positional_arguments.size() > 1) {
     std::cerr << "error: too many input files" << std::endl;
     exit(1);
   } else if (positional_arguments.size() < 1 || positional_arguments[0] == "") {
@@ -58,7 +93,7 @@ Options parse_args(int argc, char** argv) {
   } else {
     options.input_filename = positional_arguments[0];
   }
-  if (!std::filesystem::exists(options.input_filename)) {
+  if (!options.batch && !std::filesystem::exists(options.input_filename)) {
     std::cerr << "error: input file not exists" << std::endl;
     exit(1);
   }
@@ -70,6 +105,10 @@ Options parse_args(int argc, char** argv) {
       std::cerr << "error: no output file specified" << std::endl;
       exit(1);
     }
+  } else if (options.batch) {
+    std::cerr << "error: -batch expects an output directory, -o DIR"
+              << std::endl;
+    exit(1);
   } else {
     options.output_file = "a.asm";
   }
@@ -126,6 +165,69 @@ Options parse_args(int argc, char** argv) {
   if (arguments.find("S") != arguments.end()) {
     // do nothing
   }
+
+  // Statistics
+  options.time_passes = arguments.find("time-passes") != arguments.end();
+  options.stats = arguments.find("stats") != arguments.end();
+  options.mem_report = arguments.find("mem-report") != arguments.end();
+  if (arguments.find("stats-json") != arguments.end()) {
+    options.stats_file = arguments.find("stats-json")->second;
+    if (options.stats_file == "") {
+      std::cerr << "error: no stats file specified" << std::endl;
+      exit(1);
+    }
+  }
+
+  // Budgets of inlining and unrolling
+  for (auto [key, budget] :
+       {std::make_pair("inline-budget", &options.inline_budget),
+        std::make_pair("unroll-budget", &options.unroll_budget),
+        std::make_pair("opt-time-budget", &options.opt_time_budget_ms)}) {
+    if (arguments.find(key) != arguments.end()) {
+      *budget = parse_size(arguments.find(key)->second);
+      if (!budget->has_value()) {
+        std::cerr << "error: -" << key << " expects a number" << std::endl;
+        exit(1);
+      }
+    }
+  }
+
+  // Threads
+  if (arguments.find("j") != arguments.end()) {
+    auto thread_count_str = arguments.find("j")->second;
+    if (thread_count_str.empty() || thread_count_str.size() > 4 ||
+        thread_count_str.find_first_not_of("0123456789") != std::string::npos ||
+        std::stoul(thread_count_str) == 0) {
+      std::cerr << "error: -j expects a positive number of threads"
+                << std::endl;
+      exit(1);
+    }
+    options.thread_count = std::stoul(thread_count_str);
+  }
+
+  // Compile cache
+  if (arguments.find("cache-dir") != arguments.end()) {
+    options.cache_dir = arguments.find("cache-dir")->second;
+    if (options.cache_dir == "") {
+      std::cerr << "error: no cache directory specified" << std::endl;
+      exit(1);
+    }
+  }
+  options.cache_report = arguments.find("cache-report") != arguments.end();
+
+  // The statistics are global to the process and the other outputs are single
+  // files, so they cannot be told apart in batch mode.
+  if (options.batch) {
+    for (const auto& key :
+         {"emit-tokens", "emit-ast", "emit-ir", "time-passes", "stats",
+          "mem-report", "stats-json"}) {
+      if (arguments.find(key) != arguments.end()) {
+        std::cerr << "error: -" << key << " is not supported with -batch"
+                  << std::endl;
+        exit(1);
+      }
+    }
+  }
   return options;
 }
 
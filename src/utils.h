@@ -21,8 +21,39 @@ struct Options {
   std::optional<std::string> token_file;
   std::optional<std::string> ast_file;
   std::optional<std::string> ir_file;
+  /// Print the time and instruction counts of each pass.
+  bool time_passes;
+  /// Print the counters bumped by the passes.
+  bool stats;
+  /// Print the memory usage and the sizes of the data structures per phase.
+  bool mem_report;
+  /// Write the pass records and counters as JSON.
+  std::optional<std::string> stats_file;
+  /// Most instructions added to the module by inlining, `-inline-budget N`.
+  std::optional<size_t> inline_budget;
+  /// Most instructions added to each function by unrolling, `-unroll-budget
+  /// N`.
+  std::optional<size_t> unroll_budget;
+  /// Milliseconds after which inlining and the unrolling of a function stop,
+  /// `-opt-time-budget MS`. The output then depends on the speed of the host.
+  std::optional<size_t> opt_time_budget_ms;
+  /// Number of threads to optimize the functions on, `-j N`.
+  size_t thread_count;
+  /// Directory of the compile cache, `-cache-dir DIR`.
+  std::optional<std::string> cache_dir;
+  /// Print the hits and the time saved by the compile cache.
+  bool cache_report;
+  /// Compile many files in one process, `-batch`. The output file is then the
+  /// output directory and `-j N` is the number of files compiled at once.
+  bool batch;
+  /// The `.sy` files, directories of `.sy` files and list files to compile in
+  /// batch mode.
+  std::vector<std::string> batch_input_list;
 };
 
+/// Parse a non-negative decimal number of at most 9 digits.
+std::optional<size_t> parse_size(const std::string& str);
+
 Options parse_args(int argc, char** argv);
 
 }  // namespace syc